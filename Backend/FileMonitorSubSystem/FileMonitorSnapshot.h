@@ -0,0 +1,27 @@
+#ifndef FILEMONITORSNAPSHOT_H
+#define FILEMONITORSNAPSHOT_H
+
+#include "FileSystemEventDb.h"
+
+#include <QList>
+#include <QString>
+
+// Immutable copy of the monitored tree, built on the monitor thread and shown by the gui.
+struct FileMonitorSnapshot
+{
+    struct Entry
+    {
+        QString path;
+        QString parentPath; // Empty for top level folders
+        bool isFolder = false;
+        FileSystemEventDb::ItemStatus status = FileSystemEventDb::ItemStatus::Invalid;
+        bool isContainEvent = false; // Item or any item below it has an event
+    };
+
+    // Parents always come before their children.
+    // Children of a folder are listed together; eventful files first, then sub folders, both sorted.
+    QList<Entry> entryList;
+    bool isContainAnyEvent = false;
+};
+
+#endif // FILEMONITORSNAPSHOT_H
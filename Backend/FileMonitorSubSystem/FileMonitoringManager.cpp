@@ -1,35 +1,48 @@
 #include "FileMonitoringManager.h"
 
 #include "FileStorageSubSystem/FileStorageManager.h"
-#include "Utility/DatabaseRegistry.h"
-#include "Utility/JsonDtoFormat.h"
+#include "Utility/Logger.h"
 
 #include <QDir>
-#include <QDebug>
 #include <QFileInfo>
 #include <QDirIterator>
+#include <QElapsedTimer>
 #include <QRandomGenerator>
 
 FileMonitoringManager::FileMonitoringManager(QObject *parent)
-    : QObject{parent}
+    : QObject{parent}, watchPlanner(&fileWatcher, &fileSystemEventListener)
 {
-    QObject::connect(&fileSystemEventListener, &FileSystemEventListener::signalAddEventDetected,
-                     this, &FileMonitoringManager::slotOnAddEventDetected);
+    database = nullptr;
 
-    QObject::connect(&fileSystemEventListener, &FileSystemEventListener::signalDeleteEventDetected,
-                     this, &FileMonitoringManager::slotOnDeleteEventDetected);
+    eventCoalescer = new FileSystemEventCoalescer(this);
+    fileSystemEventListener.setEventCoalescer(eventCoalescer);
 
-    QObject::connect(&fileSystemEventListener, &FileSystemEventListener::signalModificationEventDetected,
-                     this, &FileMonitoringManager::slotOnModificationEventDetected);
+    snapshotTimer = new QTimer(this);
+    snapshotTimer->setSingleShot(true);
+    snapshotTimer->setInterval(SnapshotPublishIntervalMs);
 
-    QObject::connect(&fileSystemEventListener, &FileSystemEventListener::signalMoveEventDetected,
-                     this, &FileMonitoringManager::slotOnMoveEventDetected);
+    QObject::connect(eventCoalescer, &FileSystemEventCoalescer::signalEventBatchReady,
+                     this, &FileMonitoringManager::slotOnEventBatchReady);
+
+    QObject::connect(snapshotTimer, &QTimer::timeout,
+                     this, &FileMonitoringManager::publishSnapshot);
+
+    // Folders beyond the watch budget are polled, see FileSystemWatchPlanner.
+    pollTimer = new QTimer(this);
+    pollTimer->setInterval(FileSystemWatchPlanner::PollIntervalMs);
+
+    QObject::connect(pollTimer, &QTimer::timeout, this, [this] {
+        watchPlanner.pollFolders();
+    });
 
     fileWatcher.watch();
 }
 
 FileMonitoringManager::~FileMonitoringManager()
 {
+    eventCoalescer->flush(); // Pending events decide which files are still unchanged
+    saveMonitorState();
+
     delete database;
 }
 
@@ -45,11 +58,37 @@ void FileMonitoringManager::setPredictionList(const QStringList &newPredictionLi
 
 void FileMonitoringManager::start()
 {
-    database = new FileSystemEventDb(DatabaseRegistry::fileSystemEventDatabase());
+    QElapsedTimer startupTimer;
+    QElapsedTimer phaseTimer;
+    startupTimer.start();
+    phaseTimer.start();
+
+    database = new FileSystemEventDb();
 
     auto fsm = FileStorageManager::instance();
 
-    for(const QString &item : getPredictionList())
+    QHash<QString, MonitorStateStore::PathState> savedStateTable = MonitorStateStore().load();
+    QHash<QString, FileVersionRecord> latestVersionTable;
+    qlonglong unchangedFileCount = 0;
+
+    if(!savedStateTable.isEmpty())
+    {
+        QHash<QString, FileVersionRecord> queryResult = fsm->getLatestVersionsOfActiveFiles();
+
+        for(auto iterator = queryResult.constBegin(); iterator != queryResult.constEnd(); ++iterator)
+            latestVersionTable.insert(QDir::toNativeSeparators(iterator.key()), iterator.value());
+    }
+
+    logStartupPhase("load state", phaseTimer);
+
+    QStringList sortedPredictionList = getPredictionList();
+
+    // Watch parent folders first, so recursive watches can cover their sub folders.
+    std::sort(sortedPredictionList.begin(), sortedPredictionList.end(), [](const QString &s1, const QString &s2) {
+        return s1.length() < s2.length();
+    });
+
+    for(const QString &item : sortedPredictionList)
     {
         QFileInfo info(item);
 
@@ -67,7 +106,7 @@ void FileMonitoringManager::start()
             if(!folderPath.endsWith(QDir::separator()))
                 folderPath.append(QDir::separator());
 
-            efsw::WatchID watchId = fileWatcher.addWatch(folderPath.toStdString(), &fileSystemEventListener, false);
+            efsw::WatchID watchId = watchPlanner.watchFolder(folderPath);
 
             if(watchId > 0) // Successfully started monitoring folder
             {
@@ -78,32 +117,40 @@ void FileMonitoringManager::start()
             if(info.isFile()) // Add files in any case
             {
                 database->addFile(item);
-                QJsonObject fileJson = fsm->getFileJsonByUserPath(item);
-                QString symbolFilePath = fileJson[JsonKeys::File::SymbolFilePath].toString();
-                qlonglong maxVersionNumber = fileJson[JsonKeys::File::MaxVersionNumber].toInteger();
 
-                QJsonObject versionJson = fsm->getFileVersionJson(symbolFilePath, maxVersionNumber);
-                QString strLastModifiedTimestamp = versionJson[JsonKeys::FileVersion::LastModifiedTimestamp].toString();
-                QDateTime lastModifiedTimestamp = QDateTime::fromString(strLastModifiedTimestamp, Qt::DateFormat::ISODateWithMs);
-                QDateTime currentTimestamp = info.lastModified();
+                // Files which are same as last seen, while their latest version is too, don't need to be compared with it.
+                QString nativeFilePath = QDir::toNativeSeparators(item);
+                auto savedState = savedStateTable.constFind(nativeFilePath);
+                bool isFileUnchanged = (savedState != savedStateTable.constEnd()) &&
+                                       MonitorStateStore::isSameVersion(savedState.value(), latestVersionTable.value(nativeFilePath)) &&
+                                       MonitorStateStore::isUnchanged(savedState.value(), MonitorStateStore::readPathState(nativeFilePath));
 
-                bool isFileTouched = (lastModifiedTimestamp != currentTimestamp);
+                if(isFileUnchanged)
+                {
+                    ++unchangedFileCount;
+                    verifiedStateTable.insert(nativeFilePath, savedState.value());
+                }
+                else
+                {
+                    FileRecord fileRecord = fsm->getFileByUserPath(item);
+                    FileStat stat = FileStat::read(item);
+                    bool isFileTouched = !fsm->isFileUnchanged(fileRecord.symbolFilePath, stat);
 
-                if(isFileTouched)
-                    database->setStatusOfFile(item, FileSystemEventDb::Updated);
+                    if(isFileTouched)
+                        database->setStatusOfFile(item, FileSystemEventDb::Updated);
+                    else
+                        recordVerifiedState(nativeFilePath, fileRecord, stat);
+                }
             }
         }
         else
         {
-            QJsonObject folderJson = fsm->getFolderJsonByUserPath(item);
-            QJsonObject fileJson = fsm->getFileJsonByUserPath(item);
-
-            if(folderJson[JsonKeys::IsExist].toBool()) // If folder is missing
+            if(fsm->getFolderByUserPath(item).isExist) // If folder is missing
             {
                 database->addFolder(item);
                 database->setStatusOfFolder(item, FileSystemEventDb::ItemStatus::Missing);
             }
-            else if(fileJson[JsonKeys::IsExist].toBool())
+            else if(fsm->getFileByUserPath(item).isExist)
             {
                 database->addFile(item);
                 database->setStatusOfFile(item, FileSystemEventDb::ItemStatus::Missing);
@@ -113,9 +160,18 @@ void FileMonitoringManager::start()
         }
     }
 
+    logStartupPhase("prediction", phaseTimer);
+
+    // Sub folders are visited while iterating their monitored parents, so only walk the top most ones.
+    QStringList rootFolderList;
+    for(const QString &folderPath : database->getMonitoredFolderPathList())
+    {
+        if(rootFolderList.isEmpty() || !folderPath.startsWith(rootFolderList.last()))
+            rootFolderList.append(folderPath);
+    }
+
     // Discover not predicted folders & files
-    QStringList queryResult = database->getMonitoredFolderPathList();
-    for(const QString &queryItem : queryResult)
+    for(const QString &queryItem : rootFolderList)
     {
         QDir dir(queryItem);
         dir.setFilter(QDir::Filter::Dirs | QDir::Filter::NoDotAndDotDot);
@@ -129,14 +185,16 @@ void FileMonitoringManager::start()
             if(!candidateFolderPath.endsWith(QDir::separator()))
                 candidateFolderPath.append(QDir::separator());
 
-            QJsonObject folderJson = fsm->getFolderJsonByUserPath(candidateFolderPath);
-
             bool isFolderMonitored = database->isFolderExist(candidateFolderPath);
-            bool isFolderFrozen = folderJson[JsonKeys::Folder::IsFrozen].toBool();
 
-            if(!isFolderMonitored && !isFolderFrozen)
+            if(isFolderMonitored) // Predicted folders are already known to storage
+                continue;
+
+            bool isFolderFrozen = fsm->getFolderByUserPath(candidateFolderPath).isFrozen;
+
+            if(!isFolderFrozen)
             {
-                efsw::WatchID watchId = fileWatcher.addWatch(candidateFolderPath.toStdString(), &fileSystemEventListener, false);
+                efsw::WatchID watchId = watchPlanner.watchFolder(candidateFolderPath);
 
                 if(watchId <= 0) // Couldn't start monitoring folder successfully
                     database->addMonitoringError(candidateFolderPath, "Discovery", watchId);
@@ -158,12 +216,15 @@ void FileMonitoringManager::start()
         {
             QFileInfo info = fileIterator.nextFileInfo();
             QString candidateFilePath = QDir::toNativeSeparators(info.absoluteFilePath());
-            QJsonObject fileJson = fsm->getFileJsonByUserPath(candidateFilePath);
 
             bool isFileMonitored = database->isFileExist(candidateFilePath);
-            bool isFileFrozen = fileJson[JsonKeys::File::IsFrozen].toBool();
 
-            if(!isFileMonitored && !isFileFrozen)
+            if(isFileMonitored) // Predicted files are already known to storage
+                continue;
+
+            bool isFileFrozen = fsm->getFileByUserPath(candidateFilePath).isFrozen;
+
+            if(!isFileFrozen)
             {
                 database->addFile(candidateFilePath);
                 database->setStatusOfFile(candidateFilePath, FileSystemEventDb::ItemStatus::NewAdded);
@@ -171,17 +232,101 @@ void FileMonitoringManager::start()
         }
     }
 
-    emit signalEventDbUpdated();
+    logStartupPhase("discovery", phaseTimer);
+
+    saveMonitorState();
+
+    logStartupPhase("save state", phaseTimer);
+
+    LOG_INFO("FileMonitor", QString("startup took %1 ms, %2 of %3 saved file states reused")
+                            .arg(startupTimer.elapsed())
+                            .arg(unchangedFileCount)
+                            .arg(savedStateTable.size()));
+
+    LOG_INFO("FileMonitor", "watchUsage = " + watchPlanner.usageReport());
+
+    pollTimer->start();
+    publishSnapshot();
+}
+
+// Version is read after the comparison, when a version is appended meanwhile the state is only reused after comparing again.
+void FileMonitoringManager::recordVerifiedState(const QString &filePath, const FileRecord &fileRecord, const FileStat &stat)
+{
+    FileVersionRecord latestVersion = FileStorageManager::instance()->getFileVersion(fileRecord.symbolFilePath,
+                                                                                     fileRecord.maxVersionNumber);
+
+    MonitorStateStore::PathState state = MonitorStateStore::stateOf(stat);
+    state.versionNumber = latestVersion.versionNumber;
+    state.versionHash = latestVersion.hash;
+
+    verifiedStateTable.insert(filePath, state);
+}
+
+// Only states taken when a file matched its latest stored version are recorded, and only while the file still has that state.
+// Edits whose events were missed change the state, so those files are compared with storage again on next start.
+void FileMonitoringManager::saveMonitorState()
+{
+    if(database == nullptr)
+        return;
+
+    QHash<QString, MonitorStateStore::PathState> stateTable;
+
+    for(auto iterator = verifiedStateTable.constBegin(); iterator != verifiedStateTable.constEnd(); ++iterator)
+    {
+        const QString &filePath = iterator.key();
+
+        if(!database->isFileExist(filePath) || database->getStatusOfFile(filePath) != FileSystemEventDb::ItemStatus::Monitored)
+            continue;
+
+        if(MonitorStateStore::isUnchanged(iterator.value(), MonitorStateStore::readPathState(filePath)))
+            stateTable.insert(filePath, iterator.value());
+    }
+
+    bool isSaved = MonitorStateStore().save(stateTable);
+
+    if(!isSaved)
+        LOG_WARNING("FileMonitor", "Monitor state couldn't be saved");
+}
+
+void FileMonitoringManager::logStartupPhase(const QString &phaseName, QElapsedTimer &phaseTimer)
+{
+    LOG_INFO("FileMonitor", QString("startup phase %1 took %2 ms").arg(phaseName).arg(phaseTimer.restart()));
 }
 
 void FileMonitoringManager::pauseMonitoring()
 {
+    eventCoalescer->flush(); // Deliver events happened before the pause as live events.
     fileSystemEventListener.blockSignals(true);
 }
 
 void FileMonitoringManager::continueMonitoring()
 {
     fileSystemEventListener.blockSignals(false);
+
+    if(database == nullptr)
+        return;
+
+    auto fsm = FileStorageManager::instance();
+
+    // Events of the pause are lost. States of files changed meanwhile are dropped, files saved meanwhile are compared with storage.
+    for(const QString &filePath : database->getFileListByStatus(FileSystemEventDb::ItemStatus::Monitored))
+    {
+        QString nativeFilePath = QDir::toNativeSeparators(filePath);
+        FileStat stat = FileStat::read(nativeFilePath);
+        MonitorStateStore::PathState currentState = MonitorStateStore::stateOf(stat);
+
+        auto verifiedState = verifiedStateTable.constFind(nativeFilePath);
+
+        if(verifiedState != verifiedStateTable.constEnd() && MonitorStateStore::isUnchanged(verifiedState.value(), currentState))
+            continue;
+
+        verifiedStateTable.remove(nativeFilePath);
+
+        FileRecord fileRecord = fsm->getFileByUserPath(nativeFilePath);
+
+        if(fileRecord.isExist && fsm->isFileUnchanged(fileRecord.symbolFilePath, stat))
+            recordVerifiedState(nativeFilePath, fileRecord, stat);
+    }
 }
 
 void FileMonitoringManager::addTargetAtRuntime(const QString &pathToFileOrFolder)
@@ -205,16 +350,69 @@ void FileMonitoringManager::stopMonitoringTarget(const QString &pathToFileOrFold
 
         if(isFolderMonitored)
         {
-            QList<efsw::WatchID> result = database->getEfswIDListOfFolderTree(pathToFileOrFolder);
-
-            for(const efsw::WatchID watchId : result)
-                fileWatcher.removeWatch(watchId);
-
+            watchPlanner.unwatchFolderTree(pathToFileOrFolder);
             database->deleteFolder(pathToFileOrFolder);
         }
     }
 }
 
+void FileMonitoringManager::slotOnEventBatchReady(const QList<FileSystemEventCoalescer::Event> &eventBatch)
+{
+    LOG_DEBUG("FileMonitor", QString("eventBatch = %1, raw events = %2, delivered events = %3")
+                             .arg(eventBatch.size())
+                             .arg(eventCoalescer->rawEventCount())
+                             .arg(eventCoalescer->deliveredEventCount()));
+
+    for(const FileSystemEventCoalescer::Event &event : eventBatch)
+    {
+        // Recursive watches also report sub folders which are not monitored (e.g. frozen ones).
+        if(watchPlanner.isRecursiveMode() && !database->isFolderExist(event.dir))
+            continue;
+
+        watchPlanner.recordActivity(event.dir);
+
+        if(event.action == efsw::Actions::Add)
+            slotOnAddEventDetected(event.fileName, event.dir);
+        else if(event.action == efsw::Actions::Delete)
+            slotOnDeleteEventDetected(event.fileName, event.dir);
+        else if(event.action == efsw::Actions::Modified)
+            slotOnModificationEventDetected(event.fileName, event.dir);
+        else if(event.action == efsw::Actions::Moved)
+            slotOnMoveEventDetected(event.fileName, event.oldFileName, event.dir);
+    }
+}
+
+void FileMonitoringManager::requestSnapshot()
+{
+    notifyEventDbUpdated();
+}
+
+void FileMonitoringManager::publishSnapshot()
+{
+    snapshotTimer->stop();
+
+    if(database == nullptr) // Not started yet
+        return;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    auto snapshot = QSharedPointer<const FileMonitorSnapshot>::create(database->createSnapshot());
+
+    LOG_DEBUG("FileMonitor", QString("snapshot of %1 items built in %2 ms")
+                             .arg(snapshot->entryList.size())
+                             .arg(timer.elapsed()));
+
+    emit signalSnapshotPublished(snapshot);
+}
+
+// Changes are collected until the timer fires, so ui gets one snapshot per interval instead of one per event.
+void FileMonitoringManager::notifyEventDbUpdated()
+{
+    if(!snapshotTimer->isActive())
+        snapshotTimer->start();
+}
+
 void FileMonitoringManager::slotOnAddEventDetected(const QString &fileName, const QString &dir)
 {
     QString _dir = dir;
@@ -224,8 +422,7 @@ void FileMonitoringManager::slotOnAddEventDetected(const QString &fileName, cons
 
     QString currentPath = QDir::toNativeSeparators(_dir + fileName);
     QFileInfo info(currentPath);
-    qDebug() << "addEvent = " << currentPath;
-    qDebug() << "";
+    LOG_TRACE("FileMonitor", "addEvent = " + currentPath);
 
     if(info.isDir())
     {
@@ -235,13 +432,13 @@ void FileMonitoringManager::slotOnAddEventDetected(const QString &fileName, cons
         bool isFolderMonitored = database->isFolderExist(currentPath);
 
         auto fsm = FileStorageManager::instance();
-        QJsonObject folderJson = fsm->getFolderJsonByUserPath(currentPath);
-        bool isFolderPersists = folderJson[JsonKeys::IsExist].toBool();
-        bool isFolderFrozen = folderJson[JsonKeys::Folder::IsFrozen].toBool();
+        FolderRecord folderRecord = fsm->getFolderByUserPath(currentPath);
+        bool isFolderPersists = folderRecord.isExist;
+        bool isFolderFrozen = folderRecord.isFrozen;
 
         if(!isFolderFrozen) // Only monitor active (un-frozen) folders
         {
-            efsw::WatchID watchId = fileWatcher.addWatch(currentPath.toStdString(), &fileSystemEventListener, false);
+            efsw::WatchID watchId = watchPlanner.watchFolder(currentPath);
 
             if(watchId <= 0) // Coludn't start monitoring folder
                 database->addMonitoringError(currentPath, "AddEvent", watchId);
@@ -264,7 +461,7 @@ void FileMonitoringManager::slotOnAddEventDetected(const QString &fileName, cons
             }
 
             if(!fileSystemEventListener.signalsBlocked()) // If monitoring paused, do not trigger ui events
-                emit signalEventDbUpdated();
+                notifyEventDbUpdated();
         }
     }
     else if(info.isFile() && !info.isHidden()) // Only accept real files
@@ -272,16 +469,16 @@ void FileMonitoringManager::slotOnAddEventDetected(const QString &fileName, cons
         FileSystemEventDb::ItemStatus status = FileSystemEventDb::ItemStatus::Invalid;
 
         auto fsm = FileStorageManager::instance();
-        QJsonObject fileJson = fsm->getFileJsonByUserPath(currentPath);
-        bool isFilePersists = fileJson[JsonKeys::IsExist].toBool();
-        bool isFileFrozen = fileJson[JsonKeys::File::IsFrozen].toBool();
+        FileRecord fileRecord = fsm->getFileByUserPath(currentPath);
+        bool isFilePersists = fileRecord.isExist;
+        bool isFileFrozen = fileRecord.isFrozen;
 
         if(!isFilePersists)
         {
             status = FileSystemEventDb::ItemStatus::NewAdded;
             database->addFile(currentPath);
             database->setStatusOfFile(currentPath, status);
-            emit signalEventDbUpdated();
+            notifyEventDbUpdated();
         }
         else if(isFilePersists & !isFileFrozen)
         {
@@ -294,22 +491,20 @@ void FileMonitoringManager::slotOnAddEventDetected(const QString &fileName, cons
             database->setStatusOfFile(currentPath, status);
 
             if(!fileSystemEventListener.signalsBlocked()) // If monitoring paused, do not trigger ui events
-                emit signalEventDbUpdated();
+                notifyEventDbUpdated();
         }
     }
 }
 
 void FileMonitoringManager::slotOnDeleteEventDetected(const QString &fileName, const QString &dir)
 {
-    qDebug() << "deleteEvent = " << dir << fileName;
-    qDebug() << "";
+    LOG_TRACE("FileMonitor", "deleteEvent = " + dir + fileName);
 
     QString currentPath = QDir::toNativeSeparators(dir + fileName);
     FileSystemEventDb::ItemStatus currentStatus;
 
     if(database->isFolderExist(currentPath)) // When folder deleted
     {
-        efsw::WatchID watchId = database->getEfswIDofFolder(currentPath);
         currentStatus = database->getStatusOfFolder(currentPath);
 
         if(currentStatus == FileSystemEventDb::ItemStatus::NewAdded) // Remove new added folders since they're temporary
@@ -317,9 +512,9 @@ void FileMonitoringManager::slotOnDeleteEventDetected(const QString &fileName, c
         else
             database->setStatusOfFolder(currentPath, FileSystemEventDb::ItemStatus::Deleted);
 
-        fileWatcher.removeWatch(watchId);
+        watchPlanner.unwatchFolderTree(currentPath);
 
-        emit signalEventDbUpdated();
+        notifyEventDbUpdated();
     }
     else if(database->isFileExist(currentPath)) // When file deleted
     {
@@ -328,12 +523,8 @@ void FileMonitoringManager::slotOnDeleteEventDetected(const QString &fileName, c
 
         auto fsm = FileStorageManager::instance();
 
-        QJsonObject fileJson = fsm->getFileJsonByUserPath(currentPath);
-        QJsonObject originalFileJson = fsm->getFileJsonByUserPath(originalPath);
-
-        bool isFilePersists = fileJson[JsonKeys::IsExist].toBool();
-
-        bool isOriginalFilePersists = originalFileJson[JsonKeys::IsExist].toBool();
+        bool isFilePersists = fsm->getFileByUserPath(currentPath).isExist;
+        bool isOriginalFilePersists = fsm->getFileByUserPath(originalPath).isExist;
 
         if(isOriginalFilePersists)
         {
@@ -353,14 +544,13 @@ void FileMonitoringManager::slotOnDeleteEventDetected(const QString &fileName, c
         else
             database->deleteFile(currentPath);
 
-        emit signalEventDbUpdated();
+        notifyEventDbUpdated();
     }
 }
 
 void FileMonitoringManager::slotOnModificationEventDetected(const QString &fileName, const QString &dir)
 {
-    qDebug() << "updateEvent = " << dir << fileName;
-    qDebug() << "";
+    LOG_TRACE("FileMonitor", "updateEvent = " + dir + fileName);
 
     QString currentPath = QDir::toNativeSeparators(dir + fileName);
 
@@ -371,28 +561,27 @@ void FileMonitoringManager::slotOnModificationEventDetected(const QString &fileN
 
         // Do not count updates for new added and renamed files.
         if(status == FileSystemEventDb::ItemStatus::NewAdded || status == FileSystemEventDb::ItemStatus::Renamed)
-            emit signalEventDbUpdated();
+            notifyEventDbUpdated();
         else
         {
             auto fsm = FileStorageManager::instance();
 
-            QJsonObject fileJson = fsm->getFileJsonByUserPath(currentPath);
-            QString symbolFilePath = fileJson[JsonKeys::File::SymbolFilePath].toString();
-            qlonglong maxVersionNumber = fileJson[JsonKeys::File::MaxVersionNumber].toInteger();
+            FileRecord fileRecord = fsm->getFileByUserPath(currentPath);
+            FileStat stat = FileStat::read(currentPath);
+
+            bool isFilePersists = fileRecord.isExist;
+            bool isFileFrozen = fileRecord.isFrozen;
+            bool isFileTouched = !fsm->isFileUnchanged(fileRecord.symbolFilePath, stat);
 
-            QJsonObject versionJson = fsm->getFileVersionJson(symbolFilePath, maxVersionNumber);
-            QString strLastModifiedTimestamp = versionJson[JsonKeys::FileVersion::LastModifiedTimestamp].toString();
-            QDateTime lastModifiedTimestamp = QDateTime::fromString(strLastModifiedTimestamp, Qt::DateFormat::ISODateWithMs);
-            QDateTime currentTimestamp = QFileInfo(currentPath).lastModified();
+            verifiedStateTable.remove(currentPath);
 
-            bool isFilePersists = fileJson[JsonKeys::IsExist].toBool();
-            bool isFileFrozen = fileJson[JsonKeys::File::IsFrozen].toBool();
-            bool isFileTouched = (lastModifiedTimestamp != currentTimestamp);
+            if(isFilePersists && !isFileTouched)
+                recordVerifiedState(currentPath, fileRecord, stat);
 
             if(isFilePersists && !isFileFrozen && isFileTouched)
             {
                 database->setStatusOfFile(currentPath, FileSystemEventDb::ItemStatus::Updated);
-                emit signalEventDbUpdated();
+                notifyEventDbUpdated();
             }
         }
     }
@@ -400,8 +589,7 @@ void FileMonitoringManager::slotOnModificationEventDetected(const QString &fileN
 
 void FileMonitoringManager::slotOnMoveEventDetected(const QString &fileName, const QString &oldFileName, const QString &dir)
 {
-    qDebug() << "renameEvent (old) -> (new) = " << oldFileName << fileName << dir;
-    qDebug() << "";
+    LOG_TRACE("FileMonitor", QString("renameEvent (old) -> (new) = %1 -> %2 in %3").arg(oldFileName, fileName, dir));
 
     QString currentOldPath = QDir::toNativeSeparators(dir + oldFileName);
     QString currentNewPath = QDir::toNativeSeparators(dir + fileName);
@@ -422,23 +610,23 @@ void FileMonitoringManager::slotOnMoveEventDetected(const QString &fileName, con
                 database->setStatusOfFolder(currentOldPath, FileSystemEventDb::ItemStatus::Renamed);
 
             QString userFolderPath = currentOldPath + FileStorageManager::separator;
-            bool isFolderPersists = fsm->getFolderJsonByUserPath(userFolderPath)[JsonKeys::IsExist].toBool();
+            bool isFolderPersists = fsm->getFolderByUserPath(userFolderPath).isExist;
             if(isFolderPersists)
                 database->setOldNameOfFolder(currentOldPath, oldFileName);
 
             database->setPathOfFolder(currentOldPath, currentNewPath);
 
-            emit signalEventDbUpdated();
+            notifyEventDbUpdated();
         }
     }
     else if(info.isFile() && !info.isHidden())
     {
         QString originalFileName = database->getOldNameOfFile(currentOldPath);
         FileSystemEventDb::ItemStatus statusOfOldFile = database->getStatusOfFile(currentOldPath);
-        QJsonObject newFileJson = fsm->getFileJsonByUserPath(currentNewPath);
+        FileRecord newFileRecord = fsm->getFileByUserPath(currentNewPath);
 
-        bool isNewFilePersists = newFileJson[JsonKeys::IsExist].toBool();
-        bool isNewFileFrozen = newFileJson[JsonKeys::File::IsFrozen].toBool();
+        bool isNewFilePersists = newFileRecord.isExist;
+        bool isNewFileFrozen = newFileRecord.isFrozen;
 
         bool isOldFileMonitored = database->isFileExist(currentOldPath);
         bool isNewFileMonitored = database->isFileExist(currentNewPath);
@@ -452,7 +640,7 @@ void FileMonitoringManager::slotOnMoveEventDetected(const QString &fileName, con
             database->setOldNameOfFile(currentNewPath, originalFileName);
             database->setStatusOfFile(currentNewPath, FileSystemEventDb::ItemStatus::Updated);
 
-            emit signalEventDbUpdated();
+            notifyEventDbUpdated();
         }
         else if(isNewFilePersists && isNewFileFrozen)
         {
@@ -468,7 +656,7 @@ void FileMonitoringManager::slotOnMoveEventDetected(const QString &fileName, con
             database->setOldNameOfFile(currentNewPath, originalFileName);
             database->setStatusOfFile(currentNewPath, FileSystemEventDb::ItemStatus::NewAdded);
 
-            emit signalEventDbUpdated();
+            notifyEventDbUpdated();
         }
         else
         {
@@ -480,7 +668,7 @@ void FileMonitoringManager::slotOnMoveEventDetected(const QString &fileName, con
 
             database->setNameOfFile(currentOldPath, fileName);
 
-            emit signalEventDbUpdated();
+            notifyEventDbUpdated();
         }
     }
 }
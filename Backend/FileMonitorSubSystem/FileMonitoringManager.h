@@ -1,16 +1,26 @@
 #ifndef FILEMONITORINGMANAGER_H
 #define FILEMONITORINGMANAGER_H
 
+#include <QTimer>
 #include <QObject>
+#include <QElapsedTimer>
+#include <QSharedPointer>
 
 #include "Backend/FileMonitorSubSystem/FileSystemEventListener.h"
+#include "Backend/FileMonitorSubSystem/FileSystemEventCoalescer.h"
+#include "Backend/FileMonitorSubSystem/FileSystemWatchPlanner.h"
+#include "Backend/FileMonitorSubSystem/MonitorStateStore.h"
 #include "Backend/FileMonitorSubSystem/FileSystemEventDb.h"
+#include "Backend/FileMonitorSubSystem/FileMonitorSnapshot.h"
 
 
 class FileMonitoringManager : public QObject
 {
     Q_OBJECT
 public:
+    // Snapshots are published at most once per this interval.
+    static const inline int SnapshotPublishIntervalMs = 500;
+
     explicit FileMonitoringManager(QObject *parent = nullptr);
     ~FileMonitoringManager();
 
@@ -23,21 +33,36 @@ public slots:
     void continueMonitoring();
     void addTargetAtRuntime(const QString &pathToFileOrFolder);
     void stopMonitoringTarget(const QString &pathToFileOrFolder);
+    void requestSnapshot();
+    void publishSnapshot();
 
 signals:
-    void signalEventDbUpdated();
+    void signalSnapshotPublished(QSharedPointer<const FileMonitorSnapshot> snapshot);
 
 private slots:
+    void slotOnEventBatchReady(const QList<FileSystemEventCoalescer::Event> &eventBatch);
     void slotOnAddEventDetected(const QString &fileName, const QString &dir);
     void slotOnDeleteEventDetected(const QString &fileName, const QString &dir);
     void slotOnModificationEventDetected(const QString &fileName, const QString &dir);
     void slotOnMoveEventDetected(const QString &fileName, const QString &oldFileName, const QString &dir);
 
 private:
+    void notifyEventDbUpdated();
+    void recordVerifiedState(const QString &filePath, const FileRecord &fileRecord, const FileStat &stat);
+    void saveMonitorState();
+    void logStartupPhase(const QString &phaseName, QElapsedTimer &phaseTimer);
+
     FileSystemEventDb *database;
+    FileSystemEventCoalescer *eventCoalescer;
+    QTimer *snapshotTimer;
+    QTimer *pollTimer;
     QStringList predictionList;
+
+    // States of files at the moment they matched their latest stored version.
+    QHash<QString, MonitorStateStore::PathState> verifiedStateTable;
     FileSystemEventListener fileSystemEventListener;
     efsw::FileWatcher fileWatcher;
+    FileSystemWatchPlanner watchPlanner;
 
 };
 
@@ -0,0 +1,215 @@
+#include "FileSystemEventCoalescer.h"
+
+#include <QMutexLocker>
+
+FileSystemEventCoalescer::FileSystemEventCoalescer(QObject *parent)
+    : QObject{parent},
+      flushTimer(this),
+      quietWindowMs(DefaultQuietWindowMs),
+      maxLatencyMs(DefaultMaxLatencyMs),
+      rawEvents(0),
+      deliveredEvents(0),
+      batches(0)
+{
+    firstEventTimestamp = 0;
+    lastEventTimestamp = 0;
+    clock.start();
+
+    flushTimer.setSingleShot(true);
+
+    QObject::connect(&flushTimer, &QTimer::timeout,
+                     this, &FileSystemEventCoalescer::onFlushTimerTimeout);
+}
+
+void FileSystemEventCoalescer::addEvent(efsw::Action action, const QString &dir, const QString &fileName, const QString &oldFileName)
+{
+    bool isFirstEvent = false;
+
+    QMutexLocker locker(&mutex);
+
+    ++rawEvents;
+    qint64 now = clock.elapsed();
+
+    if(pendingEventList.isEmpty())
+    {
+        isFirstEvent = true;
+        firstEventTimestamp = now;
+    }
+
+    lastEventTimestamp = now;
+
+    QString key = dir + fileName;
+
+    if(action == efsw::Actions::Moved)
+    {
+        // Moves are never folded, later events of both paths are queued after the move.
+        pendingEventIndex.remove(dir + oldFileName);
+        pendingEventIndex.remove(key);
+
+        PendingEvent pending;
+        pending.event = {action, dir, fileName, oldFileName};
+        pendingEventList.append(pending);
+    }
+    else
+    {
+        auto iterator = pendingEventIndex.constFind(key);
+
+        if(iterator == pendingEventIndex.constEnd())
+        {
+            PendingEvent pending;
+            pending.event = {action, dir, fileName, oldFileName};
+            pendingEventList.append(pending);
+            pendingEventIndex.insert(key, pendingEventList.size() - 1);
+        }
+        else
+        {
+            PendingEvent &pending = pendingEventList[iterator.value()];
+            foldEvent(pending, action);
+
+            if(pending.isDropped)
+                pendingEventIndex.remove(key);
+        }
+    }
+
+    locker.unlock();
+
+    // Timer belongs to the thread of this object, so it is started through the event loop.
+    if(isFirstEvent)
+    {
+        QMetaObject::invokeMethod(this, [this]() {
+            flushTimer.start(quietWindowMs.load());
+        }, Qt::ConnectionType::QueuedConnection);
+    }
+}
+
+int FileSystemEventCoalescer::getQuietWindowMs() const
+{
+    return quietWindowMs;
+}
+
+void FileSystemEventCoalescer::setQuietWindowMs(int newQuietWindowMs)
+{
+    quietWindowMs = qMax(newQuietWindowMs, 0);
+}
+
+int FileSystemEventCoalescer::getMaxLatencyMs() const
+{
+    return maxLatencyMs;
+}
+
+void FileSystemEventCoalescer::setMaxLatencyMs(int newMaxLatencyMs)
+{
+    maxLatencyMs = qMax(newMaxLatencyMs, 0);
+}
+
+qlonglong FileSystemEventCoalescer::rawEventCount() const
+{
+    return rawEvents;
+}
+
+qlonglong FileSystemEventCoalescer::deliveredEventCount() const
+{
+    return deliveredEvents;
+}
+
+qlonglong FileSystemEventCoalescer::batchCount() const
+{
+    return batches;
+}
+
+void FileSystemEventCoalescer::flush()
+{
+    QList<Event> batch = takeBatch();
+
+    if(batch.isEmpty())
+        return;
+
+    deliveredEvents += batch.size();
+    ++batches;
+
+    emit signalEventBatchReady(batch);
+}
+
+void FileSystemEventCoalescer::onFlushTimerTimeout()
+{
+    QMutexLocker locker(&mutex);
+
+    if(pendingEventList.isEmpty())
+        return;
+
+    qint64 now = clock.elapsed();
+    qint64 quietTime = now - lastEventTimestamp;
+    qint64 batchAge = now - firstEventTimestamp;
+
+    if(quietTime < quietWindowMs && batchAge < maxLatencyMs)
+    {
+        qint64 remainingTime = qMin(quietWindowMs - quietTime, maxLatencyMs - batchAge);
+        flushTimer.start(remainingTime);
+        return;
+    }
+
+    locker.unlock();
+    flush();
+}
+
+// Folds new action of a path into its pending event.
+void FileSystemEventCoalescer::foldEvent(PendingEvent &pending, efsw::Action action)
+{
+    efsw::Action currentAction = pending.event.action;
+
+    if(currentAction == efsw::Actions::Add)
+    {
+        if(action == efsw::Actions::Delete)
+        {
+            if(pending.isDeletedBefore) // delete + add + delete = delete
+            {
+                pending.event.action = efsw::Actions::Delete;
+                pending.isDeletedBefore = false;
+            }
+            else // add + delete = nothing
+                pending.isDropped = true;
+        }
+        // add + modify = add
+    }
+    else if(currentAction == efsw::Actions::Modified)
+    {
+        if(action == efsw::Actions::Delete) // modify + delete = delete
+            pending.event.action = efsw::Actions::Delete;
+        // modify + modify = modify
+    }
+    else if(currentAction == efsw::Actions::Delete)
+    {
+        if(action == efsw::Actions::Add) // delete + add = replace
+        {
+            pending.event.action = efsw::Actions::Add;
+            pending.isDeletedBefore = true;
+        }
+    }
+}
+
+QList<FileSystemEventCoalescer::Event> FileSystemEventCoalescer::takeBatch()
+{
+    QList<Event> result;
+
+    QMutexLocker locker(&mutex);
+
+    for(const PendingEvent &pending : pendingEventList)
+    {
+        if(pending.isDropped)
+            continue;
+
+        if(pending.isDeletedBefore)
+        {
+            Event deleteEvent = pending.event;
+            deleteEvent.action = efsw::Actions::Delete;
+            result.append(deleteEvent);
+        }
+
+        result.append(pending.event);
+    }
+
+    pendingEventList.clear();
+    pendingEventIndex.clear();
+
+    return result;
+}
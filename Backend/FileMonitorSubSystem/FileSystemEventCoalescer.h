@@ -0,0 +1,84 @@
+#ifndef FILESYSTEMEVENTCOALESCER_H
+#define FILESYSTEMEVENTCOALESCER_H
+
+#include <atomic>
+
+#include <QHash>
+#include <QMutex>
+#include <QTimer>
+#include <QObject>
+#include <QElapsedTimer>
+#include <efsw/efsw.hpp>
+
+// Collects raw efsw events from the watcher thread and delivers them as ordered batches.
+// Repeated events of the same path are folded while they wait in the batch.
+class FileSystemEventCoalescer : public QObject
+{
+    Q_OBJECT
+public:
+    struct Event
+    {
+        efsw::Action action;
+        QString dir;
+        QString fileName;
+        QString oldFileName;
+    };
+
+    // Batch is delivered after this much quiet time...
+    static const inline int DefaultQuietWindowMs = 200;
+
+    // ...or at latest after this much time, even if events keep coming.
+    static const inline int DefaultMaxLatencyMs = 1000;
+
+    explicit FileSystemEventCoalescer(QObject *parent = nullptr);
+
+    // Thread safe, called from efsw threads.
+    void addEvent(efsw::Action action, const QString &dir, const QString &fileName, const QString &oldFileName);
+
+    int getQuietWindowMs() const;
+    void setQuietWindowMs(int newQuietWindowMs);
+    int getMaxLatencyMs() const;
+    void setMaxLatencyMs(int newMaxLatencyMs);
+
+    qlonglong rawEventCount() const;
+    qlonglong deliveredEventCount() const;
+    qlonglong batchCount() const;
+
+public slots:
+    // Delivers pending events immediately.
+    void flush();
+
+signals:
+    void signalEventBatchReady(const QList<FileSystemEventCoalescer::Event> &eventBatch);
+
+private slots:
+    void onFlushTimerTimeout();
+
+private:
+    struct PendingEvent
+    {
+        Event event;
+        bool isDropped = false;
+        bool isDeletedBefore = false; // Delete followed by add, delivered as two events.
+    };
+
+    void foldEvent(PendingEvent &pending, efsw::Action action);
+    QList<Event> takeBatch();
+
+    QMutex mutex;
+    QList<PendingEvent> pendingEventList;
+    QHash<QString, qsizetype> pendingEventIndex;
+    qint64 firstEventTimestamp;
+    qint64 lastEventTimestamp;
+
+    QElapsedTimer clock;
+    QTimer flushTimer;
+    std::atomic_int quietWindowMs;
+    std::atomic_int maxLatencyMs;
+
+    std::atomic<qlonglong> rawEvents;
+    std::atomic<qlonglong> deliveredEvents;
+    std::atomic<qlonglong> batches;
+};
+
+#endif // FILESYSTEMEVENTCOALESCER_H
@@ -1,65 +1,48 @@
 #include "FileSystemEventDb.h"
+#include "FileMonitorSnapshot.h"
 
 #include <QDir>
-#include <QUuid>
+#include <QStack>
+#include <QFileInfo>
+#include <QDateTime>
 #include <QSqlQuery>
 #include <QSqlError>
-#include <QSqlRecord>
-#include <QStandardPaths>
-#include <QRandomGenerator>
+#include <QReadLocker>
+#include <QWriteLocker>
 
-FileSystemEventDb::FileSystemEventDb(const QSqlDatabase &eventDb)
+QReadWriteLock FileSystemEventDb::lock;
+QHash<QString, FileSystemEventDb::FolderRow> FileSystemEventDb::folderTable;
+QHash<QString, FileSystemEventDb::FileRow> FileSystemEventDb::fileTable;
+QHash<QString, QSet<QString>> FileSystemEventDb::childFolderIndex;
+QHash<QString, QSet<QString>> FileSystemEventDb::childFileIndex;
+QList<FileSystemEventDb::MonitoringErrorRow> FileSystemEventDb::monitoringErrorTable;
+
+FileSystemEventDb::FileSystemEventDb()
 {
-    database = eventDb;
 
-    if(!database.isOpen())
-        database.open();
 }
 
 FileSystemEventDb::~FileSystemEventDb()
 {
-    database.close();
+
 }
 
 bool FileSystemEventDb::isFolderExist(const QString &pathToFolder) const
 {
-    bool result = false;
-
-    QString nativePath = QDir::toNativeSeparators(pathToFolder);
-
-    if(!nativePath.endsWith(QDir::separator()))
-        nativePath.append(QDir::separator());
+    QString folderKey = toFolderKey(pathToFolder);
 
-    QString queryTemplate = "SELECT * FROM Folder WHERE folder_path = :1;" ;
+    QReadLocker readLocker(&lock);
 
-    QSqlQuery query(database);
-    query.prepare(queryTemplate);
-    query.bindValue(":1", nativePath);
-    query.exec();
-
-    if(query.next())
-        result = true;
-
-    return result;
+    return folderTable.contains(folderKey);
 }
 
 bool FileSystemEventDb::isFileExist(const QString &pathToFile) const
 {
-    bool result = false;
-
-    QString nativePath = QDir::toNativeSeparators(pathToFile);
+    QString fileKey = toFileKey(pathToFile);
 
-    QString queryTemplate = "SELECT * FROM File WHERE file_path = :1;" ;
+    QReadLocker readLocker(&lock);
 
-    QSqlQuery query(database);
-    query.prepare(queryTemplate);
-    query.bindValue(":1", nativePath);
-    query.exec();
-
-    if(query.next())
-        result = true;
-
-    return result;
+    return fileTable.contains(fileKey);
 }
 
 bool FileSystemEventDb::addFolder(const QString &pathToFolder)
@@ -69,9 +52,11 @@ bool FileSystemEventDb::addFolder(const QString &pathToFolder)
     if(nativePath.endsWith(QDir::separator()))
         nativePath.chop(1);
 
-    QString queryTemplate = "INSERT INTO Folder(folder_path, parent_folder_path, event_timestamp) VALUES(:1, :2, :3);" ;
     QStringList folderNames = nativePath.split(QDir::separator());
     QString parentFolderPath = "";
+    qint64 timestamp = QDateTime::currentMSecsSinceEpoch();
+
+    QWriteLocker writeLocker(&lock);
 
     for(const QString &folder : folderNames)
     {
@@ -79,31 +64,20 @@ bool FileSystemEventDb::addFolder(const QString &pathToFolder)
         QString currentSubFolderPath = folder + QDir::separator();
         QString currentFolderPath = parentFolderPath + currentSubFolderPath;
 
-        bool isInsertingRootPath = currentFolderPath == QDir::toNativeSeparators(QDir::rootPath());
-
-        bool isAlreadyInDb = isFolderExist(currentFolderPath);
-
-        if(!isAlreadyInDb) // If root path not in db
+        if(!folderTable.contains(currentFolderPath))
         {
-            QSqlQuery query(database);
-            query.prepare(queryTemplate);
-
-            query.bindValue(":1", currentFolderPath);
-            query.bindValue(":3", QDateTime::currentDateTime());
-
-            if(isInsertingRootPath)
-                query.bindValue(":2", QVariant()); // Bind null value.
-            else
-                query.bindValue(":2", parentFolderPath);
+            FolderRow row;
+            row.parentFolderPath = parentFolderPath; // Empty for root path.
+            row.eventTimestamp = timestamp;
 
-            query.exec();
+            folderTable.insert(currentFolderPath, row);
 
-            if(query.lastError().type() != QSqlError::ErrorType::NoError)
-                return false;
+            if(!parentFolderPath.isEmpty())
+                childFolderIndex[parentFolderPath].insert(currentFolderPath);
         }
 
         // Set last inserted path as root path
-        parentFolderPath += currentSubFolderPath;
+        parentFolderPath = currentFolderPath;
     }
 
     return true;
@@ -111,695 +85,719 @@ bool FileSystemEventDb::addFolder(const QString &pathToFolder)
 
 bool FileSystemEventDb::addFile(const QString &pathToFile)
 {
-    bool result = false;
     QFileInfo info(pathToFile);
+    QString fileKey = toFileKey(pathToFile);
 
-    bool isAlreadyInDb = isFileExist(pathToFile);
-
-    if(isAlreadyInDb)
+    if(isFileExist(fileKey))
         return true;
 
-    QString nativeFolderPath = QDir::toNativeSeparators(info.absolutePath());
+    QString folderKey = toFolderKey(info.absolutePath());
 
-    if(!nativeFolderPath.endsWith(QDir::separator()))
-        nativeFolderPath.append(QDir::separator());
+    bool isFolderAdded = addFolder(folderKey);
 
-    bool isFolderAdded = addFolder(nativeFolderPath);
+    if(!isFolderAdded)
+        return false;
 
-    if(isFolderAdded)
-    {
-        QString queryTemplate = "INSERT INTO File(folder_path, file_name, event_timestamp) VALUES(:1, :2, :3);" ;
-        QSqlQuery query(database);
-        query.prepare(queryTemplate);
+    FileRow row;
+    row.folderPath = folderKey;
+    row.fileName = info.fileName();
+    row.eventTimestamp = QDateTime::currentMSecsSinceEpoch();
 
-        query.bindValue(":1", nativeFolderPath);
-        query.bindValue(":2", info.fileName());
-        query.bindValue(":3", QDateTime::currentDateTime());
+    QWriteLocker writeLocker(&lock);
 
-        query.exec();
+    fileKey = row.folderPath + row.fileName;
 
-        if(query.lastError().type() == QSqlError::ErrorType::NoError)
-            result = true;
+    if(!fileTable.contains(fileKey))
+    {
+        fileTable.insert(fileKey, row);
+        childFileIndex[folderKey].insert(fileKey);
     }
 
-    return result;
+    return true;
 }
 
 bool FileSystemEventDb::deleteFolder(const QString &pathToFolder)
 {
-    bool result = false;
-
-    QString nativePath = QDir::toNativeSeparators(pathToFolder);
+    QString folderKey = toFolderKey(pathToFolder);
 
-    if(!nativePath.endsWith(QDir::separator()))
-        nativePath.append(QDir::separator());
+    QWriteLocker writeLocker(&lock);
 
-    bool isFolderInDb = isFolderExist(nativePath);
-
-    if(isFolderInDb)
-    {
-        QString queryTemplate = "DELETE FROM Folder WHERE folder_path = :1;" ;
-        QSqlQuery query(database);
-        query.prepare(queryTemplate);
-
-        query.bindValue(":1", nativePath);
-
-        query.exec();
+    if(!folderTable.contains(folderKey))
+        return false;
 
-        if(query.lastError().type() == QSqlError::ErrorType::NoError)
-            result = true;
-    }
+    removeFolderTree(folderKey);
 
-    return result;
+    return true;
 }
 
 bool FileSystemEventDb::deleteFile(const QString &pathToFile)
 {
-    bool result = false;
+    QString fileKey = toFileKey(pathToFile);
 
-    QString nativePath = QDir::toNativeSeparators(pathToFile);
+    QWriteLocker writeLocker(&lock);
 
-    bool isFileInDb = isFileExist(nativePath);
+    auto iterator = fileTable.find(fileKey);
 
-    if(isFileInDb)
-    {
-        QString queryTemplate = "DELETE FROM File WHERE file_path = :1;" ;
-        QSqlQuery query(database);
-        query.prepare(queryTemplate);
-
-        query.bindValue(":1", nativePath);
-
-        query.exec();
+    if(iterator == fileTable.end())
+        return false;
 
-        if(query.lastError().type() == QSqlError::ErrorType::NoError)
-            result = true;
-    }
+    childFileIndex[iterator->folderPath].remove(fileKey);
+    fileTable.erase(iterator);
 
-    return result;
+    return true;
 }
 
 bool FileSystemEventDb::setStatusOfFolder(const QString &pathToFolder, ItemStatus status)
 {
-    bool result = false;
+    QString folderKey = toFolderKey(pathToFolder);
 
-    QString nativePath = QDir::toNativeSeparators(pathToFolder);
+    QWriteLocker writeLocker(&lock);
 
-    if(!nativePath.endsWith(QDir::separator()))
-        nativePath.append(QDir::separator());
+    auto iterator = folderTable.find(folderKey);
 
-    bool isFolderInDb = isFolderExist(nativePath);
+    if(iterator == folderTable.end())
+        return false;
 
-    if(isFolderInDb)
-    {
-        QString queryTemplate = "UPDATE Folder SET status = :1, event_timestamp = :2 WHERE folder_path = :3;" ;
-        QSqlQuery query(database);
-        query.prepare(queryTemplate);
+    iterator->status = status;
+    iterator->eventTimestamp = QDateTime::currentMSecsSinceEpoch();
+
+    return true;
+}
 
-        query.bindValue(":1", status);
-        query.bindValue(":2", QDateTime::currentDateTime());
-        query.bindValue(":3", nativePath);
+bool FileSystemEventDb::setStatusOfFile(const QString &pathToFile, ItemStatus status)
+{
+    QString fileKey = toFileKey(pathToFile);
 
-        query.exec();
+    QWriteLocker writeLocker(&lock);
 
-        if(query.lastError().type() == QSqlError::ErrorType::NoError)
-            result = true;
-    }
+    auto iterator = fileTable.find(fileKey);
 
-    return result;
+    if(iterator == fileTable.end())
+        return false;
+
+    iterator->status = status;
+    iterator->eventTimestamp = QDateTime::currentMSecsSinceEpoch();
+
+    return true;
 }
 
-bool FileSystemEventDb::setStatusOfFile(const QString &pathToFile, ItemStatus status)
+bool FileSystemEventDb::setPathOfFolder(const QString &pathToFolder, const QString &newPath)
 {
-    bool result = false;
+    QString oldFolderKey = toFolderKey(pathToFolder);
+    QString newFolderKey = toFolderKey(newPath);
 
-    QString nativePath = QDir::toNativeSeparators(pathToFile);
+    QWriteLocker writeLocker(&lock);
 
-    bool isFileInDb = isFileExist(nativePath);
-
-    if(isFileInDb)
-    {
-        QString queryTemplate = "UPDATE File SET status = :1, event_timestamp = :2 WHERE file_path = :3;" ;
-        QSqlQuery query(database);
-        query.prepare(queryTemplate);
+    if(!folderTable.contains(oldFolderKey))
+        return false;
 
-        query.bindValue(":1", status);
-        query.bindValue(":2", QDateTime::currentDateTime());
-        query.bindValue(":3", nativePath);
+    if(oldFolderKey == newFolderKey)
+        return true;
 
-        query.exec();
+    if(folderTable.contains(newFolderKey)) // Folder paths are unique
+        return false;
 
-        if(query.lastError().type() == QSqlError::ErrorType::NoError)
-            result = true;
-    }
+    renameFolderTree(oldFolderKey, newFolderKey);
 
-    return result;
+    return true;
 }
 
-bool FileSystemEventDb::setPathOfFolder(const QString &pathToFolder, const QString &newPath)
+bool FileSystemEventDb::setNameOfFile(const QString &pathToFile, const QString &newName)
 {
-    bool result = false;
+    QString fileKey = toFileKey(pathToFile);
 
-    QString oldNativePath = QDir::toNativeSeparators(pathToFolder);
-    QString newNativePath = QDir::toNativeSeparators(newPath);
+    QWriteLocker writeLocker(&lock);
 
-    if(!oldNativePath.endsWith(QDir::separator()))
-        oldNativePath.append(QDir::separator());
+    auto iterator = fileTable.find(fileKey);
 
-    if(!newNativePath.endsWith(QDir::separator()))
-        newNativePath.append(QDir::separator());
+    if(iterator == fileTable.end())
+        return false;
 
-    bool isFolderInDb = isFolderExist(oldNativePath);
+    QString newFileKey = iterator->folderPath + newName;
 
-    if(isFolderInDb)
-    {
-        QString queryTemplate = "UPDATE Folder SET folder_path = :1 WHERE folder_path = :2;" ;
-        QSqlQuery query(database);
-        query.prepare(queryTemplate);
+    if(newFileKey == fileKey)
+        return true;
 
-        query.bindValue(":1", newNativePath);
-        query.bindValue(":2", oldNativePath);
+    if(fileTable.contains(newFileKey)) // File paths are unique
+        return false;
 
-        query.exec();
+    FileRow row = fileTable.take(fileKey);
+    row.fileName = newName;
 
-        if(query.lastError().type() == QSqlError::ErrorType::NoError)
-            result = true;
-    }
+    QSet<QString> &siblingFiles = childFileIndex[row.folderPath];
+    siblingFiles.remove(fileKey);
+    siblingFiles.insert(newFileKey);
 
-    return result;
+    fileTable.insert(newFileKey, row);
+
+    return true;
 }
 
-bool FileSystemEventDb::setNameOfFile(const QString &pathToFile, const QString &newName)
+bool FileSystemEventDb::setOldNameOfFolder(const QString &pathToFolder, const QString &oldName)
 {
-    bool result = false;
-
-    QString nativePath = QDir::toNativeSeparators(pathToFile);
+    QString folderKey = toFolderKey(pathToFolder);
 
-    bool isFileInDb = isFileExist(nativePath);
-
-    if(isFileInDb)
-    {
-        QString queryTemplate = "UPDATE File SET file_name = :1 WHERE file_path = :2;" ;
-        QSqlQuery query(database);
-        query.prepare(queryTemplate);
+    QWriteLocker writeLocker(&lock);
 
-        query.bindValue(":1", newName);
-        query.bindValue(":2", nativePath);
+    auto iterator = folderTable.find(folderKey);
 
-        query.exec();
+    if(iterator == folderTable.end())
+        return false;
 
-        if(query.lastError().type() == QSqlError::ErrorType::NoError)
-            result = true;
-    }
+    iterator->oldFolderName = oldName;
 
-    return result;
+    return true;
 }
 
-bool FileSystemEventDb::setOldNameOfFolder(const QString &pathToFolder, const QString &oldName)
+bool FileSystemEventDb::setOldNameOfFile(const QString &pathToFile, const QString &oldName)
 {
-    bool result = false;
+    QString fileKey = toFileKey(pathToFile);
 
-    QString nativePath = QDir::toNativeSeparators(pathToFolder);
+    QWriteLocker writeLocker(&lock);
+
+    auto iterator = fileTable.find(fileKey);
 
-    if(!nativePath.endsWith(QDir::separator()))
-        nativePath.append(QDir::separator());
+    if(iterator == fileTable.end())
+        return false;
 
-    bool isFolderInDb = isFolderExist(nativePath);
+    iterator->oldFileName = oldName;
 
-    if(isFolderInDb)
-    {
-        QString queryTemplate = "UPDATE Folder SET old_folder_name = :1 WHERE folder_path = :2;" ;
-        QSqlQuery query(database);
-        query.prepare(queryTemplate);
+    return true;
+}
 
-        if(oldName.isEmpty())
-            query.bindValue(":1", QVariant()); // Bind null value
-        else
-            query.bindValue(":1", oldName);
+bool FileSystemEventDb::setEfswIDofFolder(const QString &pathToFolder, long id)
+{
+    QString folderKey = toFolderKey(pathToFolder);
+    efsw::WatchID newId = (id > 0) ? id : 0; // 0 means folder is not watched
 
-        query.bindValue(":2", nativePath);
+    QWriteLocker writeLocker(&lock);
 
-        query.exec();
+    auto iterator = folderTable.find(folderKey);
 
-        if(query.lastError().type() == QSqlError::ErrorType::NoError)
-            result = true;
-    }
+    if(iterator == folderTable.end())
+        return false;
 
-    return result;
+    // Sub folders of a recursive watch share the id of the watch.
+    iterator->efswId = newId;
+
+    return true;
 }
 
-bool FileSystemEventDb::setOldNameOfFile(const QString &pathToFile, const QString &oldName)
+efsw::WatchID FileSystemEventDb::getEfswIDofFolder(const QString &pathToFolder) const
 {
-    bool result = false;
+    QString folderKey = toFolderKey(pathToFolder);
 
-    QString nativePath = QDir::toNativeSeparators(pathToFile);
+    QReadLocker readLocker(&lock);
 
-    bool isFileInDb = isFileExist(nativePath);
+    auto iterator = folderTable.constFind(folderKey);
 
-    if(isFileInDb)
-    {
-        QString queryTemplate = "UPDATE File SET old_file_name = :1 WHERE file_path = :2;" ;
-        QSqlQuery query(database);
-        query.prepare(queryTemplate);
+    if(iterator == folderTable.constEnd())
+        return -1;
+
+    return iterator->efswId;
+}
+
+QList<efsw::WatchID> FileSystemEventDb::getEfswIDListOfFolderTree(const QString &pathToRootFolder) const
+{
+    QList<efsw::WatchID> result;
+    QString rootFolderKey = toFolderKey(pathToRootFolder);
 
-        if(oldName.isEmpty())
-            query.bindValue(":1", QVariant()); // Bind null value
-        else
-            query.bindValue(":1", oldName);
+    QReadLocker readLocker(&lock);
 
-        query.bindValue(":2", nativePath);
+    if(!folderTable.contains(rootFolderKey))
+        return result;
 
-        query.exec();
+    for(const QString &folderKey : collectFolderTree(rootFolderKey))
+    {
+        efsw::WatchID id = folderTable.value(folderKey).efswId;
 
-        if(query.lastError().type() == QSqlError::ErrorType::NoError)
-            result = true;
+        if(id > 0 && !result.contains(id))
+            result.append(id);
     }
 
     return result;
 }
 
-bool FileSystemEventDb::setEfswIDofFolder(const QString &pathToFolder, long id)
+FileSystemEventDb::ItemStatus FileSystemEventDb::getStatusOfFolder(const QString &pathToFolder) const
 {
-    bool result = false;
+    QString folderKey = toFolderKey(pathToFolder);
 
-    bool isFolderInDb = isFolderExist(pathToFolder);
+    QReadLocker readLocker(&lock);
 
-    if(!isFolderInDb)
-        return false;
+    auto iterator = folderTable.constFind(folderKey);
 
-    QString nativePath = QDir::toNativeSeparators(pathToFolder);
+    if(iterator == folderTable.constEnd())
+        return ItemStatus::Invalid;
+
+    return iterator->status;
+}
+
+FileSystemEventDb::ItemStatus FileSystemEventDb::getStatusOfFile(const QString &pathToFile) const
+{
+    QString fileKey = toFileKey(pathToFile);
 
-    if(!nativePath.endsWith(QDir::separator()))
-        nativePath.append(QDir::separator());
+    QReadLocker readLocker(&lock);
 
-    QString queryTemplate = "UPDATE Folder SET efsw_id = :1 WHERE folder_path = :2;" ;
+    auto iterator = fileTable.constFind(fileKey);
 
-    QSqlQuery query(database);
-    query.prepare(queryTemplate);
+    if(iterator == fileTable.constEnd())
+        return ItemStatus::Invalid;
 
-    if(id > 0)
-        query.bindValue(":1", (qlonglong) id);
-    else
-        query.bindValue(":1", QVariant()); // set efsw_id as NULL
+    return iterator->status;
+}
 
-    query.bindValue(":2", nativePath);
+QString FileSystemEventDb::getNameOfFile(const QString &pathToFile) const
+{
+    QString fileKey = toFileKey(pathToFile);
 
-    query.exec();
+    QReadLocker readLocker(&lock);
 
-    if(query.lastError().type() == QSqlError::ErrorType::NoError)
-        result = true;
+    return fileTable.value(fileKey).fileName;
+}
 
-    return result;
+QString FileSystemEventDb::getOldNameOfFolder(const QString &pathToFolder) const
+{
+    QString folderKey = toFolderKey(pathToFolder);
+
+    QReadLocker readLocker(&lock);
+
+    return folderTable.value(folderKey).oldFolderName;
 }
 
-efsw::WatchID FileSystemEventDb::getEfswIDofFolder(const QString &pathToFolder) const
+QString FileSystemEventDb::getOldNameOfFile(const QString &pathToFile) const
 {
-    efsw::WatchID result = -1;
-    QString nativePath = QDir::toNativeSeparators(pathToFolder);
+    QString fileKey = toFileKey(pathToFile);
+
+    QReadLocker readLocker(&lock);
+
+    return fileTable.value(fileKey).oldFileName;
+}
 
-    if(!nativePath.endsWith(QDir::separator()))
-        nativePath.append(QDir::separator());
+QStringList FileSystemEventDb::getMonitoredFolderPathList() const
+{
+    QStringList result;
 
-    bool isFolderInDb = isFolderExist(nativePath);
+    QReadLocker readLocker(&lock);
 
-    if(isFolderInDb)
+    for(auto iterator = folderTable.constBegin(); iterator != folderTable.constEnd(); ++iterator)
     {
-        QSqlRecord record = getFolderRow(nativePath);
-        result = record.value("efsw_id").value<efsw::WatchID>();
+        if(iterator->efswId > 0)
+            result.append(iterator.key());
     }
 
+    readLocker.unlock();
+
+    result.sort();
     return result;
 }
 
-QList<efsw::WatchID> FileSystemEventDb::getEfswIDListOfFolderTree(const QString &pathToRootFolder) const
+QStringList FileSystemEventDb::getMonitoredRootFolderList() const
 {
-    QList<efsw::WatchID> result;
+    QReadLocker readLocker(&lock);
 
-    QString nativePath = QDir::toNativeSeparators(pathToRootFolder);
+    return collectMonitoredRootFolders();
+}
 
-    if(!nativePath.endsWith(QDir::separator()))
-        nativePath.append(QDir::separator());
+QStringList FileSystemEventDb::getMissingRootFolderList() const
+{
+    QReadLocker readLocker(&lock);
 
-    bool isFolderInDb = isFolderExist(nativePath);
+    return collectMissingRootFolders();
+}
 
-    if(isFolderInDb)
-    {
-        QString queryTemplate = "SELECT efsw_id FROM Folder WHERE folder_path LIKE :1;" ;
+QStringList FileSystemEventDb::getDirectChildFolderListOfFolder(const QString pathToFolder) const
+{
+    QString folderKey = toFolderKey(pathToFolder);
 
-        QSqlQuery query(database);
-        query.prepare(queryTemplate);
-        query.bindValue(":1", QString("%1%").arg(nativePath));
-        query.exec();
+    QReadLocker readLocker(&lock);
 
-        while(query.next())
-        {
-            QSqlRecord record = query.record();
-            efsw::WatchID value = record.value("efsw_id").value<efsw::WatchID>();
-            result.append(value);
-        }
-    }
+    QStringList result = childFolderIndex.value(folderKey).values();
+
+    readLocker.unlock();
 
+    result.sort();
     return result;
 }
 
-FileSystemEventDb::ItemStatus FileSystemEventDb::getStatusOfFolder(const QString &pathToFolder) const
+QStringList FileSystemEventDb::getDirectChildFileListOfFolder(const QString &pathToFolder) const
 {
-    FileSystemEventDb::ItemStatus result = FileSystemEventDb::ItemStatus::Invalid;
-    QString nativePath = QDir::toNativeSeparators(pathToFolder);
+    QString folderKey = toFolderKey(pathToFolder);
 
-    if(!nativePath.endsWith(QDir::separator()))
-        nativePath.append(QDir::separator());
+    QReadLocker readLocker(&lock);
 
-    bool isFolderInDb = isFolderExist(nativePath);
+    QStringList result = childFileIndex.value(folderKey).values();
 
-    if(isFolderInDb)
-    {
-        QSqlRecord row = getFolderRow(nativePath);
-        result = row.value("status").value<FileSystemEventDb::ItemStatus>();
-    }
+    readLocker.unlock();
 
+    result.sort();
     return result;
 }
 
-FileSystemEventDb::ItemStatus FileSystemEventDb::getStatusOfFile(const QString &pathToFile) const
+QStringList FileSystemEventDb::getEventfulFileListOfFolder(const QString &pathToFolder) const
 {
-    FileSystemEventDb::ItemStatus result = FileSystemEventDb::ItemStatus::Invalid;
-    QString nativePath = QDir::toNativeSeparators(pathToFile);
+    QStringList result;
+    QString folderKey = toFolderKey(pathToFolder);
 
-    bool isFileInDb = isFileExist(nativePath);
+    QReadLocker readLocker(&lock);
 
-    if(isFileInDb)
+    for(const QString &fileKey : childFileIndex.value(folderKey))
     {
-        QSqlRecord row = getFileRow(nativePath);
-        result = row.value("status").value<FileSystemEventDb::ItemStatus>();
+        if(fileTable.value(fileKey).status >= ItemStatus::NewAdded)
+            result.append(fileKey);
     }
 
+    readLocker.unlock();
+
+    result.sort();
     return result;
 }
 
-QString FileSystemEventDb::getNameOfFile(const QString &pathToFile) const
+FileMonitorSnapshot FileSystemEventDb::createSnapshot() const
 {
-    QString result = "";
+    FileMonitorSnapshot result;
 
-    QString nativePath = QDir::toNativeSeparators(pathToFile);
+    QReadLocker readLocker(&lock);
 
-    bool isFileInDb = isFileExist(nativePath);
+    QStringList rootFolders = collectMonitoredRootFolders();
+    rootFolders.append(collectMissingRootFolders());
 
-    if(isFileInDb)
+    QStack<QString> folderStack;
+    QHash<QString, qsizetype> folderEntryIndex;
+
+    for(const QString &currentRootFolderPath : rootFolders)
     {
-        QSqlRecord row = getFileRow(nativePath);
-        result = row.value("file_name").toString();
+        result.entryList.append({currentRootFolderPath, "", true, folderTable.value(currentRootFolderPath).status});
+        folderEntryIndex.insert(currentRootFolderPath, result.entryList.size() - 1);
+        folderStack.push(currentRootFolderPath);
     }
 
-    return result;
-}
+    while(!folderStack.isEmpty())
+    {
+        QString folderKey = folderStack.pop();
 
-QString FileSystemEventDb::getOldNameOfFolder(const QString &pathToFolder) const
-{
-    QString result = "";
-    QString nativePath = QDir::toNativeSeparators(pathToFolder);
+        QStringList eventfulFileList;
+        for(const QString &fileKey : childFileIndex.value(folderKey))
+        {
+            if(fileTable.value(fileKey).status >= ItemStatus::NewAdded)
+                eventfulFileList.append(fileKey);
+        }
 
-    if(!nativePath.endsWith(QDir::separator()))
-        nativePath.append(QDir::separator());
+        QStringList childFolderList = childFolderIndex.value(folderKey).values();
 
-    bool isFolderInDb = isFolderExist(nativePath);
+        eventfulFileList.sort();
+        childFolderList.sort();
 
-    if(isFolderInDb)
-    {
-        QSqlRecord row = getFolderRow(nativePath);
-        result = row.value("old_folder_name").toString();
+        for(const QString &fileKey : eventfulFileList)
+            result.entryList.append({fileKey, folderKey, false, fileTable.value(fileKey).status});
+
+        for(const QString &childFolderKey : childFolderList)
+        {
+            result.entryList.append({childFolderKey, folderKey, true, folderTable.value(childFolderKey).status});
+            folderEntryIndex.insert(childFolderKey, result.entryList.size() - 1);
+            folderStack.push(childFolderKey);
+        }
     }
 
-    return result;
-}
+    // Children come after their parent, so walking backwards marks parents after all of their children.
+    for(qsizetype index = result.entryList.size() - 1; index >= 0; --index)
+    {
+        FileMonitorSnapshot::Entry &entry = result.entryList[index];
 
-QString FileSystemEventDb::getOldNameOfFile(const QString &pathToFile) const
-{
-    QString result = "";
+        if(entry.status != ItemStatus::Monitored)
+            entry.isContainEvent = true;
 
-    QString nativePath = QDir::toNativeSeparators(pathToFile);
+        if(entry.isContainEvent && !entry.parentPath.isEmpty())
+            result.entryList[folderEntryIndex.value(entry.parentPath)].isContainEvent = true;
+    }
 
-    bool isFileInDb = isFileExist(nativePath);
+    for(const FolderRow &row : folderTable)
+    {
+        if(row.status != ItemStatus::Monitored)
+        {
+            result.isContainAnyEvent = true;
+            break;
+        }
+    }
 
-    if(isFileInDb)
+    for(auto iterator = fileTable.constBegin(); !result.isContainAnyEvent && iterator != fileTable.constEnd(); ++iterator)
     {
-        QSqlRecord row = getFileRow(nativePath);
-        result = row.value("old_file_name").toString();
+        if(iterator->status != ItemStatus::Monitored)
+            result.isContainAnyEvent = true;
     }
 
     return result;
 }
 
-QStringList FileSystemEventDb::getMonitoredFolderPathList() const
+QStringList FileSystemEventDb::getFileListByStatus(ItemStatus status) const
 {
     QStringList result;
 
-    QString queryTemplate = "SELECT * FROM Folder WHERE efsw_id IS NOT NULL;" ;
-
-    QSqlQuery query(database);
-    query.prepare(queryTemplate);
-    query.exec();
+    QReadLocker readLocker(&lock);
 
-    while(query.next())
+    for(auto iterator = fileTable.constBegin(); iterator != fileTable.constEnd(); ++iterator)
     {
-        QSqlRecord record = query.record();
-        QString item = record.value("folder_path").toString();
-        result.append(item);
+        if(iterator->status == status)
+            result.append(iterator.key());
     }
 
+    readLocker.unlock();
+
+    result.sort();
     return result;
 }
 
-QStringList FileSystemEventDb::getMonitoredRootFolderList() const
+bool FileSystemEventDb::isContainAnyFolderEvent() const
 {
-    QStringList result;
-    QString columnName = "result_column";
+    QReadLocker readLocker(&lock);
 
-    QString queryTemplate = " SELECT f1.folder_path AS %1"
-                            " FROM Folder f1 "
-                            " WHERE f1.parent_folder_path IN ("
-                            "                                   SELECT f2.folder_path "
-                            "                                   FROM Folder f2 "
-                            "                                   WHERE f2.efsw_id IS NULL"
-                            "                                 )"
-                            " AND f1.efsw_id IS NOT NULL;" ;
-
-    queryTemplate = queryTemplate.arg(columnName);
-
-    QSqlQuery query(database);
-    query.prepare(queryTemplate);
-    query.exec();
-
-    while(query.next())
+    for(const FolderRow &row : folderTable)
     {
-        QSqlRecord record = query.record();
-        QString item = record.value(columnName).toString();
-        result.append(item);
+        if(row.status != ItemStatus::Monitored)
+            return true;
     }
 
-    return result;
+    return false;
 }
 
-QStringList FileSystemEventDb::getMissingRootFolderList() const
+bool FileSystemEventDb::isContainAnyFileEvent() const
 {
-    QStringList result;
-    QString columnName = "result_column";
-
-    QString queryTemplate = " SELECT f1.folder_path AS %1"
-                            " FROM Folder f1 "
-                            " WHERE f1.parent_folder_path IN ("
-                            "                                   SELECT f2.folder_path "
-                            "                                   FROM Folder f2 "
-                            "                                   WHERE f2.efsw_id IS NULL AND f2.status = :1"
-                            "                                 )"
-                            " AND f1.efsw_id IS NULL"
-                            " AND f1.status = :2 ;" ;
-
-    queryTemplate = queryTemplate.arg(columnName);
-
-    QSqlQuery query(database);
-    query.prepare(queryTemplate);
-    query.bindValue(":1", FileSystemEventDb::ItemStatus::Monitored);
-    query.bindValue(":2", FileSystemEventDb::ItemStatus::Missing);
-    query.exec();
-
-    while(query.next())
+    QReadLocker readLocker(&lock);
+
+    for(const FileRow &row : fileTable)
     {
-        QSqlRecord record = query.record();
-        QString item = record.value(columnName).toString();
-        result.append(item);
+        if(row.status != ItemStatus::Monitored)
+            return true;
     }
 
-    return result;
+    return false;
 }
 
-QStringList FileSystemEventDb::getDirectChildFolderListOfFolder(const QString pathToFolder) const
+bool FileSystemEventDb::addMonitoringError(const QString &location, const QString &during, qlonglong error)
 {
-    QStringList result;
-
-    QString nativePath = QDir::toNativeSeparators(pathToFolder);
+    if(error < -6 || error > -1) // Only accept efsw error codes
+        return false;
 
-    if(!nativePath.endsWith(QDir::separator()))
-        nativePath.append(QDir::separator());
+    MonitoringErrorRow row;
+    row.location = location;
+    row.during = during;
+    row.errorType = error;
+    row.eventTimestamp = QDateTime::currentMSecsSinceEpoch();
 
-    QString queryTemplate = " SELECT * FROM Folder WHERE parent_folder_path = :1;" ;
+    QWriteLocker writeLocker(&lock);
 
-    QSqlQuery query(database);
-    query.prepare(queryTemplate);
-    query.bindValue(":1", nativePath);
-    query.exec();
+    monitoringErrorTable.append(row);
 
-    while(query.next())
-    {
-        QSqlRecord record = query.record();
-        QString item = record.value("folder_path").toString();
-        result.append(item);
-    }
-
-    return result;
+    return true;
 }
 
-QStringList FileSystemEventDb::getDirectChildFileListOfFolder(const QString &pathToFolder) const
+bool FileSystemEventDb::exportSnapshot(QSqlDatabase snapshotDb) const
 {
-    QStringList result;
+    if(!snapshotDb.isOpen())
+        snapshotDb.open();
 
-    QString nativePath = QDir::toNativeSeparators(pathToFolder);
+    snapshotDb.transaction();
+    snapshotDb.exec("DELETE FROM File;");
+    snapshotDb.exec("DELETE FROM Folder;");
+    snapshotDb.exec("DELETE FROM MonitoringError;");
 
-    if(!nativePath.endsWith(QDir::separator()))
-        nativePath.append(QDir::separator());
+    QReadLocker readLocker(&lock);
 
-    QString queryTemplate = " SELECT * FROM File WHERE folder_path = :1;" ;
+    QStringList folderKeyList = folderTable.keys();
 
-    QSqlQuery query(database);
-    query.prepare(queryTemplate);
-    query.bindValue(":1", nativePath);
-    query.exec();
+    // Insert parents before their children.
+    std::sort(folderKeyList.begin(), folderKeyList.end(), [](const QString &s1, const QString &s2) {
+        return s1.length() < s2.length();
+    });
 
-    while(query.next())
+    QSqlQuery folderQuery(snapshotDb);
+    folderQuery.prepare(" INSERT INTO Folder (efsw_id, folder_path, parent_folder_path, old_folder_name, status, event_timestamp)"
+                        " VALUES (:1, :2, :3, :4, :5, :6);");
+
+    for(const QString &folderKey : folderKeyList)
     {
-        QSqlRecord record = query.record();
-        QString item = record.value("file_path").toString();
-        result.append(item);
+        FolderRow row = folderTable.value(folderKey);
+
+        folderQuery.bindValue(":1", row.efswId > 0 ? QVariant((qlonglong) row.efswId) : QVariant());
+        folderQuery.bindValue(":2", folderKey);
+        folderQuery.bindValue(":3", row.parentFolderPath.isEmpty() ? QVariant() : row.parentFolderPath);
+        folderQuery.bindValue(":4", row.oldFolderName.isEmpty() ? QVariant() : row.oldFolderName);
+        folderQuery.bindValue(":5", row.status);
+        folderQuery.bindValue(":6", QDateTime::fromMSecsSinceEpoch(row.eventTimestamp));
+        folderQuery.exec();
     }
 
-    return result;
-}
+    QSqlQuery fileQuery(snapshotDb);
+    fileQuery.prepare(" INSERT INTO File (folder_path, file_name, old_file_name, status, event_timestamp)"
+                      " VALUES (:1, :2, :3, :4, :5);");
 
-QStringList FileSystemEventDb::getEventfulFileListOfFolder(const QString &pathToFolder) const
-{
-    QStringList result;
+    for(const FileRow &row : fileTable)
+    {
+        fileQuery.bindValue(":1", row.folderPath);
+        fileQuery.bindValue(":2", row.fileName);
+        fileQuery.bindValue(":3", row.oldFileName.isEmpty() ? QVariant() : row.oldFileName);
+        fileQuery.bindValue(":4", row.status);
+        fileQuery.bindValue(":5", QDateTime::fromMSecsSinceEpoch(row.eventTimestamp));
+        fileQuery.exec();
+    }
 
-    QString nativePath = QDir::toNativeSeparators(pathToFolder);
+    QSqlQuery errorQuery(snapshotDb);
+    errorQuery.prepare(" INSERT INTO MonitoringError (location, during, error_type, event_timestamp)"
+                       " VALUES (:1, :2, :3, :4);");
+
+    for(const MonitoringErrorRow &row : monitoringErrorTable)
+    {
+        errorQuery.bindValue(":1", row.location);
+        errorQuery.bindValue(":2", row.during);
+        errorQuery.bindValue(":3", row.errorType);
+        errorQuery.bindValue(":4", QDateTime::fromMSecsSinceEpoch(row.eventTimestamp));
+        errorQuery.exec();
+    }
 
-    if(!nativePath.endsWith(QDir::separator()))
-        nativePath.append(QDir::separator());
+    readLocker.unlock();
 
-    QString queryTemplate = " SELECT * FROM File WHERE folder_path = :1 AND status >= 1;" ;
+    return snapshotDb.commit();
+}
 
-    QSqlQuery query(database);
-    query.prepare(queryTemplate);
-    query.bindValue(":1", nativePath);
-    query.exec();
+QString FileSystemEventDb::toFolderKey(const QString &pathToFolder)
+{
+    QString result = QDir::toNativeSeparators(pathToFolder);
 
-    while(query.next())
-    {
-        QSqlRecord record = query.record();
-        QString item = record.value("file_path").toString();
-        result.append(item);
-    }
+    if(!result.endsWith(QDir::separator()))
+        result.append(QDir::separator());
 
     return result;
 }
 
-bool FileSystemEventDb::isContainAnyFolderEvent() const
+QString FileSystemEventDb::toFileKey(const QString &pathToFile)
 {
-    bool result = false;
+    return QDir::toNativeSeparators(pathToFile);
+}
 
-    QString columnName = "result_column";
-    QString queryTemplate = "SELECT COUNT(*) AS %1 FROM Folder WHERE status != :1;" ;
-    queryTemplate = queryTemplate.arg(columnName);
+QStringList FileSystemEventDb::collectMonitoredRootFolders()
+{
+    QStringList result;
+
+    // Watched folders which have an un-watched parent.
+    for(auto iterator = folderTable.constBegin(); iterator != folderTable.constEnd(); ++iterator)
+    {
+        if(iterator->efswId <= 0 || iterator->parentFolderPath.isEmpty())
+            continue;
 
-    QSqlQuery query(database);
-    query.prepare(queryTemplate);
-    query.bindValue(":1", ItemStatus::Monitored);
-    query.exec();
-    query.next();
+        auto parentIterator = folderTable.constFind(iterator->parentFolderPath);
 
-    int count = query.record().value(columnName).toInt();
-    if(count >= 1)
-        result = true;
+        if(parentIterator != folderTable.constEnd() && parentIterator->efswId <= 0)
+            result.append(iterator.key());
+    }
 
+    result.sort();
     return result;
 }
 
-bool FileSystemEventDb::isContainAnyFileEvent() const
+QStringList FileSystemEventDb::collectMissingRootFolders()
 {
-    bool result = false;
+    QStringList result;
 
-    QString columnName = "result_column";
-    QString queryTemplate = "SELECT COUNT(*) AS %1 FROM File WHERE status != :1;" ;
-    queryTemplate = queryTemplate.arg(columnName);
+    // Missing un-watched folders which have a monitored un-watched parent.
+    for(auto iterator = folderTable.constBegin(); iterator != folderTable.constEnd(); ++iterator)
+    {
+        if(iterator->efswId > 0 || iterator->status != ItemStatus::Missing || iterator->parentFolderPath.isEmpty())
+            continue;
 
-    QSqlQuery query(database);
-    query.prepare(queryTemplate);
-    query.bindValue(":1", ItemStatus::Monitored);
-    query.exec();
-    query.next();
+        auto parentIterator = folderTable.constFind(iterator->parentFolderPath);
 
-    int count = query.record().value(columnName).toInt();
-    if(count >= 1)
-        result = true;
+        if(parentIterator != folderTable.constEnd() &&
+           parentIterator->efswId <= 0 &&
+           parentIterator->status == ItemStatus::Monitored)
+        {
+            result.append(iterator.key());
+        }
+    }
 
+    result.sort();
     return result;
 }
 
-bool FileSystemEventDb::addMonitoringError(const QString &location, const QString &during, qlonglong error)
+QStringList FileSystemEventDb::collectFolderTree(const QString &rootFolderKey)
 {
-    bool result = false;
+    QStringList result;
+    QStack<QString> folderStack;
+    folderStack.push(rootFolderKey);
 
-    QString queryTemplate = "INSERT INTO MonitoringError (location, during, error_type, event_timestamp) "
-                            "VALUES(:1, :2, :3, :4);" ;
+    while(!folderStack.isEmpty())
+    {
+        QString folderKey = folderStack.pop();
+        result.append(folderKey);
 
-    QSqlQuery query(database);
-    query.prepare(queryTemplate);
+        for(const QString &childFolderKey : childFolderIndex.value(folderKey))
+            folderStack.push(childFolderKey);
+    }
 
-    query.bindValue(":1", location);
-    query.bindValue(":2", during);
-    query.bindValue(":3", error);
-    query.bindValue(":4", QDateTime::currentDateTime());
+    return result;
+}
 
-    query.exec();
+void FileSystemEventDb::removeFolderTree(const QString &rootFolderKey)
+{
+    QString parentFolderKey = folderTable.value(rootFolderKey).parentFolderPath;
 
-    if(query.lastError().type() == QSqlError::ErrorType::NoError)
-        result = true;
+    if(!parentFolderKey.isEmpty())
+        childFolderIndex[parentFolderKey].remove(rootFolderKey);
 
-    return result;
+    for(const QString &folderKey : collectFolderTree(rootFolderKey))
+    {
+        for(const QString &fileKey : childFileIndex.value(folderKey))
+            fileTable.remove(fileKey);
 
+        folderTable.remove(folderKey);
+        childFileIndex.remove(folderKey);
+        childFolderIndex.remove(folderKey);
+    }
 }
 
-QSqlRecord FileSystemEventDb::getFolderRow(const QString &pathToFolder) const
+// Renames the folder with all of its sub folders and files, like ON UPDATE CASCADE would do.
+void FileSystemEventDb::renameFolderTree(const QString &oldRootFolderKey, const QString &newRootFolderKey)
 {
-    QString queryTemplate = "SELECT * FROM Folder WHERE folder_path = :1;" ;
+    auto renamed = [&oldRootFolderKey, &newRootFolderKey](const QString &key) {
+        return newRootFolderKey + key.mid(oldRootFolderKey.length());
+    };
 
-    QSqlQuery query(database);
-    query.prepare(queryTemplate);
+    QString parentFolderKey = folderTable.value(oldRootFolderKey).parentFolderPath;
 
-    query.bindValue(":1", pathToFolder);
-    query.exec();
-    query.next();
+    if(!parentFolderKey.isEmpty())
+    {
+        QSet<QString> &siblingFolders = childFolderIndex[parentFolderKey];
+        siblingFolders.remove(oldRootFolderKey);
+        siblingFolders.insert(newRootFolderKey);
+    }
 
-    return query.record();
-}
+    for(const QString &folderKey : collectFolderTree(oldRootFolderKey))
+    {
+        QString newFolderKey = renamed(folderKey);
+        FolderRow row = folderTable.take(folderKey);
 
-QSqlRecord FileSystemEventDb::getFileRow(const QString &pathToFile) const
-{
-    QString queryTemplate = "SELECT * FROM File WHERE file_path = :1;" ;
+        if(folderKey != oldRootFolderKey)
+            row.parentFolderPath = renamed(row.parentFolderPath);
+
+        QSet<QString> newChildFolders;
+        for(const QString &childFolderKey : childFolderIndex.take(folderKey))
+            newChildFolders.insert(renamed(childFolderKey));
+
+        QSet<QString> newChildFiles;
+        for(const QString &childFileKey : childFileIndex.take(folderKey))
+        {
+            FileRow fileRow = fileTable.take(childFileKey);
+            fileRow.folderPath = newFolderKey;
+
+            QString newFileKey = newFolderKey + fileRow.fileName;
+            fileTable.insert(newFileKey, fileRow);
+            newChildFiles.insert(newFileKey);
+        }
 
-    QSqlQuery query(database);
-    query.prepare(queryTemplate);
+        if(!newChildFolders.isEmpty())
+            childFolderIndex.insert(newFolderKey, newChildFolders);
 
-    query.bindValue(":1", pathToFile);
-    query.exec();
-    query.next();
+        if(!newChildFiles.isEmpty())
+            childFileIndex.insert(newFolderKey, newChildFiles);
 
-    return query.record();
+        folderTable.insert(newFolderKey, row);
+    }
 }
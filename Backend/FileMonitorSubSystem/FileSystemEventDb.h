@@ -2,8 +2,16 @@
 #define FILESYSTEMEVENTDB_H
 
 #include "efsw/efsw.hpp"
+
+#include <QSet>
+#include <QHash>
 #include <QSqlDatabase>
+#include <QReadWriteLock>
+
+struct FileMonitorSnapshot;
 
+// All instances share the same process-wide, in-memory event store.
+// Every public function takes the store lock once, so calls are safe from any thread.
 class FileSystemEventDb
 {
 public:
@@ -18,7 +26,7 @@ public:
         Missing = 5
     };
 
-    FileSystemEventDb(const QSqlDatabase &eventDb);
+    FileSystemEventDb();
     ~FileSystemEventDb();
 
     bool isFolderExist(const QString &pathToFolder) const;
@@ -47,16 +55,60 @@ public:
     QStringList getDirectChildFolderListOfFolder(const QString pathToFolder) const;
     QStringList getDirectChildFileListOfFolder(const QString &pathToFolder) const;
     QStringList getEventfulFileListOfFolder(const QString &pathToFolder) const;
+    QStringList getFileListByStatus(ItemStatus status) const;
     bool isContainAnyFolderEvent() const;
     bool isContainAnyFileEvent() const;
     bool addMonitoringError(const QString &location, const QString &during, qlonglong error);
 
+    // Consistent copy of the monitored tree, taken under a single lock.
+    FileMonitorSnapshot createSnapshot() const;
+
+    // Copies current content of the store into Folder, File and MonitoringError tables of snapshotDb.
+    bool exportSnapshot(QSqlDatabase snapshotDb) const;
+
 private:
-    QSqlDatabase database;
+    struct FolderRow
+    {
+        QString parentFolderPath;
+        QString oldFolderName;
+        efsw::WatchID efswId = 0;
+        ItemStatus status = ItemStatus::Monitored;
+        qint64 eventTimestamp = 0;
+    };
+
+    struct FileRow
+    {
+        QString folderPath;
+        QString fileName;
+        QString oldFileName;
+        ItemStatus status = ItemStatus::Monitored;
+        qint64 eventTimestamp = 0;
+    };
+
+    struct MonitoringErrorRow
+    {
+        QString location;
+        QString during;
+        qlonglong errorType = 0;
+        qint64 eventTimestamp = 0;
+    };
+
+    static QString toFolderKey(const QString &pathToFolder);
+    static QString toFileKey(const QString &pathToFile);
+
+    // Functions below expect the caller to hold the lock.
+    static QStringList collectMonitoredRootFolders();
+    static QStringList collectMissingRootFolders();
+    static QStringList collectFolderTree(const QString &rootFolderKey);
+    static void removeFolderTree(const QString &rootFolderKey);
+    static void renameFolderTree(const QString &oldRootFolderKey, const QString &newRootFolderKey);
 
-    QSqlRecord getFolderRow(const QString &pathToFolder) const;
-    QSqlRecord getFileRow(const QString &pathToFile) const;
-    void createDb();
+    static QReadWriteLock lock;
+    static QHash<QString, FolderRow> folderTable;
+    static QHash<QString, FileRow> fileTable;
+    static QHash<QString, QSet<QString>> childFolderIndex;
+    static QHash<QString, QSet<QString>> childFileIndex;
+    static QList<MonitoringErrorRow> monitoringErrorTable;
 };
 
 #endif // FILESYSTEMEVENTDB_H
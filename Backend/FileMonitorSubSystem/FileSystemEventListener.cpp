@@ -1,11 +1,21 @@
 #include "FileSystemEventListener.h"
 
-#include <iostream>
+#include "Utility/Logger.h"
 
 FileSystemEventListener::FileSystemEventListener(QObject *parent)
     : QObject{parent}
 {
+    eventCoalescer = nullptr;
+}
+
+FileSystemEventCoalescer *FileSystemEventListener::getEventCoalescer() const
+{
+    return eventCoalescer;
+}
 
+void FileSystemEventListener::setEventCoalescer(FileSystemEventCoalescer *newEventCoalescer)
+{
+    eventCoalescer = newEventCoalescer;
 }
 
 void FileSystemEventListener::handleFileAction(efsw::WatchID watchid,
@@ -14,33 +24,23 @@ void FileSystemEventListener::handleFileAction(efsw::WatchID watchid,
                                                efsw::Action action,
                                                std::string oldFilename)
 {
-    auto _dir = QString::fromStdString(dir);
-    auto _fileName = QString::fromStdString(filename);
-    auto _oldFileName = QString::fromStdString(oldFilename);
+    // When monitoring paused, events are dropped here like blocked signals were.
+    if(eventCoalescer == nullptr || signalsBlocked())
+        return;
 
     switch( action )
     {
     case efsw::Actions::Add:
-        std::cout << "DIR (" << dir << ") FILE (" << filename << ") has event Added" << std::endl;
-        emit signalAddEventDetected(_fileName, _dir);
-        break;
-
     case efsw::Actions::Delete:
-        std::cout << "DIR (" << dir << ") FILE (" << filename << ") has event Delete" << std::endl;
-        emit signalDeleteEventDetected(_fileName, _dir);
-        break;
-
     case efsw::Actions::Modified:
-        std::cout << "DIR (" << dir << ") FILE (" << filename << ") has event Modified" << std::endl;
-        emit signalModificationEventDetected(_fileName, _dir);
-        break;
-
     case efsw::Actions::Moved:
-        std::cout << "DIR (" << dir << ") FILE (" << filename << ") has event Moved from (" << oldFilename << ")" << std::endl;
-        emit signalMoveEventDetected(_fileName, _oldFileName, _dir);
+        eventCoalescer->addEvent(action,
+                                 QString::fromStdString(dir),
+                                 QString::fromStdString(filename),
+                                 QString::fromStdString(oldFilename));
         break;
 
     default:
-        std::cout << "Should never happen!" << std::endl;
+        LOG_WARNING("FileMonitor", "Should never happen!");
     }
 }
@@ -4,17 +4,16 @@
 #include <QObject>
 #include <efsw/efsw.hpp>
 
+#include "Backend/FileMonitorSubSystem/FileSystemEventCoalescer.h"
+
 class FileSystemEventListener : public QObject, public efsw::FileWatchListener
 {
     Q_OBJECT
 public:
     explicit FileSystemEventListener(QObject *parent = nullptr);
 
-signals:
-    void signalAddEventDetected(const QString &fileName, const QString &dir);
-    void signalDeleteEventDetected(const QString &fileName, const QString &dir);
-    void signalModificationEventDetected(const QString &fileName, const QString &dir);
-    void signalMoveEventDetected(const QString &newFileName, const QString &oldFileName, const QString &dir);
+    FileSystemEventCoalescer *getEventCoalescer() const;
+    void setEventCoalescer(FileSystemEventCoalescer *newEventCoalescer);
 
     // FileWatchListener interface
 public:
@@ -23,6 +22,9 @@ public:
                           const std::string &filename,
                           efsw::Action action,
                           std::string oldFilename) override;
+
+private:
+    FileSystemEventCoalescer *eventCoalescer;
 };
 
 #endif // FILESYSTEMEVENTLISTENER
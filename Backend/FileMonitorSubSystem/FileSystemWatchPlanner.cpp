@@ -0,0 +1,350 @@
+#include "FileSystemWatchPlanner.h"
+
+#include "Utility/Logger.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QDateTime>
+
+FileSystemWatchPlanner::FileSystemWatchPlanner(efsw::FileWatcher *fileWatcher, efsw::FileWatchListener *listener)
+{
+    this->fileWatcher = fileWatcher;
+    this->listener = listener;
+    isRecursive = isRecursiveWatchSupported();
+    watchLimit = kernelWatchLimit();
+    watchBudget = (watchLimit > 0) ? watchLimit * WatchBudgetPercent / 100 : -1;
+    isBudgetReachedLogged = false;
+    pollCursor = 0;
+}
+
+bool FileSystemWatchPlanner::isRecursiveWatchSupported()
+{
+    // ReadDirectoryChangesW and FSEvents watch whole trees with a single handle,
+    // inotify needs one watch per folder even when efsw emulates recursion.
+#if defined(Q_OS_WIN) || defined(Q_OS_MACOS)
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool FileSystemWatchPlanner::isRecursiveMode() const
+{
+    return isRecursive;
+}
+
+efsw::WatchID FileSystemWatchPlanner::watchFolder(const QString &pathToFolder)
+{
+    QString folderKey = toFolderKey(pathToFolder);
+
+    if(ownedWatchTable.contains(folderKey))
+        return ownedWatchTable.value(folderKey);
+
+    if(polledFolderTable.contains(folderKey))
+        return PolledFolderId;
+
+    if(isRecursive)
+    {
+        QString rootKey = findCoveringRoot(folderKey);
+
+        if(!rootKey.isEmpty())
+            return ownedWatchTable.value(rootKey);
+
+        return addOwnedWatch(folderKey);
+    }
+
+    if(isWatchBudgetFull())
+    {
+        startPolling(folderKey, listFolder(folderKey));
+        return PolledFolderId;
+    }
+
+    efsw::WatchID result = addOwnedWatch(folderKey);
+
+    // Kernel limit is hit before the budget when other applications use many watches.
+    QFileInfo info(folderKey);
+
+    if(result <= 0 && info.isDir() && info.isReadable())
+    {
+        startPolling(folderKey, listFolder(folderKey));
+        result = PolledFolderId;
+    }
+
+    return result;
+}
+
+void FileSystemWatchPlanner::unwatchFolderTree(const QString &pathToFolder)
+{
+    QString folderKey = toFolderKey(pathToFolder);
+
+    for(auto iterator = ownedWatchTable.begin(); iterator != ownedWatchTable.end();)
+    {
+        if(iterator.key().startsWith(folderKey))
+        {
+            fileWatcher->removeWatch(iterator.value());
+            lastActivityTable.remove(iterator.key());
+            iterator = ownedWatchTable.erase(iterator);
+        }
+        else
+            ++iterator;
+    }
+
+    for(auto iterator = polledFolderTable.begin(); iterator != polledFolderTable.end();)
+    {
+        if(iterator.key().startsWith(folderKey))
+        {
+            pollQueue.removeOne(iterator.key());
+            iterator = polledFolderTable.erase(iterator);
+        }
+        else
+            ++iterator;
+    }
+}
+
+bool FileSystemWatchPlanner::isCoveredByRecursiveWatch(const QString &pathToFolder) const
+{
+    if(!isRecursive)
+        return false;
+
+    return !findCoveringRoot(toFolderKey(pathToFolder)).isEmpty();
+}
+
+void FileSystemWatchPlanner::pollFolders()
+{
+    QStringList changedFolderList;
+    int folderCount = qMin((qsizetype) MaxPolledFoldersPerPass, pollQueue.size());
+
+    for(int index = 0; index < folderCount; index++)
+    {
+        if(pollCursor >= pollQueue.size())
+            pollCursor = 0;
+
+        QString folderKey = pollQueue.at(pollCursor);
+        ++pollCursor;
+
+        if(pollFolder(folderKey))
+            changedFolderList.append(folderKey);
+    }
+
+    for(const QString &folderKey : changedFolderList)
+        promoteToWatch(folderKey);
+}
+
+void FileSystemWatchPlanner::recordActivity(const QString &pathToFolder)
+{
+    QString folderKey = toFolderKey(pathToFolder);
+
+    if(ownedWatchTable.contains(folderKey))
+        lastActivityTable.insert(folderKey, QDateTime::currentMSecsSinceEpoch());
+}
+
+int FileSystemWatchPlanner::activeWatchCount() const
+{
+    return ownedWatchTable.size();
+}
+
+int FileSystemWatchPlanner::polledFolderCount() const
+{
+    return polledFolderTable.size();
+}
+
+qlonglong FileSystemWatchPlanner::kernelWatchLimit()
+{
+    qlonglong result = -1;
+
+#ifdef Q_OS_LINUX
+    QFile file("/proc/sys/fs/inotify/max_user_watches");
+
+    if(file.open(QFile::OpenModeFlag::ReadOnly))
+    {
+        bool isNumber = false;
+        qlonglong limit = file.readAll().trimmed().toLongLong(&isNumber);
+
+        if(isNumber)
+            result = limit;
+    }
+#endif
+
+    return result;
+}
+
+QString FileSystemWatchPlanner::usageReport() const
+{
+    QString result = "mode = %1, watches = %2, polled folders = %3, kernel watch limit = %4";
+
+    QString mode = isRecursive ? "recursive" : "per folder";
+    QString strLimit = (watchLimit > 0) ? QString::number(watchLimit) : "n/a";
+
+    return result.arg(mode).arg(activeWatchCount()).arg(polledFolderCount()).arg(strLimit);
+}
+
+QString FileSystemWatchPlanner::toFolderKey(const QString &pathToFolder)
+{
+    QString result = QDir::toNativeSeparators(pathToFolder);
+
+    if(!result.endsWith(QDir::separator()))
+        result.append(QDir::separator());
+
+    return result;
+}
+
+QString FileSystemWatchPlanner::findCoveringRoot(const QString &folderKey) const
+{
+    for(auto iterator = ownedWatchTable.constBegin(); iterator != ownedWatchTable.constEnd(); ++iterator)
+    {
+        if(folderKey.startsWith(iterator.key()))
+            return iterator.key();
+    }
+
+    return "";
+}
+
+QString FileSystemWatchPlanner::findIdlestWatchedFolder() const
+{
+    QString result;
+    qint64 idleSince = QDateTime::currentMSecsSinceEpoch() - MinIdleMsecsBeforeEviction;
+
+    for(auto iterator = lastActivityTable.constBegin(); iterator != lastActivityTable.constEnd(); ++iterator)
+    {
+        if(iterator.value() < idleSince)
+        {
+            result = iterator.key();
+            idleSince = iterator.value();
+        }
+    }
+
+    return result;
+}
+
+FileSystemWatchPlanner::FolderListing FileSystemWatchPlanner::listFolder(const QString &folderKey)
+{
+    FolderListing result;
+
+    QDir dir(folderKey);
+    dir.setFilter(QDir::Filter::AllEntries | QDir::Filter::NoDotAndDotDot | QDir::Filter::Hidden);
+
+    for(const QFileInfo &info : dir.entryInfoList())
+    {
+        PolledEntry entry;
+        entry.isDir = info.isDir();
+        entry.size = info.size();
+        entry.modifiedMsecs = info.lastModified().toMSecsSinceEpoch();
+
+        result.insert(info.fileName(), entry);
+    }
+
+    return result;
+}
+
+bool FileSystemWatchPlanner::isWatchBudgetFull() const
+{
+    return watchBudget > 0 && activeWatchCount() >= watchBudget;
+}
+
+efsw::WatchID FileSystemWatchPlanner::addOwnedWatch(const QString &folderKey)
+{
+    efsw::WatchID result = fileWatcher->addWatch(folderKey.toStdString(), listener, isRecursive);
+
+    if(result > 0)
+    {
+        ownedWatchTable.insert(folderKey, result);
+        lastActivityTable.insert(folderKey, QDateTime::currentMSecsSinceEpoch());
+
+        if(isRecursive)
+            dropCoveredWatches(folderKey);
+    }
+
+    return result;
+}
+
+// Sub folders watched before their parent are covered by the parent now, their watches would report each event twice.
+void FileSystemWatchPlanner::dropCoveredWatches(const QString &rootKey)
+{
+    for(auto iterator = ownedWatchTable.begin(); iterator != ownedWatchTable.end();)
+    {
+        if(iterator.key() != rootKey && iterator.key().startsWith(rootKey))
+        {
+            fileWatcher->removeWatch(iterator.value());
+            lastActivityTable.remove(iterator.key());
+            iterator = ownedWatchTable.erase(iterator);
+        }
+        else
+            ++iterator;
+    }
+}
+
+void FileSystemWatchPlanner::startPolling(const QString &folderKey, const FolderListing &listing)
+{
+    if(!isBudgetReachedLogged)
+    {
+        isBudgetReachedLogged = true;
+        LOG_WARNING("FileMonitor", QString("%1 watches are used, further folders are polled every %2 ms."
+                                           " Raise fs.inotify.max_user_watches to watch more folders").arg(activeWatchCount())
+                                                                                                      .arg(PollIntervalMs));
+    }
+
+    polledFolderTable.insert(folderKey, listing);
+    pollQueue.append(folderKey);
+}
+
+bool FileSystemWatchPlanner::pollFolder(const QString &folderKey)
+{
+    bool result = false;
+
+    FolderListing previous = polledFolderTable.value(folderKey);
+    FolderListing current = listFolder(folderKey);
+    std::string dir = folderKey.toStdString();
+
+    for(auto iterator = current.constBegin(); iterator != current.constEnd(); ++iterator)
+    {
+        auto previousEntry = previous.constFind(iterator.key());
+        std::string fileName = iterator.key().toStdString();
+
+        if(previousEntry == previous.constEnd())
+        {
+            listener->handleFileAction(PolledFolderId, dir, fileName, efsw::Actions::Add, "");
+            result = true;
+        }
+        else if(!iterator->isDir && (iterator->size != previousEntry->size || iterator->modifiedMsecs != previousEntry->modifiedMsecs))
+        {
+            listener->handleFileAction(PolledFolderId, dir, fileName, efsw::Actions::Modified, "");
+            result = true;
+        }
+    }
+
+    for(auto iterator = previous.constBegin(); iterator != previous.constEnd(); ++iterator)
+    {
+        if(!current.contains(iterator.key()))
+        {
+            listener->handleFileAction(PolledFolderId, dir, iterator.key().toStdString(), efsw::Actions::Delete, "");
+            result = true;
+        }
+    }
+
+    polledFolderTable.insert(folderKey, current);
+
+    return result;
+}
+
+void FileSystemWatchPlanner::promoteToWatch(const QString &folderKey)
+{
+    if(isWatchBudgetFull())
+    {
+        QString idleFolderKey = findIdlestWatchedFolder();
+
+        if(idleFolderKey.isEmpty()) // Every watched folder is busy, keep polling
+            return;
+
+        // Listed before its watch is removed, changes in between are reported twice instead of being lost.
+        startPolling(idleFolderKey, listFolder(idleFolderKey));
+        fileWatcher->removeWatch(ownedWatchTable.take(idleFolderKey));
+        lastActivityTable.remove(idleFolderKey);
+    }
+
+    if(addOwnedWatch(folderKey) > 0)
+    {
+        polledFolderTable.remove(folderKey);
+        pollQueue.removeOne(folderKey);
+    }
+}
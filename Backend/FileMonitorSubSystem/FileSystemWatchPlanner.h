@@ -0,0 +1,94 @@
+#ifndef FILESYSTEMWATCHPLANNER_H
+#define FILESYSTEMWATCHPLANNER_H
+
+#include <limits>
+
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <efsw/efsw.hpp>
+
+// Decides which efsw watches are needed to cover monitored folders.
+// When the platform backend watches trees natively, one recursive watch covers a whole folder tree.
+// Otherwise (linux) every folder needs a watch of its own. Only a share of the kernel limit is used,
+// folders beyond it are polled, and a polled folder which changes takes the watch of the folder idle for longest.
+class FileSystemWatchPlanner
+{
+public:
+    // Watches are shared with other applications of the user, at most this share of the kernel limit is used.
+    static const inline int WatchBudgetPercent = 50;
+
+    // Every interval the next MaxPolledFoldersPerPass polled folders are listed again.
+    static const inline int PollIntervalMs = 2000;
+    static const inline int MaxPolledFoldersPerPass = 256;
+
+    // Watch of a folder changed within this time isn't given away.
+    static const inline qint64 MinIdleMsecsBeforeEviction = 60000;
+
+    // Returned for folders which are polled instead of watched.
+    static const inline efsw::WatchID PolledFolderId = std::numeric_limits<efsw::WatchID>::max();
+
+    FileSystemWatchPlanner(efsw::FileWatcher *fileWatcher, efsw::FileWatchListener *listener);
+
+    static bool isRecursiveWatchSupported();
+
+    bool isRecursiveMode() const;
+
+    // Returns id of the watch covering the folder, PolledFolderId or efsw error code when folder can't be watched.
+    efsw::WatchID watchFolder(const QString &pathToFolder);
+
+    // Removes watches owned by the folder or its sub folders and stops polling them.
+    void unwatchFolderTree(const QString &pathToFolder);
+
+    bool isCoveredByRecursiveWatch(const QString &pathToFolder) const;
+
+    // Reports changes of polled folders to the listener like efsw does, then moves changed ones to watches.
+    void pollFolders();
+
+    // Folders with recent events keep their watches when the budget is full.
+    void recordActivity(const QString &pathToFolder);
+
+    int activeWatchCount() const;
+    int polledFolderCount() const;
+
+    // Per user inotify watch limit on linux, -1 when not applicable.
+    static qlonglong kernelWatchLimit();
+
+    QString usageReport() const;
+
+private:
+    struct PolledEntry
+    {
+        bool isDir = false;
+        qint64 size = 0;
+        qint64 modifiedMsecs = 0;
+    };
+
+    using FolderListing = QHash<QString, PolledEntry>;
+
+    static QString toFolderKey(const QString &pathToFolder);
+    static FolderListing listFolder(const QString &folderKey);
+    QString findCoveringRoot(const QString &folderKey) const;
+    QString findIdlestWatchedFolder() const;
+    bool isWatchBudgetFull() const;
+
+    efsw::WatchID addOwnedWatch(const QString &folderKey);
+    void dropCoveredWatches(const QString &rootKey);
+    void startPolling(const QString &folderKey, const FolderListing &listing);
+    bool pollFolder(const QString &folderKey);
+    void promoteToWatch(const QString &folderKey);
+
+    efsw::FileWatcher *fileWatcher;
+    efsw::FileWatchListener *listener;
+    bool isRecursive;
+    qlonglong watchLimit;
+    qlonglong watchBudget; // -1 when unlimited
+    bool isBudgetReachedLogged;
+    qsizetype pollCursor;
+    QHash<QString, efsw::WatchID> ownedWatchTable;
+    QHash<QString, qint64> lastActivityTable;
+    QHash<QString, FolderListing> polledFolderTable;
+    QStringList pollQueue;
+};
+
+#endif // FILESYSTEMWATCHPLANNER_H
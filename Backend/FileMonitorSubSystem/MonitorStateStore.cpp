@@ -0,0 +1,109 @@
+#include "MonitorStateStore.h"
+
+#include "Utility/DatabaseRegistry.h"
+
+#include <QSqlQuery>
+#include <QSqlError>
+
+MonitorStateStore::MonitorStateStore()
+{
+    database = DatabaseRegistry::monitorStateDatabase();
+}
+
+QHash<QString, MonitorStateStore::PathState> MonitorStateStore::load() const
+{
+    QHash<QString, PathState> result;
+
+    QString queryTemplate = "SELECT * FROM MonitorState;" ;
+
+    QSqlQuery query(database);
+    query.setForwardOnly(true);
+    query.prepare(queryTemplate);
+    query.exec();
+
+    while(query.next())
+    {
+        PathState state;
+        state.size = query.value("size").toLongLong();
+        state.modifiedNsecs = query.value("modified_timestamp").toLongLong();
+        state.inode = query.value("inode").toULongLong();
+        state.versionNumber = query.value("version_number").toLongLong();
+        state.versionHash = query.value("version_hash").toString();
+
+        result.insert(query.value("path").toString(), state);
+    }
+
+    return result;
+}
+
+bool MonitorStateStore::save(const QHash<QString, PathState> &stateTable)
+{
+    bool result = false;
+
+    database.transaction();
+    database.exec("DELETE FROM MonitorState;");
+
+    QString queryTemplate = "INSERT INTO MonitorState (path, size, modified_timestamp, inode, version_number, version_hash)"
+                            " VALUES (:1, :2, :3, :4, :5, :6);" ;
+
+    QSqlQuery query(database);
+    query.prepare(queryTemplate);
+
+    for(auto iterator = stateTable.constBegin(); iterator != stateTable.constEnd(); ++iterator)
+    {
+        query.bindValue(":1", iterator.key());
+        query.bindValue(":2", iterator->size);
+        query.bindValue(":3", iterator->modifiedNsecs);
+        query.bindValue(":4", (qlonglong) iterator->inode);
+        query.bindValue(":5", iterator->versionNumber);
+        query.bindValue(":6", iterator->versionHash);
+
+        query.exec();
+
+        if(query.lastError().type() != QSqlError::ErrorType::NoError)
+        {
+            database.rollback();
+            return false;
+        }
+    }
+
+    result = database.commit();
+
+    return result;
+}
+
+MonitorStateStore::PathState MonitorStateStore::readPathState(const QString &pathToFile)
+{
+    return stateOf(FileStat::read(pathToFile));
+}
+
+MonitorStateStore::PathState MonitorStateStore::stateOf(const FileStat &stat)
+{
+    PathState result;
+
+    result.size = stat.size;
+    result.modifiedNsecs = stat.modifiedNsecs;
+    result.inode = stat.inode;
+
+    return result;
+}
+
+bool MonitorStateStore::isUnchanged(const PathState &savedState, const PathState &currentState)
+{
+    if(currentState.size < 0)
+        return false;
+
+    return savedState.size == currentState.size &&
+           savedState.modifiedNsecs == currentState.modifiedNsecs &&
+           savedState.inode == currentState.inode;
+}
+
+// Versions appended or deleted since the state was saved make the file differ from its latest version.
+bool MonitorStateStore::isSameVersion(const PathState &savedState, const FileVersionRecord &latestVersion)
+{
+    if(!latestVersion.isExist)
+        return false;
+
+    return savedState.versionNumber == latestVersion.versionNumber &&
+           savedState.versionHash == latestVersion.hash;
+}
@@ -0,0 +1,42 @@
+#ifndef MONITORSTATESTORE_H
+#define MONITORSTATESTORE_H
+
+#include "Utility/FileStat.h"
+#include "FileStorageSubSystem/StorageRecords.h"
+
+#include <QHash>
+#include <QSqlDatabase>
+
+// Persists last seen size, modification time and inode of unchanged monitored files between launches,
+// together with the stored version they matched. A state is only reused while that version is still the latest one.
+class MonitorStateStore
+{
+public:
+    struct PathState
+    {
+        qint64 size = -1;
+        qint64 modifiedNsecs = 0; // Since epoch
+        quint64 inode = 0;            // 0 when platform doesn't provide it
+        qlonglong versionNumber = 0;
+        QString versionHash;
+    };
+
+    MonitorStateStore();
+
+    QHash<QString, PathState> load() const;
+
+    // Replaces whole stored state with stateTable.
+    bool save(const QHash<QString, PathState> &stateTable);
+
+    // Returns state with size -1 when path isn't a file.
+    static PathState readPathState(const QString &pathToFile);
+    static PathState stateOf(const FileStat &stat);
+
+    static bool isUnchanged(const PathState &savedState, const PathState &currentState);
+    static bool isSameVersion(const PathState &savedState, const FileVersionRecord &latestVersion);
+
+private:
+    QSqlDatabase database;
+};
+
+#endif // MONITORSTATESTORE_H
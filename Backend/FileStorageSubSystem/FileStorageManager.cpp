@@ -1,18 +1,30 @@
 #include "FileStorageManager.h"
 
+#include "FileHasher.h"
+
 #include "Utility/AppConfig.h"
+#include "Utility/FileStat.h"
+#include "Utility/FileCopier.h"
 #include "Utility/JsonDtoFormat.h"
+#include "Utility/StorageLayout.h"
+#include "Utility/JobScheduler.h"
+#include "Utility/StorageUnlinkJob.h"
+#include "Utility/StorageWriteActor.h"
 #include "Utility/DatabaseRegistry.h"
 
 #include <QDir>
+#include <QBuffer>
+#include <QHash>
 #include <QUuid>
+#include <QDateTime>
 #include <QJsonArray>
 #include <QStandardPaths>
-#include <QCryptographicHash>
 
 FileStorageManager::FileStorageManager(const QSqlDatabase &db, const QString &backupFolderPath)
 {
     setStorageFolderPath(backupFolderPath);
+    setHashAlgorithm(FileHasher::DefaultAlgorithm);
+    setInlineFileSizeLimit(0);
     database = db;
 
     if(!database.isOpen())
@@ -29,6 +41,8 @@ QSharedPointer<FileStorageManager> FileStorageManager::instance()
     QSqlDatabase storageDb = DatabaseRegistry::fileStorageDatabase();
 
     auto *rawPtr = new FileStorageManager(storageDb, config.getStorageFolderPath());
+    rawPtr->setHashAlgorithm(config.getHashAlgorithm());
+    rawPtr->setInlineFileSizeLimit(config.getInlineFileSizeLimit());
     auto result = QSharedPointer<FileStorageManager>(rawPtr);
 
     return result;
@@ -75,32 +89,34 @@ bool FileStorageManager::addNewFolder(const QString &symbolFolderPath, const QSt
             currentToken.append(separator);
 
         QString parentSymbolFolderPath = "";
-        QString suffixPath = "";
+        QList<FolderEntity> entityList;
 
+        // Whole chain goes in one statement, parents which already exist are left as they are by the database.
         for(const QString &currentToken : tokenList)
         {
-            suffixPath = currentToken;
-            QString currentSymbolFolder = parentSymbolFolderPath + suffixPath;
-            FolderEntity entity = folderRepository->findBySymbolPath(currentSymbolFolder);
-
-            if(!entity.isExist())
+            if(!parentSymbolFolderPath.isEmpty()) // Root folder always exists
             {
+                FolderEntity entity;
                 entity.parentFolderPath = parentSymbolFolderPath;
-                entity.suffixPath = suffixPath;
+                entity.suffixPath = currentToken;
                 entity.userFolderPath = "";
                 entity.isFrozen = true;
 
                 if(isUserFolderExist && !_userFolderPath.isEmpty())
                     entity.isFrozen = false;
 
-                if(currentSymbolFolder == _symbolFolderPath)
+                if(parentSymbolFolderPath + currentToken == _symbolFolderPath)
                     entity.userFolderPath = _userFolderPath;
 
-                result = folderRepository->save(entity);
+                entityList.append(entity);
             }
 
-            parentSymbolFolderPath.append(suffixPath);
+            parentSymbolFolderPath.append(currentToken);
         }
+
+        result = StorageWriteActor::instance()->execute([&](QSqlDatabase &writeDb) {
+            return FolderRepository(writeDb).saveAll(entityList);
+        });
     }
 
     return result;
@@ -134,16 +150,20 @@ bool FileStorageManager::addNewFile(const QString &symbolFolderPath,
         return false;
 
     QString symbolFilePath = folderEntity.symbolFolderPath() + _fileName;
-    FileEntity fileEntity = fileRepository->findBySymbolPath(symbolFilePath);
 
-    if(fileEntity.isExist()) // Symbol folder is already exist
+    // Save upserts, so an existing file would be overwritten instead of being rejected.
+    if(fileRepository->findBySymbolPath(symbolFilePath).isExist())
         return false;
 
+    FileEntity fileEntity;
+
     fileEntity.fileName = _fileName;
     fileEntity.symbolFolderPath = folderEntity.symbolFolderPath();
     fileEntity.isFrozen = isFrozen;
 
-    bool isFileInserted = fileRepository->save(fileEntity);
+    bool isFileInserted = StorageWriteActor::instance()->execute([&](QSqlDatabase &writeDb) {
+        return FileRepository(writeDb).save(fileEntity);
+    });
 
     if(!isFileInserted)
         return false;
@@ -164,42 +184,88 @@ bool FileStorageManager::appendVersion(const QString &symbolFilePath, const QStr
     if(!fileEntity.isExist())
         return false;
 
-    qlonglong versionNumber = fileVersionRepository->maxVersionNumber(fileEntity.symbolFilePath());
+    FileStat stat = FileStat::read(pathToFile);
 
-    if(versionNumber <= 0)
-        versionNumber = 1;
-    else
-        versionNumber += 1;
+    if(stat.size < 0)
+        return false;
 
-    QFile file(pathToFile);
     QString internalFileName = generateRandomFileName();
-    QString generatedFilePath = getStorageFolderPath() + internalFileName;
-    bool isCopied = file.copy(generatedFilePath);
+    QString packFileName;
+    qint64 packOffset = -1;
+    QByteArray inlineContent;
+    QString fileHash;
+    bool isInline = false;
+    bool isCopied = false;
+
+    if(stat.size < PackStore::MaxPackedFileSize)
+    {
+        QFile sourceFile(pathToFile);
 
-    if(!isCopied)
-        return false;
+        if(sourceFile.open(QFile::OpenModeFlag::ReadOnly))
+        {
+            QByteArray data = sourceFile.readAll();
 
-    bool isOpen = file.open(QFile::OpenModeFlag::ReadOnly);
+            // Hash describes the stored bytes even when file changes after this read.
+            fileHash = FileHasher::hashData(data, getHashAlgorithm());
 
-    if(!isOpen)
-        return false;
+            // Recorded size and timestamps must describe the read bytes, so a file changed during the read is rejected.
+            if(data.size() != stat.size || !isSameStat(stat, FileStat::read(pathToFile)))
+                isCopied = false;
+            // Tiny versions are written to database together with their row.
+            else if(data.size() < getInlineFileSizeLimit())
+            {
+                inlineContent = data;
+                isInline = true;
+                isCopied = true;
+            }
+            else
+                isCopied = PackStore(getStorageFolderPath()).append(data, packFileName, packOffset, IoScheduler::Budget::Background);
+        }
+    }
+    else
+    {
+        QString generatedFilePath = StorageLayout::prepareFilePath(getStorageFolderPath(), internalFileName);
+        isCopied = FileCopier::copyFile(pathToFile, generatedFilePath, IoScheduler::Budget::Background);
 
-    QCryptographicHash hasher(QCryptographicHash::Algorithm::Sha3_256);
-    hasher.addData(&file);
-    QString fileHash = QString(hasher.result().toHex());
+        // Copy is hashed instead of the source, which may have changed since it was copied.
+        if(isCopied)
+            fileHash = FileHasher::hashFile(generatedFilePath, getHashAlgorithm());
 
-    file.close();
+        // Like above, a file changed during the copy is rejected.
+        if(isCopied && !isSameStat(stat, FileStat::read(pathToFile)))
+        {
+            QFile::remove(generatedFilePath);
+            isCopied = false;
+        }
+    }
+
+    if(!isCopied)
+        return false;
+
+    if(fileHash.isEmpty())
+        return false;
 
     FileVersionEntity versionEntity;
     versionEntity.symbolFilePath = fileEntity.symbolFilePath();
-    versionEntity.versionNumber = versionNumber;
-    versionEntity.size = file.size();
+    versionEntity.size = stat.size;
     versionEntity.internalFileName = internalFileName;
-    versionEntity.lastModifiedTimestamp = info.lastModified();
+    versionEntity.lastModifiedNsecs = stat.modifiedNsecs;
+    versionEntity.inode = stat.inode;
+    versionEntity.packFileName = packFileName;
+    versionEntity.packOffset = packOffset;
+    versionEntity.isInline = isInline;
+    versionEntity.inlineContent = inlineContent;
     versionEntity.description = description;
     versionEntity.hash = fileHash;
+    versionEntity.hashAlgorithm = getHashAlgorithm();
 
-    bool isVersionInserted = fileVersionRepository->save(versionEntity);
+    // Numbered by the writer, so concurrent appends to the same file get consecutive numbers.
+    bool isVersionInserted = StorageWriteActor::instance()->execute([&](QSqlDatabase &writeDb) {
+        FileVersionRepository repository(writeDb);
+        versionEntity.versionNumber = qMax(repository.maxVersionNumber(versionEntity.symbolFilePath), (qlonglong) 0) + 1;
+
+        return repository.save(versionEntity);
+    });
 
     if(!isVersionInserted)
         return false;
@@ -214,11 +280,20 @@ bool FileStorageManager::deleteFolder(const QString &symbolFolderPath)
 
     if(entity.isExist())
     {
-        QList<FileEntity> fileList = fileRepository->findAllChildFiles(symbolFolderPath);
-        for(const FileEntity &fileEntity : fileList)
-            deleteFile(fileEntity.symbolFilePath());
+        QStringList internalFileNameList;
+
+        // Whole subtree is deleted by cascades of one statement, version files are collected in the same command.
+        result = StorageWriteActor::instance()->execute([&](QSqlDatabase &writeDb) {
+            internalFileNameList = FileVersionRepository(writeDb).findFileNamesUnderFolder(symbolFolderPath);
+            return FolderRepository(writeDb).deleteEntity(entity);
+        });
 
-        result = folderRepository->deleteEntity(entity);
+        // Space of packed versions is reclaimed by the repacker, inline ones are deleted with their row.
+        if(result && !internalFileNameList.isEmpty())
+        {
+            auto unlinkJob = QSharedPointer<StorageUnlinkJob>::create(getStorageFolderPath(), internalFileNameList);
+            JobScheduler::instance()->submit(unlinkJob);
+        }
     }
 
     return result;
@@ -227,22 +302,28 @@ bool FileStorageManager::deleteFolder(const QString &symbolFolderPath)
 bool FileStorageManager::deleteFile(const QString &symbolFilePath)
 {
     bool result = false;
-    FileEntity entity = fileRepository->findBySymbolPath(symbolFilePath, true);
+    FileEntity entity = fileRepository->findBySymbolPath(symbolFilePath);
 
     if(entity.isExist())
     {
-        QList<FileVersionEntity> fileVersionList = entity.getVersionList();
-        QStringList internalPathList;
+        QStringList internalFileNameList;
 
-        for(const FileVersionEntity &version : fileVersionList)
-            internalPathList.append(getStorageFolderPath() + version.internalFileName);
+        // Versions are collected in the same command, so ones appended meanwhile are deleted too.
+        result = StorageWriteActor::instance()->execute([&](QSqlDatabase &writeDb) {
+            // Space of packed versions is reclaimed by the repacker, inline ones are deleted with their row.
+            for(const FileVersionEntity &version : FileVersionRepository(writeDb).findAllVersions(symbolFilePath))
+            {
+                if(version.packFileName.isEmpty() && !version.isInline)
+                    internalFileNameList.append(version.internalFileName);
+            }
 
-        result = fileRepository->deleteEntity(entity);
+            return FileRepository(writeDb).deleteEntity(entity);
+        });
 
         if(result == true)
         {
-            for(const QString &filePath : internalPathList)
-                QFile::remove(filePath);
+            for(const QString &internalFileName : internalFileNameList)
+                QFile::remove(getInternalFilePath(internalFileName));
         }
     }
 
@@ -260,18 +341,59 @@ bool FileStorageManager::deleteFileVersion(const QString &symbolFilePath, qlongl
         if(maxVersionNumber <= 1) // Don't delete single version (therefore the entire file)
             return false;
 
-        result = fileVersionRepository->deleteEntity(entity);
+        // Only versions after the deleted one move down, in two statements regardless of version count.
+        result = StorageWriteActor::instance()->execute([&](QSqlDatabase &writeDb) {
+            FileVersionRepository repository(writeDb);
+            return repository.deleteEntity(entity) && repository.renumberVersions(symbolFilePath, versionNumber);
+        });
 
-        if(result == true)
-        {
-            QString internalFilePath = getStorageFolderPath() + entity.internalFileName;
-            QFile::remove(internalFilePath);
+        if(result == true && entity.packFileName.isEmpty() && !entity.isInline)
+            QFile::remove(getInternalFilePath(entity.internalFileName));
+    }
+
+    return result;
+}
 
-            FileEntity parentEntity = fileRepository->findBySymbolPath(symbolFilePath, true);
+bool FileStorageManager::updateFolder(const FolderRecord &record, bool updateFrozenStatusOfChildren)
+{
+    FolderEntity entity = folderRepository->findBySymbolPath(record.symbolFolderPath);
+    entity.parentFolderPath = record.parentFolderPath;
+    entity.suffixPath = record.suffixPath;
+    entity.userFolderPath = record.userFolderPath;
+    entity.isFrozen = record.isFrozen;
 
-            result = sortFileVersionEntities(parentEntity);
-        }
-    }
+    if(!entity.parentFolderPath.startsWith(separator))
+        entity.parentFolderPath.prepend(separator);
+
+    if(!entity.parentFolderPath.endsWith(separator))
+        entity.parentFolderPath.append(separator);
+
+    if(!entity.suffixPath.endsWith(separator))
+        entity.suffixPath.append(separator);
+
+    bool result = StorageWriteActor::instance()->execute([&](QSqlDatabase &writeDb) {
+        FolderRepository repository(writeDb);
+        bool isSaved = repository.save(entity);
+
+        if(isSaved == true && updateFrozenStatusOfChildren == true)
+            isSaved = repository.setIsFrozenOfChildren(entity.getPrimaryKey(), record.isFrozen);
+
+        return isSaved;
+    });
+
+    return result;
+}
+
+bool FileStorageManager::updateFile(const FileRecord &record)
+{
+    FileEntity entity = fileRepository->findBySymbolPath(record.symbolFilePath);
+    entity.fileName = record.fileName;
+    entity.symbolFolderPath = record.symbolFolderPath;
+    entity.isFrozen = record.isFrozen;
+
+    bool result = StorageWriteActor::instance()->execute([&](QSqlDatabase &writeDb) {
+        return FileRepository(writeDb).save(entity);
+    });
 
     return result;
 }
@@ -296,28 +418,14 @@ bool FileStorageManager::updateFolderEntity(QJsonObject folderDto, bool updateFr
     if(!isParentFolderPathString || !isSuffixPathString || !isSymbolFolderPathString || !isUserFolderPathString || !isFrozenBool)
         return false;
 
-    FolderEntity entity = folderRepository->findBySymbolPath(folderDto[JsonKeys::Folder::SymbolFolderPath].toString());
-    entity.parentFolderPath = folderDto[JsonKeys::Folder::ParentFolderPath].toString();
-    entity.suffixPath = folderDto[JsonKeys::Folder::SuffixPath].toString();
-    entity.userFolderPath = folderDto[JsonKeys::Folder::UserFolderPath].toString();
-    entity.isFrozen = folderDto[JsonKeys::Folder::IsFrozen].toBool();
+    FolderRecord record;
+    record.parentFolderPath = folderDto[JsonKeys::Folder::ParentFolderPath].toString();
+    record.suffixPath = folderDto[JsonKeys::Folder::SuffixPath].toString();
+    record.symbolFolderPath = folderDto[JsonKeys::Folder::SymbolFolderPath].toString();
+    record.userFolderPath = folderDto[JsonKeys::Folder::UserFolderPath].toString();
+    record.isFrozen = folderDto[JsonKeys::Folder::IsFrozen].toBool();
 
-    if(!entity.parentFolderPath.startsWith(separator))
-        entity.parentFolderPath.prepend(separator);
-
-    if(!entity.parentFolderPath.endsWith(separator))
-        entity.parentFolderPath.append(separator);
-
-    if(!entity.suffixPath.endsWith(separator))
-        entity.suffixPath.append(separator);
-
-    bool result = folderRepository->save(entity);
-
-    if(result == true && updateFrozenStatusOfChildren == true)
-    {
-        result = folderRepository->setIsFrozenOfChildren(entity.getPrimaryKey(),
-                                                         folderDto[JsonKeys::Folder::IsFrozen].toBool());
-    }
+    bool result = updateFolder(record, updateFrozenStatusOfChildren);
 
     return result;
 }
@@ -340,12 +448,13 @@ bool FileStorageManager::updateFileEntity(QJsonObject fileDto)
     if(!isFileNameString || !isSymbolFilePathString || !isSymbolFolderPathString || !isFrozenBool)
         return false;
 
-    FileEntity entity = fileRepository->findBySymbolPath(fileDto[JsonKeys::File::SymbolFilePath].toString());
-    entity.fileName = fileDto[JsonKeys::File::FileName].toString();
-    entity.symbolFolderPath = fileDto[JsonKeys::File::SymbolFolderPath].toString();
-    entity.isFrozen = fileDto[JsonKeys::File::IsFrozen].toBool();
+    FileRecord record;
+    record.fileName = fileDto[JsonKeys::File::FileName].toString();
+    record.symbolFilePath = fileDto[JsonKeys::File::SymbolFilePath].toString();
+    record.symbolFolderPath = fileDto[JsonKeys::File::SymbolFolderPath].toString();
+    record.isFrozen = fileDto[JsonKeys::File::IsFrozen].toBool();
 
-    bool result = fileRepository->save(entity);
+    bool result = updateFile(record);
 
     return result;
 }
@@ -369,7 +478,9 @@ bool FileStorageManager::updateFileVersionEntity(QJsonObject versionDto)
 
     entity.description = versionDto[JsonKeys::FileVersion::Description].toString(entity.description);
     entity.versionNumber = versionDto[JsonKeys::FileVersion::NewVersionNumber].toInteger(entity.versionNumber);
-    bool result = fileVersionRepository->save(entity);
+    bool result = StorageWriteActor::instance()->execute([&](QSqlDatabase &writeDb) {
+        return FileVersionRepository(writeDb).save(entity);
+    });
 
     return result;
 }
@@ -378,89 +489,238 @@ bool FileStorageManager::sortFileVersionsInIncreasingOrder(const QString &symbol
 {
     bool result = false;
 
-    FileEntity parentEntity = fileRepository->findBySymbolPath(symbolFilePath, true);
+    FileEntity parentEntity = fileRepository->findBySymbolPath(symbolFilePath);
 
     if(parentEntity.isExist())
-        result = sortFileVersionEntities(parentEntity);
+    {
+        result = StorageWriteActor::instance()->execute([&](QSqlDatabase &writeDb) {
+            return FileVersionRepository(writeDb).renumberVersions(symbolFilePath);
+        });
+    }
 
     return result;
 }
 
-QJsonObject FileStorageManager::getFolderJsonBySymbolPath(const QString &symbolFolderPath, bool includeChildren) const
+FolderRecord FileStorageManager::getFolderBySymbolPath(const QString &symbolFolderPath, bool includeChildren) const
 {
-    QJsonObject result;
-
     FolderEntity entity = folderRepository->findBySymbolPath(symbolFolderPath, includeChildren);
-    result = folderEntityToJsonObject(entity);
+    FolderRecord result = folderRecordFrom(entity);
+
+    if(includeChildren)
+    {
+        QList<FolderEntity> childFolderList = entity.getChildFolders();
+        QList<FileEntity> childFileList = entity.getChildFiles();
+
+        result.childFolders.reserve(childFolderList.size());
+        result.childFiles.reserve(childFileList.size());
+
+        for(const FolderEntity &childFolder : childFolderList)
+            result.childFolders.append(folderRecordFrom(childFolder));
+
+        for(const FileEntity &childFile : childFileList)
+            result.childFiles.append(fileRecordFrom(childFile, entity.userFolderPath));
+    }
 
     return result;
 }
 
-QJsonObject FileStorageManager::getFolderJsonByUserPath(const QString &userFolderPath, bool includeChildren) const
+FolderRecord FileStorageManager::getFolderByUserPath(const QString &userFolderPath, bool includeChildren) const
 {
     QString symbolPath = folderRepository->findSymbolPathByUserFolderPath(userFolderPath);
-    QJsonObject result = getFolderJsonBySymbolPath(symbolPath, includeChildren);
+    FolderRecord result = getFolderBySymbolPath(symbolPath, includeChildren);
     return result;
 }
 
-QJsonObject FileStorageManager::getFileJsonBySymbolPath(const QString &symbolFilePath, bool includeVersions) const
+FileRecord FileStorageManager::getFileBySymbolPath(const QString &symbolFilePath, bool includeVersions) const
 {
-    QJsonObject result;
-
     FileEntity entity = fileRepository->findBySymbolPath(symbolFilePath, includeVersions);
-    result = fileEntityToJsonObject(entity);
+    FolderEntity parentEntity = folderRepository->findBySymbolPath(entity.symbolFolderPath);
 
+    FileRecord result = fileRecordFrom(entity, parentEntity.userFolderPath);
     return result;
 }
 
-QJsonObject FileStorageManager::getFileJsonByUserPath(const QString &userFilePath, bool includeVersions) const
+FileRecord FileStorageManager::getFileByUserPath(const QString &userFilePath, bool includeVersions) const
 {
     QFileInfo info(userFilePath);
     QString userFolderPath = QDir::toNativeSeparators(info.absolutePath()) + QDir::separator();
     QString symbolFolderPath = folderRepository->findSymbolPathByUserFolderPath(userFolderPath);
     QString symbolFilePath = symbolFolderPath + info.fileName();
 
-    QJsonObject result = getFileJsonBySymbolPath(symbolFilePath, includeVersions);
+    FileRecord result;
+
+    if(!symbolFolderPath.isEmpty())
+    {
+        FileEntity entity = fileRepository->findBySymbolPath(symbolFilePath, includeVersions);
+        result = fileRecordFrom(entity, userFolderPath); // Parent is already known, no need to query it again
+    }
+
     return result;
 }
 
-QJsonObject FileStorageManager::getFileVersionJson(const QString &symbolFilePath, qlonglong versionNumber) const
+FileVersionRecord FileStorageManager::getFileVersion(const QString &symbolFilePath, qlonglong versionNumber) const
 {
-    QJsonObject result;
-
     FileVersionEntity entity = fileVersionRepository->findVersion(symbolFilePath, versionNumber);
-    result = fileVersionEntityToJsonObject(entity);
+    FileVersionRecord result = fileVersionRecordFrom(entity);
+    return result;
+}
+
+// Inode isn't compared because restoring a version writes a new file.
+bool FileStorageManager::isFileUnchanged(const QString &symbolFilePath, const FileStat &stat) const
+{
+    if(stat.size < 0)
+        return false;
 
+    bool result = fileVersionRepository->isLatestVersionMatching(symbolFilePath, stat.size, stat.modifiedNsecs);
     return result;
 }
 
-QJsonArray FileStorageManager::getActiveFolderList() const
+QList<FolderRecord> FileStorageManager::getActiveFolders() const
 {
-    QJsonArray result;
+    QList<FolderRecord> result;
 
     QList<FolderEntity> queryResult = folderRepository->findActiveFolders();
+    result.reserve(queryResult.size());
 
     for(const FolderEntity &entity : queryResult)
+        result.append(folderRecordFrom(entity));
+
+    return result;
+}
+
+QList<FileRecord> FileStorageManager::getActiveFiles() const
+{
+    QList<FileRecord> result;
+    QHash<QString, QString> userFolderPathCache; // Symbol folder path -> user folder path
+
+    QList<FileEntity> queryResult = fileRepository->findActiveFiles();
+    result.reserve(queryResult.size());
+
+    for(const FileEntity &entity : queryResult)
+    {
+        auto iterator = userFolderPathCache.constFind(entity.symbolFolderPath);
+
+        if(iterator == userFolderPathCache.constEnd())
+        {
+            QString userFolderPath = folderRepository->findBySymbolPath(entity.symbolFolderPath).userFolderPath;
+            iterator = userFolderPathCache.insert(entity.symbolFolderPath, userFolderPath);
+        }
+
+        result.append(fileRecordFrom(entity, iterator.value()));
+    }
+
+    return result;
+}
+
+QHash<QString, FileVersionRecord> FileStorageManager::getLatestVersionsOfActiveFiles() const
+{
+    QHash<QString, FileVersionRecord> result;
+    QHash<QString, QString> userFilePathTable; // Symbol file path -> user file path
+    QHash<QString, QString> userFolderPathCache; // Symbol folder path -> user folder path
+
+    for(const FileEntity &entity : fileRepository->findActiveFiles())
+    {
+        auto iterator = userFolderPathCache.constFind(entity.symbolFolderPath);
+
+        if(iterator == userFolderPathCache.constEnd())
+        {
+            QString userFolderPath = folderRepository->findBySymbolPath(entity.symbolFolderPath).userFolderPath;
+            iterator = userFolderPathCache.insert(entity.symbolFolderPath, userFolderPath);
+        }
+
+        if(!iterator.value().isEmpty())
+            userFilePathTable.insert(entity.symbolFilePath(), iterator.value() + entity.fileName);
+    }
+
+    for(const FileVersionEntity &entity : fileVersionRepository->findLatestVersions())
     {
-        QJsonObject folderJson = folderEntityToJsonObject(entity);
-        result.append(folderJson);
+        auto iterator = userFilePathTable.constFind(entity.symbolFilePath);
+
+        if(iterator != userFilePathTable.constEnd())
+            result.insert(iterator.value(), fileVersionRecordFrom(entity));
     }
 
     return result;
 }
 
+QJsonObject FileStorageManager::getFolderJsonBySymbolPath(const QString &symbolFolderPath, bool includeChildren) const
+{
+    return toJson(getFolderBySymbolPath(symbolFolderPath, includeChildren));
+}
+
+QJsonObject FileStorageManager::getFolderJsonByUserPath(const QString &userFolderPath, bool includeChildren) const
+{
+    return toJson(getFolderByUserPath(userFolderPath, includeChildren));
+}
+
+QJsonObject FileStorageManager::getFileJsonBySymbolPath(const QString &symbolFilePath, bool includeVersions) const
+{
+    return toJson(getFileBySymbolPath(symbolFilePath, includeVersions));
+}
+
+QJsonObject FileStorageManager::getFileJsonByUserPath(const QString &userFilePath, bool includeVersions) const
+{
+    return toJson(getFileByUserPath(userFilePath, includeVersions));
+}
+
+QJsonObject FileStorageManager::getFileVersionJson(const QString &symbolFilePath, qlonglong versionNumber) const
+{
+    return toJson(getFileVersion(symbolFilePath, versionNumber));
+}
+
+QJsonArray FileStorageManager::getActiveFolderList() const
+{
+    QJsonArray result;
+
+    for(const FolderRecord &record : getActiveFolders())
+        result.append(toJson(record));
+
+    return result;
+}
+
 QJsonArray FileStorageManager::getActiveFileList() const
 {
     QJsonArray result;
 
-    QList<FileEntity> queryResult = fileRepository->findActiveFiles();
+    for(const FileRecord &record : getActiveFiles())
+        result.append(toJson(record));
 
-    for(const FileEntity &entity : queryResult)
+    return result;
+}
+
+FolderListingPage FileStorageManager::getFolderListingPage(const QString &symbolFolderPath,
+                                                          FolderListingPage::SortKey sortKey,
+                                                          Qt::SortOrder order,
+                                                          int pageSize,
+                                                          const FolderListingItem &afterItem) const
+{
+    FolderListingPage result;
+
+    if(pageSize <= 0)
+        return result;
+
+    // One extra row is fetched to find out whether there is a next page.
+    if(!afterItem.isValid() || afterItem.isFolder)
+    {
+        QString afterSuffixPath = afterItem.isValid() ? afterItem.name + separator : "";
+        result.itemList = folderRepository->findChildFolderPage(symbolFolderPath, order, afterSuffixPath, pageSize + 1);
+    }
+
+    if(result.itemList.size() <= pageSize)
     {
-        QJsonObject folderJson = fileEntityToJsonObject(entity);
-        result.append(folderJson);
+        int remainingCount = pageSize - result.itemList.size();
+        result.itemList.append(fileRepository->findChildFilePage(symbolFolderPath,
+                                                                 sortKey,
+                                                                 order,
+                                                                 afterItem,
+                                                                 remainingCount + 1));
     }
 
+    result.isLastPage = (result.itemList.size() <= pageSize);
+
+    if(!result.isLastPage)
+        result.itemList.resize(pageSize);
+
     return result;
 }
 
@@ -477,64 +737,282 @@ void FileStorageManager::setStorageFolderPath(const QString &newStorageFolderPat
         storageFolderPath.append(QDir::separator());
 }
 
+QString FileStorageManager::getInternalFilePath(const QString &internalFileName) const
+{
+    return StorageLayout::resolveFilePath(getStorageFolderPath(), internalFileName);
+}
+
+bool FileStorageManager::copyVersionFile(const FileVersionRecord &record, const QString &destinationFilePath, IoScheduler::Budget budget) const
+{
+    if(record.packFileName.isEmpty() && !record.isInline)
+        return FileCopier::copyFile(getInternalFilePath(record.internalFileName), destinationFilePath, budget);
+
+    QByteArray data;
+
+    if(!readStoredContent(record, data))
+        return false;
+
+    IoScheduler::instance()->acquire(budget, data.size());
+
+    // Same semantics with FileCopier, destination must not exist.
+    QFile destination(destinationFilePath);
+
+    if(!destination.open(QFile::OpenModeFlag::WriteOnly | QFile::OpenModeFlag::NewOnly))
+        return false;
+
+    bool result = (destination.write(data) == data.size());
+    destination.close();
+
+    if(!result)
+        destination.remove();
+
+    return result;
+}
+
+QSharedPointer<QIODevice> FileStorageManager::openVersionFile(const FileVersionRecord &record) const
+{
+    if(record.packFileName.isEmpty() && !record.isInline)
+    {
+        auto file = QSharedPointer<QFile>::create(getInternalFilePath(record.internalFileName));
+
+        if(!file->open(QFile::OpenModeFlag::ReadOnly))
+            return nullptr;
+
+        return file;
+    }
+
+    QByteArray data;
+
+    if(!readStoredContent(record, data))
+        return nullptr;
+
+    // Packed and inline versions are small, holding them in memory is cheaper than keeping the pack open.
+    auto buffer = QSharedPointer<QBuffer>::create();
+    buffer->setData(data);
+    buffer->open(QBuffer::OpenModeFlag::ReadOnly);
+
+    return buffer;
+}
+
+QStringList FileStorageManager::getPackFilesToRepack() const
+{
+    QStringList result;
+
+    PackStore packStore(getStorageFolderPath());
+    QHash<QString, qint64> liveSizes = fileVersionRepository->packLiveSizes();
+    QString activePack = PackStore::activePackFileName();
+
+    for(const QString &packFileName : packStore.listPackFileNames())
+    {
+        QFileInfo packInfo(packStore.getPackFilePath(packFileName));
+
+        // Recently rolled over packs may have entries whose version isn't saved to database yet.
+        if(packFileName == activePack || packInfo.lastModified().secsTo(QDateTime::currentDateTime()) < RepackMinAgeSecs)
+            continue;
+
+        if(packStore.isRetired(packFileName)) // Already empty, waiting to be deleted
+            continue;
+
+        qint64 packSize = packInfo.size();
+
+        if(liveSizes.value(packFileName, 0) < packSize * RepackLiveRatio)
+            result.append(packFileName);
+    }
+
+    return result;
+}
+
+bool FileStorageManager::repackPackFile(const QString &packFileName)
+{
+    if(packFileName == PackStore::activePackFileName())
+        return false;
+
+    PackStore packStore(getStorageFolderPath());
+    QList<FileVersionEntity> versionList = fileVersionRepository->findAllInPack(packFileName);
+    QList<FileVersionEntity> movedList;
+    bool isCopied = true;
+
+    for(const FileVersionEntity &version : versionList)
+    {
+        QByteArray data;
+        FileVersionEntity moved = version;
+
+        isCopied = packStore.read(packFileName, version.packOffset, version.size, data)
+                   && packStore.append(data, moved.packFileName, moved.packOffset, IoScheduler::Budget::Background);
+
+        if(!isCopied)
+            break;
+
+        movedList.append(moved);
+    }
+
+    // Locations are updated in one command, also for the versions copied before a failure.
+    // A version deleted meanwhile only leaves a few unused bytes in the active pack.
+    if(!movedList.isEmpty())
+    {
+        StorageWriteActor::instance()->execute([&](QSqlDatabase &writeDb) {
+            FileVersionRepository repository(writeDb);
+
+            for(const FileVersionEntity &moved : movedList)
+                repository.updatePackLocation(moved.internalFileName, packFileName, moved.packFileName, moved.packOffset);
+
+            return true;
+        });
+    }
+
+    if(!isCopied)
+        return false;
+
+    if(!fileVersionRepository->findAllInPack(packFileName).isEmpty())
+        return false;
+
+    // Readers holding the old location may still read it, pack is deleted after a grace period by PackRepackJob.
+    return packStore.retire(packFileName);
+}
+
+qint64 FileStorageManager::getInlineFileSizeLimit() const
+{
+    return inlineFileSizeLimit;
+}
+
+void FileStorageManager::setInlineFileSizeLimit(qint64 newInlineFileSizeLimit)
+{
+    // Inline versions must be smaller than packed ones, larger limits fall back to packs.
+    inlineFileSizeLimit = qBound((qint64) 0, newInlineFileSizeLimit, PackStore::MaxPackedFileSize);
+}
+
+QStringList FileStorageManager::getStoredFileNamesWithPrefix(const QString &prefix) const
+{
+    return fileVersionRepository->findFileNamesWithPrefix(prefix);
+}
+
+QList<FileVersionRecord> FileStorageManager::getVersionsToVerify(qint64 verifiedBeforeMsecs, int count) const
+{
+    QList<FileVersionRecord> result;
+    QList<FileVersionEntity> entityList = fileVersionRepository->findLeastRecentlyVerified(verifiedBeforeMsecs, count);
+
+    for(const FileVersionEntity &entity : entityList)
+        result.append(fileVersionRecordFrom(entity));
+
+    return result;
+}
+
+qlonglong FileStorageManager::countVersionsToVerify(qint64 verifiedBeforeMsecs) const
+{
+    return fileVersionRepository->countVerifiedBefore(verifiedBeforeMsecs);
+}
+
+qlonglong FileStorageManager::countCorruptVersions() const
+{
+    return fileVersionRepository->countCorrupt();
+}
+
+bool FileStorageManager::verifyVersion(const FileVersionRecord &record, IoScheduler::Budget budget)
+{
+    bool result = false;
+
+    // Versions without a hash can't be checked, they are only marked as visited.
+    if(record.hash.isEmpty())
+        result = true;
+    else
+    {
+        QSharedPointer<QIODevice> device = openVersionFile(record);
+
+        if(!device.isNull())
+            result = (FileHasher::hashDevice(*device, record.hashAlgorithm, budget) == record.hash);
+    }
+
+    bool isUpdated = StorageWriteActor::instance()->execute([&](QSqlDatabase &writeDb) {
+        return FileVersionRepository(writeDb).updateVerifyResult(record.internalFileName,
+                                                                  QDateTime::currentMSecsSinceEpoch(),
+                                                                  !result);
+    });
+
+    // Version deleted meanwhile isn't corrupt.
+    return result || !isUpdated;
+}
+
+QString FileStorageManager::getHashAlgorithm() const
+{
+    return hashAlgorithm;
+}
+
+void FileStorageManager::setHashAlgorithm(const QString &newHashAlgorithm)
+{
+    if(FileHasher::isSupported(newHashAlgorithm))
+        hashAlgorithm = newHashAlgorithm;
+    else
+        hashAlgorithm = FileHasher::DefaultAlgorithm;
+}
+
+bool FileStorageManager::readStoredContent(const FileVersionRecord &record, QByteArray &data) const
+{
+    if(record.isInline)
+    {
+        data = fileVersionRepository->findInlineContent(record.internalFileName);
+        return data.size() == record.size;
+    }
+
+    PackStore packStore(getStorageFolderPath());
+
+    if(packStore.read(record.packFileName, record.packOffset, record.size, data))
+        return true;
+
+    // Version may be moved by the repacker after record was read.
+    FileVersionEntity entity = fileVersionRepository->findByInternalFileName(record.internalFileName);
+
+    if(!entity.isExist() || entity.packFileName.isEmpty() || entity.packFileName == record.packFileName)
+        return false;
+
+    return packStore.read(entity.packFileName, entity.packOffset, entity.size, data);
+}
+
 QString FileStorageManager::generateRandomFileName()
 {
     QString result = QUuid::createUuid().toString(QUuid::StringFormat::Id128) + ".file";
     return result;
 }
 
-QJsonObject FileStorageManager::folderEntityToJsonObject(const FolderEntity &entity) const
+bool FileStorageManager::isSameStat(const FileStat &first, const FileStat &second)
+{
+    return first.size == second.size &&
+           first.modifiedNsecs == second.modifiedNsecs &&
+           first.inode == second.inode;
+}
+
+QJsonObject FileStorageManager::toJson(const FolderRecord &record)
 {
     QJsonObject result;
 
-    result[JsonKeys::IsExist] = entity.isExist();
-    result[JsonKeys::Folder::ParentFolderPath] = entity.parentFolderPath;
-    result[JsonKeys::Folder::SuffixPath] = entity.suffixPath;
-    result[JsonKeys::Folder::SymbolFolderPath] = entity.symbolFolderPath();
-    result[JsonKeys::Folder::IsFrozen] = entity.isFrozen;
+    result[JsonKeys::IsExist] = record.isExist;
+    result[JsonKeys::Folder::ParentFolderPath] = record.parentFolderPath;
+    result[JsonKeys::Folder::SuffixPath] = record.suffixPath;
+    result[JsonKeys::Folder::SymbolFolderPath] = record.symbolFolderPath;
+    result[JsonKeys::Folder::IsFrozen] = record.isFrozen;
 
     result[JsonKeys::Folder::UserFolderPath] = QJsonValue(QJsonValue::Type::Null);
     result[JsonKeys::Folder::ChildFolders] = QJsonValue(QJsonValue::Type::Null);
     result[JsonKeys::Folder::ChildFiles] = QJsonValue(QJsonValue::Type::Null);
 
-    if(!entity.isFrozen)
-        result[JsonKeys::Folder::UserFolderPath] = entity.userFolderPath;
+    if(!record.isFrozen)
+        result[JsonKeys::Folder::UserFolderPath] = record.userFolderPath;
 
-    if(!entity.getChildFolders().isEmpty())
+    if(!record.childFolders.isEmpty())
     {
         QJsonArray jsonArrayChildFolder;
-        for(const FolderEntity &entityChildFolder : entity.getChildFolders())
-        {
-            QJsonObject jsonChildFolder;
-
-            jsonChildFolder[JsonKeys::IsExist] = entityChildFolder.isExist();
-            jsonChildFolder[JsonKeys::Folder::ParentFolderPath] = entityChildFolder.parentFolderPath;
-            jsonChildFolder[JsonKeys::Folder::SuffixPath] = entityChildFolder.suffixPath;
-            jsonChildFolder[JsonKeys::Folder::SymbolFolderPath] = entityChildFolder.symbolFolderPath();
-            jsonChildFolder[JsonKeys::Folder::IsFrozen] = entityChildFolder.isFrozen;
 
-            jsonChildFolder[JsonKeys::Folder::UserFolderPath] = QJsonValue(QJsonValue::Type::Null);
-            if(!entityChildFolder.isFrozen)
-                jsonChildFolder[JsonKeys::Folder::UserFolderPath] = entityChildFolder.userFolderPath;
-
-            jsonChildFolder[JsonKeys::Folder::ChildFolders] = QJsonValue(QJsonValue::Type::Null);
-            jsonChildFolder[JsonKeys::Folder::ChildFiles] = QJsonValue(QJsonValue::Type::Null);
-            jsonArrayChildFolder.append(jsonChildFolder);
-        }
+        for(const FolderRecord &childFolder : record.childFolders)
+            jsonArrayChildFolder.append(toJson(childFolder));
 
         result[JsonKeys::Folder::ChildFolders] = jsonArrayChildFolder;
     }
 
-    if(!entity.getChildFiles().isEmpty())
+    if(!record.childFiles.isEmpty())
     {
         QJsonArray jsonArrayFileList;
 
-        for(const FileEntity &entityFile : entity.getChildFiles())
-        {
-            QJsonObject jsonChildFile;
-            jsonChildFile = fileEntityToJsonObject(entityFile);
-            jsonArrayFileList.append(jsonChildFile);
-        }
+        for(const FileRecord &childFile : record.childFiles)
+            jsonArrayFileList.append(toJson(childFile));
 
         result[JsonKeys::Folder::ChildFiles] = jsonArrayFileList;
     }
@@ -542,33 +1020,28 @@ QJsonObject FileStorageManager::folderEntityToJsonObject(const FolderEntity &ent
     return result;
 }
 
-QJsonObject FileStorageManager::fileEntityToJsonObject(const FileEntity &entity) const
+QJsonObject FileStorageManager::toJson(const FileRecord &record)
 {
     QJsonObject result;
 
-    result[JsonKeys::IsExist] = entity.isExist();
-    result[JsonKeys::File::FileName] = entity.fileName;
-    result[JsonKeys::File::IsFrozen] = entity.isFrozen;
-    result[JsonKeys::File::SymbolFolderPath] = entity.symbolFolderPath;
-    result[JsonKeys::File::SymbolFilePath] = entity.symbolFilePath();
-    result[JsonKeys::File::MaxVersionNumber] = fileVersionRepository->maxVersionNumber(entity.symbolFilePath());
+    result[JsonKeys::IsExist] = record.isExist;
+    result[JsonKeys::File::FileName] = record.fileName;
+    result[JsonKeys::File::IsFrozen] = record.isFrozen;
+    result[JsonKeys::File::SymbolFolderPath] = record.symbolFolderPath;
+    result[JsonKeys::File::SymbolFilePath] = record.symbolFilePath;
+    result[JsonKeys::File::MaxVersionNumber] = record.maxVersionNumber;
     result[JsonKeys::File::UserFilePath] = QJsonValue(QJsonValue::Type::Null);
     result[JsonKeys::File::VersionList] = QJsonValue(QJsonValue::Type::Null);
 
-    FolderEntity parentEntity = folderRepository->findBySymbolPath(entity.symbolFolderPath);
-
-    if(!parentEntity.userFolderPath.isEmpty() && !entity.isFrozen)
-        result[JsonKeys::File::UserFilePath] = parentEntity.userFolderPath + entity.fileName;
+    if(!record.userFilePath.isEmpty())
+        result[JsonKeys::File::UserFilePath] = record.userFilePath;
 
-    if(!entity.getVersionList().isEmpty())
+    if(!record.versionList.isEmpty())
     {
         QJsonArray jsonArrayVersionList;
-        for(const FileVersionEntity &entityFileVersion : entity.getVersionList())
-        {
-            QJsonObject jsonFileVersion;
-            jsonFileVersion = fileVersionEntityToJsonObject(entityFileVersion);
-            jsonArrayVersionList.append(jsonFileVersion);
-        }
+
+        for(const FileVersionRecord &version : record.versionList)
+            jsonArrayVersionList.append(toJson(version));
 
         result[JsonKeys::File::VersionList] = jsonArrayVersionList;
     }
@@ -576,42 +1049,118 @@ QJsonObject FileStorageManager::fileEntityToJsonObject(const FileEntity &entity)
     return result;
 }
 
-QJsonObject FileStorageManager::fileVersionEntityToJsonObject(const FileVersionEntity &entity) const
+QJsonObject FileStorageManager::toJson(const FileVersionRecord &record)
 {
     QJsonObject result;
+    QDateTime lastModifiedTimestamp;
+
+    if(record.lastModifiedNsecs != 0)
+        lastModifiedTimestamp = QDateTime::fromMSecsSinceEpoch(record.lastModifiedNsecs / 1000000);
+
+    result[JsonKeys::IsExist] = record.isExist;
+    result[JsonKeys::FileVersion::SymbolFilePath] = record.symbolFilePath;
+    result[JsonKeys::FileVersion::VersionNumber] = record.versionNumber;
+    result[JsonKeys::FileVersion::Size] = record.size;
+    result[JsonKeys::FileVersion::LastModifiedTimestamp] = lastModifiedTimestamp.toString(Qt::DateFormat::ISODateWithMs);
+    result[JsonKeys::FileVersion::Description] = record.description;
+    result[JsonKeys::FileVersion::Hash] = record.hash;
+    result[JsonKeys::FileVersion::HashAlgorithm] = record.hashAlgorithm;
+    result[JsonKeys::FileVersion::InternalFileName] = record.internalFileName;
+
+    if(record.packFileName.isEmpty())
+    {
+        result[JsonKeys::FileVersion::PackFileName] = QJsonValue(QJsonValue::Type::Null);
+        result[JsonKeys::FileVersion::PackOffset] = QJsonValue(QJsonValue::Type::Null);
+    }
+    else
+    {
+        result[JsonKeys::FileVersion::PackFileName] = PackStore::PackFolderName + separator + record.packFileName;
+        result[JsonKeys::FileVersion::PackOffset] = record.packOffset;
+    }
+
+    result[JsonKeys::FileVersion::IsInline] = record.isInline;
 
-    result[JsonKeys::IsExist] = entity.isExist();
-    result[JsonKeys::FileVersion::SymbolFilePath] = entity.symbolFilePath;
-    result[JsonKeys::FileVersion::VersionNumber] = entity.versionNumber;
-    result[JsonKeys::FileVersion::Size] = entity.size;
-    result[JsonKeys::FileVersion::LastModifiedTimestamp] = entity.lastModifiedTimestamp.toString(Qt::DateFormat::ISODateWithMs);
-    result[JsonKeys::FileVersion::Description] = entity.description;
-    result[JsonKeys::FileVersion::Hash] = entity.hash;
-    result[JsonKeys::FileVersion::InternalFileName] = entity.internalFileName;
+    if(record.lastVerifiedMsecs == 0)
+        result[JsonKeys::FileVersion::LastVerifiedTimestamp] = QJsonValue(QJsonValue::Type::Null);
+    else
+        result[JsonKeys::FileVersion::LastVerifiedTimestamp] = QDateTime::fromMSecsSinceEpoch(record.lastVerifiedMsecs).toString(Qt::DateFormat::ISODateWithMs);
+
+    result[JsonKeys::FileVersion::IsCorrupt] = record.isCorrupt;
 
     result[JsonKeys::FileVersion::NewVersionNumber] = QJsonValue(QJsonValue::Type::Null);
 
     return result;
 }
 
-bool FileStorageManager::sortFileVersionEntities(const FileEntity &parentEntity)
+FolderRecord FileStorageManager::folderRecordFrom(const FolderEntity &entity) const
 {
-    bool result = false;
+    FolderRecord result;
 
-    if(parentEntity.isExist())
+    result.isExist = entity.isExist();
+    result.parentFolderPath = entity.parentFolderPath;
+    result.suffixPath = entity.suffixPath;
+    result.symbolFolderPath = entity.symbolFolderPath();
+    result.isFrozen = entity.isFrozen;
+
+    if(!entity.isFrozen)
+        result.userFolderPath = entity.userFolderPath;
+
+    return result;
+}
+
+FileRecord FileStorageManager::fileRecordFrom(const FileEntity &entity, const QString &parentUserFolderPath) const
+{
+    FileRecord result;
+
+    result.isExist = entity.isExist();
+    result.fileName = entity.fileName;
+    result.isFrozen = entity.isFrozen;
+    result.symbolFolderPath = entity.symbolFolderPath;
+    result.symbolFilePath = entity.symbolFilePath();
+
+    if(!result.isExist)
+        return result;
+
+    QList<FileVersionEntity> versionList = entity.getVersionList();
+
+    if(versionList.isEmpty())
+        result.maxVersionNumber = fileVersionRepository->maxVersionNumber(result.symbolFilePath);
+    else
     {
-        qlonglong versionNumber = 1;
+        result.versionList.reserve(versionList.size());
 
-        for(FileVersionEntity &currentVersion : parentEntity.getVersionList())
+        for(const FileVersionEntity &version : versionList)
         {
-            currentVersion.versionNumber = versionNumber;
-            result = fileVersionRepository->save(currentVersion);
-            ++versionNumber;
-
-            if(result == false)
-                return false;
+            result.versionList.append(fileVersionRecordFrom(version));
+            result.maxVersionNumber = qMax(result.maxVersionNumber, version.versionNumber);
         }
     }
 
+    if(!parentUserFolderPath.isEmpty() && !entity.isFrozen)
+        result.userFilePath = parentUserFolderPath + entity.fileName;
+
+    return result;
+}
+
+FileVersionRecord FileStorageManager::fileVersionRecordFrom(const FileVersionEntity &entity) const
+{
+    FileVersionRecord result;
+
+    result.isExist = entity.isExist();
+    result.symbolFilePath = entity.symbolFilePath;
+    result.versionNumber = entity.versionNumber;
+    result.internalFileName = entity.internalFileName;
+    result.size = entity.size;
+    result.description = entity.description;
+    result.hash = entity.hash;
+    result.hashAlgorithm = entity.hashAlgorithm;
+    result.lastModifiedNsecs = entity.lastModifiedNsecs;
+    result.inode = entity.inode;
+    result.packFileName = entity.packFileName;
+    result.packOffset = entity.packOffset;
+    result.isInline = entity.isInline;
+    result.lastVerifiedMsecs = entity.lastVerifiedMsecs;
+    result.isCorrupt = entity.isCorrupt;
+
     return result;
 }
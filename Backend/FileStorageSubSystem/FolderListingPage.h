@@ -0,0 +1,39 @@
+#ifndef FOLDERLISTINGPAGE_H
+#define FOLDERLISTINGPAGE_H
+
+#include <QList>
+#include <QString>
+
+// Child folder or file of a listed folder.
+struct FolderListingItem
+{
+    QString name;
+    QString symbolPath;
+    QString userPath; // Empty when item is frozen or not monitored
+    bool isFolder = false;
+    bool isFrozen = false;
+    qlonglong size = 0; // Of the latest version, always 0 for folders
+    qint64 lastModifiedNsecs = 0; // Of the latest version since epoch, always 0 for folders
+
+    bool isValid() const
+    {
+        return !symbolPath.isEmpty();
+    }
+};
+
+// One page of a folder listing. Child folders always come before child files.
+// Next page is requested by passing the last item of the previous page.
+struct FolderListingPage
+{
+    enum SortKey
+    {
+        Name,
+        Size,
+        LastModified
+    };
+
+    QList<FolderListingItem> itemList;
+    bool isLastPage = true;
+};
+
+#endif // FOLDERLISTINGPAGE_H
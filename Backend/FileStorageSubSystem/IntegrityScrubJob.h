@@ -0,0 +1,54 @@
+#ifndef INTEGRITYSCRUBJOB_H
+#define INTEGRITYSCRUBJOB_H
+
+#include "Utility/BackgroundJob.h"
+
+#include <QMutex>
+#include <QSharedPointer>
+
+// Re-hashes stored versions and records when each one was last verified, so bit rot is found before a restore fails.
+// Never verified versions go first, then the ones verified longest ago. Reads are charged to the background budget.
+class IntegrityScrubJob : public BackgroundJob
+{
+public:
+    struct Status
+    {
+        qint64 jobId = -1; // -1 when no scrub is queued or running
+        bool isRunning = false;
+        qint64 checkedCount = 0;
+        qint64 totalCount = 0;
+        qint64 corruptCount = 0; // Found by the current or last run
+        qint64 lastFinishedMsecs = 0; // Since epoch, 0 when no run finished in this process
+    };
+
+    static const inline int ScrubThreadCount = 2;
+    static const inline int BatchSize = 256;
+
+    IntegrityScrubJob();
+    ~IntegrityScrubJob();
+
+    // Checkpoint keeps the cutoff time, so a resumed pass doesn't start over.
+    QString checkpointKey() const override;
+
+    // Returns id of the queued or already running scrub.
+    static qint64 submitIfIdle();
+
+    // Only resumes an interrupted pass or starts one when a version wasn't verified within the interval, -1 otherwise.
+    static qint64 submitIfDue();
+    static Status getStatus();
+
+protected:
+    bool run() override;
+
+private:
+    static const inline qint64 MsecsPerDay = 86400000;
+
+    // New pass verifies versions last verified before this, see AppConfig::getScrubIntervalDays().
+    static qint64 newPassCutoffMsecs();
+    static qint64 submitJob(QSharedPointer<IntegrityScrubJob> job);
+
+    static QMutex statusMutex;
+    static Status status;
+};
+
+#endif // INTEGRITYSCRUBJOB_H
@@ -103,10 +103,100 @@ QList<FileEntity> FileRepository::findAllChildFiles(const QString &symbolFolderP
     return result;
 }
 
+// Child files with their latest version in one statement, paged by (sort key, file name) keyset.
+QList<FolderListingItem> FileRepository::findChildFilePage(const QString &symbolFolderPath,
+                                                           FolderListingPage::SortKey sortKey,
+                                                           Qt::SortOrder order,
+                                                           const FolderListingItem &afterItem,
+                                                           int limit) const
+{
+    QList<FolderListingItem> result;
+
+    bool isAscending = (order == Qt::SortOrder::AscendingOrder);
+    bool isAfterFile = afterItem.isValid() && !afterItem.isFolder;
+    QString direction = isAscending ? "ASC" : "DESC";
+    QString comparison = isAscending ? ">" : "<";
+
+    QString sortExpression;
+    QVariant afterSortValue;
+
+    if(sortKey == FolderListingPage::SortKey::Size)
+    {
+        sortExpression = "IFNULL(v.size, 0)";
+        afterSortValue = afterItem.size;
+    }
+    else if(sortKey == FolderListingPage::SortKey::LastModified)
+    {
+        sortExpression = "IFNULL(v.last_modified_ns, 0)";
+        afterSortValue = afterItem.lastModifiedNsecs;
+    }
+
+    QSqlQuery query(database);
+    QString queryTemplate = " SELECT f.file_name, f.symbol_file_path, f.is_frozen, p.user_folder_path,"
+                            "        v.size, v.last_modified_ns"
+                            " FROM FileEntity f"
+                            " JOIN FolderEntity p ON p.symbol_folder_path = f.symbol_folder_path"
+                            " LEFT JOIN FileVersionEntity v ON v.symbol_file_path = f.symbol_file_path"
+                            "  AND v.version_number = (SELECT MAX(version_number) FROM FileVersionEntity"
+                            "                          WHERE symbol_file_path = f.symbol_file_path)"
+                            " WHERE f.symbol_folder_path = :1";
+
+    if(isAfterFile)
+    {
+        if(sortExpression.isEmpty())
+            queryTemplate += QString(" AND f.file_name %1 :3").arg(comparison);
+        else
+            queryTemplate += QString(" AND (%1, f.file_name) %2 (:2, :3)").arg(sortExpression, comparison);
+    }
+
+    if(sortExpression.isEmpty())
+        queryTemplate += QString(" ORDER BY f.file_name %1").arg(direction);
+    else
+        queryTemplate += QString(" ORDER BY %1 %2, f.file_name %2").arg(sortExpression, direction);
+
+    queryTemplate += " LIMIT :4;";
+
+    query.setForwardOnly(true);
+    query.prepare(queryTemplate);
+    query.bindValue(":1", symbolFolderPath);
+
+    if(isAfterFile)
+    {
+        if(!sortExpression.isEmpty())
+            query.bindValue(":2", afterSortValue);
+
+        query.bindValue(":3", afterItem.name);
+    }
+
+    query.bindValue(":4", limit);
+    query.exec();
+
+    while(query.next())
+    {
+        FolderListingItem item;
+
+        item.isFolder = false;
+        item.name = query.value(0).toString();
+        item.symbolPath = query.value(1).toString();
+        item.isFrozen = query.value(2).toBool();
+        item.size = query.value(4).toLongLong();
+        item.lastModifiedNsecs = query.value(5).toLongLong();
+
+        QString userFolderPath = query.value(3).toString();
+
+        if(!userFolderPath.isEmpty() && !item.isFrozen)
+            item.userPath = userFolderPath + item.name;
+
+        result.append(item);
+    }
+
+    return result;
+}
+
 bool FileRepository::save(FileEntity &entity, QSqlError *error)
 {
     bool result = false;
-    bool isExist = findBySymbolPath(entity.getPrimaryKey()).isExist();
+    bool isExist = entity.isExist(); // Loaded entities may be renamed, so they are updated by their old key
 
     QSqlQuery query(database);
     QString queryTemplate;
@@ -120,7 +210,10 @@ bool FileRepository::save(FileEntity &entity, QSqlError *error)
     else
     {
         queryTemplate = " INSERT INTO FileEntity (symbol_folder_path, file_name, is_frozen) "
-                        " VALUES (:1, :2, :3);" ;
+                        " VALUES (:1, :2, :3)"
+                        " ON CONFLICT (symbol_folder_path, file_name) DO UPDATE"
+                        " SET is_frozen = excluded.is_frozen"
+                        " RETURNING symbol_file_path;" ;
     }
 
     query.prepare(queryTemplate);
@@ -139,7 +232,16 @@ bool FileRepository::save(FileEntity &entity, QSqlError *error)
 
     if(query.lastError().type() == QSqlError::ErrorType::NoError)
     {
-        result = true;
+        if(!isExist && query.next()) // Inserted or updated row is returned
+            result = true;
+        else if(isExist && query.numRowsAffected() == 1) // Row deleted meanwhile isn't brought back
+            result = true;
+    }
+
+    query.finish(); // Statement with RETURNING stays open otherwise and blocks the commit
+
+    if(result)
+    {
         entity.setIsExist(true);
         entity.setPrimaryKey(entity.symbolFilePath());
     }
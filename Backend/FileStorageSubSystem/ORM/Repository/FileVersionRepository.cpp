@@ -1,5 +1,7 @@
 #include "FileVersionRepository.h"
 
+#include "FileHasher.h"
+
 #include <QSqlQuery>
 #include <QSqlRecord>
 
@@ -31,18 +33,24 @@ FileVersionEntity FileVersionRepository::findVersion(const QString &symbolFilePa
     bool hasNext = query.next();
 
     if(hasNext)
-    {
-        QSqlRecord record = query.record();
-        result.setIsExist(true);
-        result.symbolFilePath = record.value("symbol_file_path").toString();
-        result.versionNumber = record.value("version_number").toLongLong();
-        result.setPrimaryKey(result.symbolFilePath, result.versionNumber);
-        result.internalFileName = record.value("internal_file_name").toString();
-        result.size = record.value("size").toLongLong();
-        result.lastModifiedTimestamp = record.value("last_modified_timestamp").toDateTime();
-        result.description = record.value("description").toString();
-        result.hash = record.value("hash").toString();
-    }
+        result = entityFrom(query.record());
+
+    return result;
+}
+
+FileVersionEntity FileVersionRepository::findByInternalFileName(const QString &internalFileName) const
+{
+    FileVersionEntity result;
+
+    QSqlQuery query(database);
+    QString queryTemplate = "SELECT * FROM FileVersionEntity WHERE internal_file_name = :1;" ;
+
+    query.prepare(queryTemplate);
+    query.bindValue(":1", internalFileName);
+    query.exec();
+
+    if(query.next())
+        result = entityFrom(query.record());
 
     return result;
 }
@@ -60,21 +68,7 @@ QList<FileVersionEntity> FileVersionRepository::findAllVersions(const QString &s
     query.exec();
 
     while(query.next())
-    {
-        FileVersionEntity entity;
-        QSqlRecord record = query.record();
-        entity.setIsExist(true);
-        entity.symbolFilePath = record.value("symbol_file_path").toString();
-        entity.versionNumber = record.value("version_number").toLongLong();
-        entity.setPrimaryKey(entity.symbolFilePath, entity.versionNumber);
-        entity.internalFileName = record.value("internal_file_name").toString();
-        entity.size = record.value("size").toLongLong();
-        entity.lastModifiedTimestamp = record.value("last_modified_timestamp").toDateTime();
-        entity.description = record.value("description").toString();
-        entity.hash = record.value("hash").toString();
-
-        result.append(entity);
-    }
+        result.append(entityFrom(query.record()));
 
     return result;
 }
@@ -104,11 +98,48 @@ qlonglong FileVersionRepository::maxVersionNumber(const QString &symbolFilePath)
     return result;
 }
 
+// Versions migrated from text timestamps only have millisecond precision, they match the truncated value.
+bool FileVersionRepository::isLatestVersionMatching(const QString &symbolFilePath, qlonglong size, qint64 modifiedNsecs) const
+{
+    QSqlQuery query(database);
+    QString queryTemplate = " SELECT 1 FROM FileVersionEntity"
+                            " WHERE symbol_file_path = :1"
+                            " AND version_number = (SELECT MAX(version_number) FROM FileVersionEntity WHERE symbol_file_path = :1)"
+                            " AND size = :2 AND last_modified_ns IN (:3, :4);" ;
+
+    query.prepare(queryTemplate);
+    query.bindValue(":1", symbolFilePath);
+    query.bindValue(":2", size);
+    query.bindValue(":3", modifiedNsecs);
+    query.bindValue(":4", modifiedNsecs - modifiedNsecs % 1000000);
+    query.exec();
+
+    return query.next();
+}
+
+QList<FileVersionEntity> FileVersionRepository::findLatestVersions() const
+{
+    QList<FileVersionEntity> result;
+
+    QSqlQuery query(database);
+    QString queryTemplate = " SELECT * FROM FileVersionEntity AS version"
+                            " WHERE version_number = (SELECT MAX(version_number) FROM FileVersionEntity"
+                            "                         WHERE symbol_file_path = version.symbol_file_path);" ;
+
+    query.setForwardOnly(true);
+    query.prepare(queryTemplate);
+    query.exec();
+
+    while(query.next())
+        result.append(entityFrom(query.record()));
+
+    return result;
+}
+
 bool FileVersionRepository::save(FileVersionEntity &entity, QSqlError *error)
 {
     bool result = false;
-    bool isExist = findVersion(entity.getPrimaryKey().first,
-                               entity.getPrimaryKey().second).isExist();
+    bool isExist = entity.isExist(); // Loaded entities may be renumbered, so they are updated by their old key
 
     QSqlQuery query(database);
     QString queryTemplate;
@@ -120,9 +151,11 @@ bool FileVersionRepository::save(FileVersionEntity &entity, QSqlError *error)
                         "     version_number = :2,"
                         "     internal_file_name = :3,"
                         "     size = :4,"
-                        "     last_modified_timestamp = :5,"
+                        "     last_modified_ns = :5,"
+                        "     inode = :11,"
                         "     description = :6,"
-                        "     hash = :7 "
+                        "     hash = :7,"
+                        "     hash_algorithm = :10"
                         " WHERE symbol_file_path = :8 AND version_number = :9;" ;
     }
     else
@@ -131,10 +164,17 @@ bool FileVersionRepository::save(FileVersionEntity &entity, QSqlError *error)
                         "                                version_number,"
                         "                                internal_file_name,"
                         "                                size,"
-                        "                                last_modified_timestamp,"
+                        "                                last_modified_ns,"
+                        "                                inode,"
                         "                                description,"
-                        "                                hash)"
-                        " VALUES (:1, :2, :3, :4, :5, :6, :7);" ;
+                        "                                hash,"
+                        "                                hash_algorithm,"
+                        "                                pack_file_name,"
+                        "                                pack_offset,"
+                        "                                is_inline)"
+                        " VALUES (:1, :2, :3, :4, :5, :11, :6, :7, :10, :12, :13, :14)"
+                        " ON CONFLICT (symbol_file_path, version_number) DO NOTHING"
+                        " RETURNING version_number;" ;
     }
 
     query.prepare(queryTemplate);
@@ -144,10 +184,8 @@ bool FileVersionRepository::save(FileVersionEntity &entity, QSqlError *error)
     query.bindValue(":3", entity.internalFileName);
     query.bindValue(":4", entity.size);
 
-    if(entity.lastModifiedTimestamp.isValid())
-        query.bindValue(":5", entity.lastModifiedTimestamp);
-    else
-        query.bindValue(":5", QDateTime::currentDateTime());
+    query.bindValue(":5", entity.lastModifiedNsecs);
+    query.bindValue(":11", (qlonglong) entity.inode);
 
     if(entity.description.isEmpty())
         query.bindValue(":6", QVariant());
@@ -159,11 +197,31 @@ bool FileVersionRepository::save(FileVersionEntity &entity, QSqlError *error)
     else
         query.bindValue(":7", entity.hash);
 
+    if(entity.hashAlgorithm.isEmpty())
+        query.bindValue(":10", FileHasher::DefaultAlgorithm);
+    else
+        query.bindValue(":10", entity.hashAlgorithm);
+
     if(isExist)
     {
         query.bindValue(":8", entity.getPrimaryKey().first);
         query.bindValue(":9", entity.getPrimaryKey().second);
     }
+    else // Storage of a version changes only through updatePackLocation() afterwards
+    {
+        if(entity.packFileName.isEmpty())
+        {
+            query.bindValue(":12", QVariant());
+            query.bindValue(":13", QVariant());
+        }
+        else
+        {
+            query.bindValue(":12", entity.packFileName);
+            query.bindValue(":13", entity.packOffset);
+        }
+
+        query.bindValue(":14", entity.isInline);
+    }
 
     query.exec();
 
@@ -172,7 +230,20 @@ bool FileVersionRepository::save(FileVersionEntity &entity, QSqlError *error)
 
     if(query.lastError().type() == QSqlError::ErrorType::NoError)
     {
-        result = true;
+        if(!isExist && query.next()) // Nothing is returned when key already exists
+            result = true;
+        else if(isExist && query.numRowsAffected() == 1) // Row deleted meanwhile isn't brought back
+            result = true;
+    }
+
+    query.finish(); // Statement with RETURNING stays open otherwise and blocks the commit
+
+    // Savepoint of the write command drops the row too when its content can't be saved.
+    if(result && !isExist && entity.isInline)
+        result = saveInlineContent(entity);
+
+    if(result)
+    {
         entity.setIsExist(true);
         entity.setPrimaryKey(entity.symbolFilePath, entity.versionNumber);
     }
@@ -204,3 +275,276 @@ bool FileVersionRepository::deleteEntity(FileVersionEntity &entity, QSqlError *e
 
     return result;
 }
+
+bool FileVersionRepository::renumberVersions(const QString &symbolFilePath, qlonglong fromVersionNumber)
+{
+    // Unique key is checked per row, so versions are first moved above the current maximum, where nothing collides.
+    QSqlQuery shiftQuery(database);
+    QString shiftTemplate = " UPDATE FileVersionEntity"
+                            " SET version_number = version_number + (SELECT MAX(version_number) FROM FileVersionEntity"
+                            "                                        WHERE symbol_file_path = :1)"
+                            " WHERE symbol_file_path = :2 AND version_number >= :3;" ;
+
+    shiftQuery.prepare(shiftTemplate);
+    shiftQuery.bindValue(":1", symbolFilePath);
+    shiftQuery.bindValue(":2", symbolFilePath);
+    shiftQuery.bindValue(":3", fromVersionNumber);
+
+    if(!shiftQuery.exec())
+        return false;
+
+    QSqlQuery renumberQuery(database);
+    QString renumberTemplate = " UPDATE FileVersionEntity"
+                               " SET version_number = ranked.ordinal"
+                               " FROM (SELECT internal_file_name,"
+                               "              :1 - 1 + ROW_NUMBER() OVER (ORDER BY version_number ASC) AS ordinal"
+                               "       FROM FileVersionEntity"
+                               "       WHERE symbol_file_path = :2 AND version_number >= :3) AS ranked"
+                               " WHERE FileVersionEntity.internal_file_name = ranked.internal_file_name;" ;
+
+    renumberQuery.prepare(renumberTemplate);
+    renumberQuery.bindValue(":1", fromVersionNumber);
+    renumberQuery.bindValue(":2", symbolFilePath);
+    renumberQuery.bindValue(":3", fromVersionNumber);
+
+    return renumberQuery.exec();
+}
+
+QHash<QString, qint64> FileVersionRepository::packLiveSizes() const
+{
+    QHash<QString, qint64> result;
+
+    QSqlQuery query(database);
+    query.setForwardOnly(true);
+    query.exec(" SELECT pack_file_name, SUM(size) FROM FileVersionEntity"
+               " WHERE pack_file_name IS NOT NULL"
+               " GROUP BY pack_file_name;");
+
+    while(query.next())
+        result.insert(query.value(0).toString(), query.value(1).toLongLong());
+
+    return result;
+}
+
+QList<FileVersionEntity> FileVersionRepository::findAllInPack(const QString &packFileName) const
+{
+    QList<FileVersionEntity> result;
+
+    QSqlQuery query(database);
+    QString queryTemplate = " SELECT * FROM FileVersionEntity WHERE pack_file_name = :1"
+                            " ORDER BY pack_offset ASC;" ;
+
+    query.setForwardOnly(true);
+    query.prepare(queryTemplate);
+    query.bindValue(":1", packFileName);
+    query.exec();
+
+    while(query.next())
+        result.append(entityFrom(query.record()));
+
+    return result;
+}
+
+bool FileVersionRepository::updatePackLocation(const QString &internalFileName,
+                                               const QString &oldPackFileName,
+                                               const QString &newPackFileName,
+                                               qint64 newPackOffset)
+{
+    QSqlQuery query(database);
+    QString queryTemplate = " UPDATE FileVersionEntity"
+                            " SET pack_file_name = :1, pack_offset = :2"
+                            " WHERE internal_file_name = :3 AND pack_file_name = :4;" ;
+
+    query.prepare(queryTemplate);
+    query.bindValue(":1", newPackFileName);
+    query.bindValue(":2", newPackOffset);
+    query.bindValue(":3", internalFileName);
+    query.bindValue(":4", oldPackFileName);
+    query.exec();
+
+    return query.numRowsAffected() == 1;
+}
+
+QByteArray FileVersionRepository::findInlineContent(const QString &internalFileName) const
+{
+    QByteArray result;
+
+    QSqlQuery query(database);
+    QString queryTemplate = "SELECT content FROM FileVersionContent WHERE internal_file_name = :1;" ;
+
+    query.prepare(queryTemplate);
+    query.bindValue(":1", internalFileName);
+    query.exec();
+
+    if(query.next())
+        result = query.value(0).toByteArray();
+
+    return result;
+}
+
+QStringList FileVersionRepository::findFileNamesWithPrefix(const QString &prefix) const
+{
+    QStringList result;
+
+    if(prefix.isEmpty())
+        return result;
+
+    QSqlQuery query(database);
+    QString queryTemplate = " SELECT internal_file_name FROM FileVersionEntity"
+                            " WHERE internal_file_name >= :1 AND internal_file_name < :2"
+                            " AND pack_file_name IS NULL AND is_inline = 0"
+                            " ORDER BY internal_file_name ASC;" ;
+
+    query.setForwardOnly(true);
+    query.prepare(queryTemplate);
+    query.bindValue(":1", prefix);
+    query.bindValue(":2", prefixUpperBound(prefix));
+    query.exec();
+
+    while(query.next())
+        result.append(query.value(0).toString());
+
+    return result;
+}
+
+QStringList FileVersionRepository::findFileNamesUnderFolder(const QString &symbolFolderPath) const
+{
+    QStringList result;
+
+    if(symbolFolderPath.isEmpty())
+        return result;
+
+    // Symbol paths of files start with symbol path of their folder, so one range of the primary key covers the subtree.
+    QSqlQuery query(database);
+    QString queryTemplate = " SELECT internal_file_name FROM FileVersionEntity"
+                            " WHERE symbol_file_path >= :1 AND symbol_file_path < :2"
+                            " AND pack_file_name IS NULL AND is_inline = 0;" ;
+
+    query.setForwardOnly(true);
+    query.prepare(queryTemplate);
+    query.bindValue(":1", symbolFolderPath);
+    query.bindValue(":2", prefixUpperBound(symbolFolderPath));
+    query.exec();
+
+    while(query.next())
+        result.append(query.value(0).toString());
+
+    return result;
+}
+
+QList<FileVersionEntity> FileVersionRepository::findLeastRecentlyVerified(qint64 verifiedBeforeMsecs, int count) const
+{
+    QList<FileVersionEntity> result;
+
+    QSqlQuery query(database);
+    QString queryTemplate = " SELECT * FROM FileVersionEntity"
+                            " WHERE last_verified_at IS NULL OR last_verified_at < :1"
+                            " ORDER BY last_verified_at ASC LIMIT :2;" ;
+
+    query.setForwardOnly(true);
+    query.prepare(queryTemplate);
+    query.bindValue(":1", verifiedBeforeMsecs);
+    query.bindValue(":2", count);
+    query.exec();
+
+    while(query.next())
+        result.append(entityFrom(query.record()));
+
+    return result;
+}
+
+qlonglong FileVersionRepository::countVerifiedBefore(qint64 verifiedBeforeMsecs) const
+{
+    qlonglong result = 0;
+
+    QSqlQuery query(database);
+    QString queryTemplate = " SELECT COUNT(*) FROM FileVersionEntity"
+                            " WHERE last_verified_at IS NULL OR last_verified_at < :1;" ;
+
+    query.prepare(queryTemplate);
+    query.bindValue(":1", verifiedBeforeMsecs);
+    query.exec();
+
+    if(query.next())
+        result = query.value(0).toLongLong();
+
+    return result;
+}
+
+qlonglong FileVersionRepository::countCorrupt() const
+{
+    qlonglong result = 0;
+
+    QSqlQuery query(database);
+    query.exec("SELECT COUNT(*) FROM FileVersionEntity WHERE is_corrupt = 1;");
+
+    if(query.next())
+        result = query.value(0).toLongLong();
+
+    return result;
+}
+
+bool FileVersionRepository::updateVerifyResult(const QString &internalFileName, qint64 verifiedMsecs, bool isCorrupt)
+{
+    QSqlQuery query(database);
+    QString queryTemplate = " UPDATE FileVersionEntity"
+                            " SET last_verified_at = :1, is_corrupt = :2"
+                            " WHERE internal_file_name = :3;" ;
+
+    query.prepare(queryTemplate);
+    query.bindValue(":1", verifiedMsecs);
+    query.bindValue(":2", isCorrupt);
+    query.bindValue(":3", internalFileName);
+    query.exec();
+
+    return query.numRowsAffected() == 1;
+}
+
+bool FileVersionRepository::saveInlineContent(const FileVersionEntity &entity)
+{
+    QSqlQuery query(database);
+    QString queryTemplate = "INSERT INTO FileVersionContent (internal_file_name, content) VALUES (:1, :2);" ;
+
+    query.prepare(queryTemplate);
+    query.bindValue(":1", entity.internalFileName);
+    query.bindValue(":2", entity.inlineContent);
+
+    return query.exec();
+}
+
+FileVersionEntity FileVersionRepository::entityFrom(const QSqlRecord &record)
+{
+    FileVersionEntity result;
+
+    result.setIsExist(true);
+    result.symbolFilePath = record.value("symbol_file_path").toString();
+    result.versionNumber = record.value("version_number").toLongLong();
+    result.setPrimaryKey(result.symbolFilePath, result.versionNumber);
+    result.internalFileName = record.value("internal_file_name").toString();
+    result.size = record.value("size").toLongLong();
+    result.lastModifiedNsecs = record.value("last_modified_ns").toLongLong();
+    result.inode = record.value("inode").toULongLong();
+    result.description = record.value("description").toString();
+    result.hash = record.value("hash").toString();
+    result.hashAlgorithm = record.value("hash_algorithm").toString();
+
+    result.isInline = record.value("is_inline").toBool();
+    result.lastVerifiedMsecs = record.value("last_verified_at").toLongLong();
+    result.isCorrupt = record.value("is_corrupt").toBool();
+
+    if(!record.isNull("pack_file_name"))
+    {
+        result.packFileName = record.value("pack_file_name").toString();
+        result.packOffset = record.value("pack_offset").toLongLong();
+    }
+
+    return result;
+}
+
+QString FileVersionRepository::prefixUpperBound(const QString &prefix)
+{
+    QString result = prefix;
+    result.back() = QChar(result.back().unicode() + 1);
+
+    return result;
+}
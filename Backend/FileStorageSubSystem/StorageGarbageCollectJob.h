@@ -0,0 +1,36 @@
+#ifndef STORAGEGARBAGECOLLECTJOB_H
+#define STORAGEGARBAGECOLLECTJOB_H
+
+#include "Utility/BackgroundJob.h"
+
+#include <atomic>
+
+// Deletes version files of the storage folder which no version refers to, and reports versions whose file is missing.
+// Each shard is checked with a sorted merge of its directory listing and one range query, no per file lookups.
+class StorageGarbageCollectJob : public BackgroundJob
+{
+public:
+    static const inline int ScanThreadCount = 4;
+    static const inline qint64 MinOrphanAgeSecs = 3600; // A new version's file exists a moment before its row
+    static const inline qint64 UnlinkCost = 4096; // Charged to background budget per deleted file
+
+    StorageGarbageCollectJob(const QString &storageFolderPath);
+
+    qint64 getOrphanCount() const;
+    qint64 getReclaimedBytes() const;
+    qint64 getMissingCount() const;
+
+protected:
+    bool run() override;
+
+private:
+    void scanShard(const QString &prefix);
+
+    QString storageFolderPath;
+
+    std::atomic<qint64> orphanCount = 0;
+    std::atomic<qint64> reclaimedBytes = 0;
+    std::atomic<qint64> missingCount = 0;
+};
+
+#endif // STORAGEGARBAGECOLLECTJOB_H
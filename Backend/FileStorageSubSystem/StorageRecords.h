@@ -0,0 +1,52 @@
+#ifndef STORAGERECORDS_H
+#define STORAGERECORDS_H
+
+#include <QList>
+#include <QString>
+
+// Typed results of FileStorageManager, converted to json only when they leave the process.
+
+struct FileVersionRecord
+{
+    bool isExist = false;
+    QString symbolFilePath;
+    qlonglong versionNumber = 0;
+    QString internalFileName;
+    qlonglong size = 0;
+    qint64 lastModifiedNsecs = 0; // Since epoch, 0 when unknown
+    quint64 inode = 0;
+    QString packFileName; // Empty when version is stored as its own file
+    qint64 packOffset = -1;
+    bool isInline = false; // Content is stored in the database
+    QString description;
+    QString hash;
+    QString hashAlgorithm;
+    qint64 lastVerifiedMsecs = 0; // Since epoch, 0 when never verified
+    bool isCorrupt = false;
+};
+
+struct FileRecord
+{
+    bool isExist = false;
+    QString fileName;
+    QString symbolFolderPath;
+    QString symbolFilePath;
+    QString userFilePath; // Empty when file is frozen or parent folder is not monitored
+    bool isFrozen = false;
+    qlonglong maxVersionNumber = 0;
+    QList<FileVersionRecord> versionList;
+};
+
+struct FolderRecord
+{
+    bool isExist = false;
+    QString parentFolderPath;
+    QString suffixPath;
+    QString symbolFolderPath;
+    QString userFolderPath; // Empty when folder is frozen
+    bool isFrozen = false;
+    QList<FolderRecord> childFolders;
+    QList<FileRecord> childFiles;
+};
+
+#endif // STORAGERECORDS_H
@@ -1,5 +1,6 @@
 import path from 'node:path';
 import fs from 'node:fs/promises';
+import { constants as fsConstants } from 'node:fs';
 import { fileURLToPath } from 'url';
 import { tmpdir } from 'os';
 import { randomUUID } from 'crypto';
@@ -12,6 +13,55 @@ import { shell } from 'electron';
 const __filename = fileURLToPath(import.meta.url); // get the resolved path to the file
 const __dirname = path.dirname(__filename); // get the name of the directory
 
+// Version files are sharded as ab/cd/abcd....file under storage folder, older stores may still keep them flat.
+// Same rule as StorageLayout of the server.
+async function resolveVersionFilePath(flatPath) {
+  const name = path.basename(flatPath);
+
+  if(name.length <= 4)
+    return flatPath;
+
+  const shardedPath = path.join(path.dirname(flatPath), name.substring(0, 2).toLowerCase(), name.substring(2, 4).toLowerCase(), name);
+
+  try {
+    await fs.access(shardedPath);
+    return shardedPath;
+  } catch {
+    return flatPath;
+  }
+}
+
+// Reflinks on copy on write file systems, libuv falls back to copy_file_range/sendfile and then a regular copy.
+// Packed versions are a byte range of a pack file, given with range.
+// Inline versions come from the server as content, there is no file to copy.
+async function copyVersionFile(srcPath, destPath, range, content) {
+  if(content) {
+    await fs.writeFile(destPath, content);
+    return;
+  }
+
+  if(range) {
+    const packFile = await fs.open(srcPath, 'r');
+
+    try {
+      const data = Buffer.alloc(range.length);
+      const { bytesRead } = await packFile.read(data, 0, range.length, range.offset);
+
+      if(bytesRead !== range.length)
+        throw new Error(`Pack entry at ${range.offset} is truncated`);
+
+      await fs.writeFile(destPath, data);
+    } finally {
+      await packFile.close();
+    }
+
+    return;
+  }
+
+  const resolvedPath = await resolveVersionFilePath(srcPath);
+  await fs.copyFile(resolvedPath, destPath, fsConstants.COPYFILE_FICLONE);
+}
+
 function splitPath(givenPath) {
   return givenPath.split(path.sep);
 }
@@ -21,8 +71,7 @@ function fileNameWithExtension(givenPath) {
 }
 
 // TODO: add file existence check by filePath.
-// TODO: Maybe move file copying part to separate function.
-async function previewFile(filePath, fileExtension) {
+async function previewFile(filePath, fileExtension, range, content) {
   let tempPath = tmpdir();
 
   if(!tempPath.endsWith(path.sep))
@@ -40,7 +89,7 @@ async function previewFile(filePath, fileExtension) {
   }
 
   try {
-    await fs.copyFile(filePath, tempFilePath);
+    await copyVersionFile(filePath, tempFilePath, range, content);
     await shell.openPath(tempFilePath); // TODO: Add temp file cleaning.
     return true;
   } catch(error) {
@@ -49,10 +98,9 @@ async function previewFile(filePath, fileExtension) {
   }
 }
 
-// TODO: Maybe move file copying part to separate function.
-async function extractFile(srcPath, destPath) {
+async function extractFile(srcPath, destPath, range, content) {
   try {
-    await fs.copyFile(srcPath, destPath);
+    await copyVersionFile(srcPath, destPath, range, content);
     shell.showItemInFolder(destPath);
     return true;
   } catch (error) {
@@ -68,6 +68,20 @@ function createListItem(versionInfo) {
     return button;
 }
 
+// Small versions are stored inside pack files, range tells where. Tiny ones are stored in the database.
+async function versionSource(storagePath, versionInfo) {
+    if(versionInfo.isInline) {
+        const fileApi = new FileApi("localhost", 1234);
+        const content = await fileApi.getInlineContent(versionInfo.symbolFilePath, versionInfo.versionNumber);
+        return {path: null, range: null, content: content};
+    }
+
+    if(versionInfo.packFileName)
+        return {path: storagePath + versionInfo.packFileName, range: {offset: versionInfo.packOffset, length: versionInfo.size}, content: null};
+
+    return {path: storagePath + versionInfo.internalFileName, range: null, content: null};
+}
+
 async function onClickHandler_buttonPreview() {
     const folderApi = new FolderApi("localhost", 1234);
     const versionInfo = await window.appState.get("currentVersion");
@@ -78,7 +92,8 @@ async function onClickHandler_buttonPreview() {
 
     displayAlertDiv("Generating file preview, please wait...");
     disableUserControls();
-    const result = await window.fsApi.previewFile(storagePath + versionInfo.internalFileName, extension);
+    const source = await versionSource(storagePath, versionInfo);
+    const result = await window.fsApi.previewFile(source.path, extension, source.range, source.content);
     enableUserControls();
     closeAlertDiv();
 
@@ -114,13 +129,13 @@ async function onClickHandler_buttonSelectPath() {
 async function onClickHandler_buttonExtract() {
     const folderApi = new FolderApi("localhost", 1234);
     const version = await window.appState.get("currentVersion");
-    let src = await folderApi.getStorageFolderPath();
-    src += version.internalFileName;
+    const storagePath = await folderApi.getStorageFolderPath();
+    const source = await versionSource(storagePath, version);
     const dest = document.getElementById("input-extract-path").value;
 
     displayAlertDiv("Extracting file, please wait...");
     disableUserControls();
-    const result = await window.fsApi.extractFile(src, dest);
+    const result = await window.fsApi.extractFile(source.path, dest, source.range, source.content);
     enableUserControls();
     closeAlertDiv();
 
@@ -20,13 +20,11 @@ document.addEventListener("DOMContentLoaded", async (event) => {
 
     appendLog(textAreaLog, "ℹ️ Deleting these folders including all child files & folders:");
 
-    let reversedFolders = Array.from(deletedJson.folders);
-    reversedFolders.reverse(); // TODO: improve outputs without using this
-    // We are using reverse to delete leaf first
-    // When deletion starts from roots, child items shown as error in log
-    // This due to deleting roots also deletes children on the server.
+    // Server deletes a folder with its whole subtree at once, so only top most deleted folders are sent.
+    const rootFolders = deletedJson.folders.filter(folder =>
+      !deletedJson.folders.some(other => other !== folder && folder.startsWith(other)));
 
-    for (const currentFolder of reversedFolders) {
+    for (const currentFolder of rootFolders) {
       const folderJson = await folderApi.getByUserPath(currentFolder);
       appendLog(textAreaLog, `\t 👉 Deleting folder ${folderJson.userFolderPath} with contents...`);
       const response = await folderApi.delete(folderJson.symbolFolderPath);
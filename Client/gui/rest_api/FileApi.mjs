@@ -38,6 +38,31 @@ export default class FileApi extends BaseApi {
       return await postJSON(`http://${this.host}:${this.port}/file/append`, requestBody);    
     }
 
+    // Content of a version stored in the database as Uint8Array, null on failure.
+    async getInlineContent(symbolFilePath, versionNumber) {
+      let requestBody = {};
+      requestBody["symbolPath"] = symbolFilePath;
+      requestBody["versionNumber"] = versionNumber;
+
+      try {
+        const response = await fetch(`http://${this.host}:${this.port}/file/version/inlineContent`, {
+          method: "POST",
+          headers: {
+            "Content-Type": "application/json",
+          },
+          body: JSON.stringify(requestBody),
+        });
+
+        if (!response.ok)
+          throw new Error('Network response was not ok');
+
+        return new Uint8Array(await response.arrayBuffer());
+      } catch (error) {
+        console.error("Error:", error);
+        return null;
+      }
+    }
+
     async delete(symbolFilePath) {
       let requestBody = {};
       requestBody["symbolPath"] = symbolFilePath;
@@ -47,12 +47,12 @@ app.whenReady().then(() => {
     return fileNameWithExtension(input);
   });
 
-  ipcMain.handle('fs:Preview', async (event, path, extension) => {
-    return await previewFile(path, extension);
+  ipcMain.handle('fs:Preview', async (event, path, extension, range, content) => {
+    return await previewFile(path, extension, range, content);
   });
 
-  ipcMain.handle('fs:Extract', async (event, srcPath, destPath) => {
-    return await extractFile(srcPath, destPath);
+  ipcMain.handle('fs:Extract', async (event, srcPath, destPath, range, content) => {
+    return await extractFile(srcPath, destPath, range, content);
   });
 
   ipcMain.handle('state:Get', async (event, key) => {
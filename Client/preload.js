@@ -33,17 +33,17 @@ contextBridge.exposeInMainWorld('fsApi', {
     });
   },
 
-  previewFile: (path, extension) => {
+  previewFile: (path, extension, range, content) => {
     return new Promise((resolve, reject) => {
-      ipcRenderer.invoke('fs:Preview', path, extension)
+      ipcRenderer.invoke('fs:Preview', path, extension, range, content)
         .then(resolve)
         .catch(reject);
     });
   },
 
-  extractFile: (srcPath, destPath) => {
+  extractFile: (srcPath, destPath, range, content) => {
     return new Promise((resolve, reject) => {
-      ipcRenderer.invoke('fs:Extract', srcPath, destPath)
+      ipcRenderer.invoke('fs:Extract', srcPath, destPath, range, content)
         .then(resolve)
         .catch(reject);
     });
@@ -26,27 +26,27 @@ QWidget *ItemDelegateAction::createEditor(QWidget *parent, const QStyleOptionVie
     TreeItem *item = static_cast<TreeItem*>(index.internalPointer());
     auto treeModel = (Model *) index.model();
 
+    // Default actions are set by the model when items are fetched.
     if(item->getType() == TreeItem::ItemType::Folder)
     {
-        item->setAction(TreeItem::Action::ChooseEachChildren);
-
         result->addItem(ITEM_TEXT_CHOOSE_EACH_CHILDREN);
         result->addItem(ITEM_TEXT_DO_NOT_IMPORT);
     }
     else if(item->getType() == TreeItem::ItemType::File)
     {
         if(item->getStatus() == TreeItem::Status::NewFile)
-        {
-            item->setAction(TreeItem::Action::Import);
             result->addItem(ITEM_TEXT_IMPORT);
-        }
         else if(item->getStatus() == TreeItem::Status::ExistingFile)
-        {
-            item->setAction(TreeItem::Action::Overwrite);
             result->addItem(ITEM_TEXT_OVERWRITE);
-        }
 
         result->addItem(ITEM_TEXT_DO_NOT_IMPORT);
+
+        // Files fetched after their folder is excluded
+        if(item->getAction() == TreeItem::Action::DoNotImport)
+        {
+            result->setCurrentIndex(result->findText(ITEM_TEXT_DO_NOT_IMPORT));
+            result->setDisabled(true);
+        }
     }
     else
     {
@@ -69,12 +69,8 @@ QWidget *ItemDelegateAction::createEditor(QWidget *parent, const QStyleOptionVie
 
             if(item->getType() == TreeItem::ItemType::Folder)
             {
-                // NOTE: this loop may ruin performance, improve this in future
-                for(int index = 0; index < item->childCount(); index++)
-                {
-                    if(item->child(index)->getAction() != TreeItem::Action::DoNotImport)
-                        return;
-                }
+                if(!treeModel->isEveryFileSkipped(item))
+                    return;
 
                 item->setAction(TreeItem::Action::DoNotImport);
                 int cbIndex = result->findText(ITEM_TEXT_DO_NOT_IMPORT);
@@ -6,16 +6,17 @@ TreeItem::TreeItem(TreeItem *parentItem)
 {
     setParentItem(parentItem);
     setName("");
-    setSymbolFolderPath("");
     setType(ItemType::Undefined);
     setAction(Action::NotSelected);
     setStatus(Status::NotSet);
     setResult(Result::Waiting);
+    setSourceIndex(-1);
+    setRow(0);
 }
 
 TreeItem::~TreeItem()
 {
-    qDeleteAll(childItems);
+    // Items are owned by the arena of the model.
 }
 
 TreeItem *TreeItem::getParentItem() const
@@ -30,12 +31,10 @@ void TreeItem::setParentItem(TreeItem *newParentItem)
 
 QString TreeItem::getSymbolFolderPath() const
 {
-    return symbolFolderPath;
-}
+    if(getType() == ItemType::File && getParentItem() != nullptr)
+        return getParentItem()->getName();
 
-void TreeItem::setSymbolFolderPath(const QString &newSymbolFolderPath)
-{
-    symbolFolderPath = newSymbolFolderPath;
+    return name;
 }
 
 QString TreeItem::getName() const
@@ -78,11 +77,6 @@ void TreeItem::setStatus(Status newStatus)
     status = newStatus;
 }
 
-QJsonObject TreeItem::getFileJson() const
-{
-    return fileJson;
-}
-
 TreeItem::Result TreeItem::getResult() const
 {
     return result;
@@ -93,19 +87,19 @@ void TreeItem::setResult(Result newResult)
     result = newResult;
 }
 
-void TreeItem::setFileJson(const QJsonObject &newFileJson)
+int TreeItem::getSourceIndex() const
 {
-    fileJson = newFileJson;
+    return sourceIndex;
 }
 
-QModelIndex TreeItem::getModelIndex() const
+void TreeItem::setSourceIndex(int newSourceIndex)
 {
-    return modelIndex;
+    sourceIndex = newSourceIndex;
 }
 
-void TreeItem::setModelIndex(const QModelIndex &newModelIndex)
+void TreeItem::setRow(int newRow)
 {
-    modelIndex = newModelIndex;
+    rowNumber = newRow;
 }
 
 void TreeItem::appendChild(TreeItem *item)
@@ -130,10 +124,8 @@ int TreeItem::columnCount() const
     return ColumnCount;
 }
 
+// Children are only appended, so row is kept instead of searched.
 int TreeItem::row() const
 {
-    if (getParentItem() != nullptr)
-        return getParentItem()->childItems.indexOf(const_cast<TreeItem*>(this));
-
-    return 0;
+    return rowNumber;
 }
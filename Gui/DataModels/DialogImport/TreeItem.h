@@ -3,8 +3,6 @@
 
 #include <QList>
 #include <QVariant>
-#include <QJsonObject>
-#include <QPersistentModelIndex>
 
 namespace TreeModelDialogImport
 {
@@ -55,9 +53,10 @@ public:
     TreeItem *getParentItem() const;
     void setParentItem(TreeItem *newParentItem);
 
+    // Folders return their own path, files the path of their parent folder.
     QString getSymbolFolderPath() const;
-    void setSymbolFolderPath(const QString &newSymbolFolderPath);
 
+    // Symbol folder path for folders, file name for files.
     QString getName() const;
     void setName(const QString &newName);
 
@@ -73,11 +72,11 @@ public:
     Result getResult() const;
     void setResult(Result newResult);
 
-    QJsonObject getFileJson() const;
-    void setFileJson(const QJsonObject &newFileJson);
+    // Folder number for folders, position in the import json array for files.
+    int getSourceIndex() const;
+    void setSourceIndex(int newSourceIndex);
 
-    QModelIndex getModelIndex() const;
-    void setModelIndex(const QModelIndex &newModelIndex);
+    void setRow(int newRow);
 
     void appendChild(TreeItem *child);
 
@@ -87,14 +86,13 @@ public:
     int row() const;
 
 private:
-    QString symbolFolderPath;
     QString name;
     ItemType type;
     Action action;
     Status status;
     Result result;
-    QJsonObject fileJson;
-    QPersistentModelIndex modelIndex;
+    int sourceIndex;
+    int rowNumber;
     QList<TreeItem *> childItems;
     TreeItem *parentItem;
 };
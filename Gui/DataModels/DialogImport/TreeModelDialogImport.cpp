@@ -9,56 +9,97 @@ using namespace TreeModelDialogImport;
 
 Model::Model(QJsonArray array, QObject *parent) : QAbstractItemModel(parent)
 {
-    treeRoot = new TreeItem();
+    treeRoot = itemArena.create();
+    isFetchLocked = false;
+    fileArray = array;
 
-    QMultiMap<QString, TreeItem *> multiFolderMap;
+    // Only grouping is done here, items and storage lookups wait until they are fetched.
+    QMap<QString, QList<int>> folderFileMap;
 
-    for(const QJsonValue &currentValue : array)
+    for(int index = 0; index < fileArray.size(); index++)
     {
-        QJsonObject fileJson = currentValue.toObject();
-        TreeItem *item = createTreeItemFile(fileJson, nullptr);
-
-        symbolFileMap.insert(fileJson[JsonKeys::File::SymbolFilePath].toString(), item);
-        multiFolderMap.insert(fileJson[JsonKeys::File::SymbolFolderPath].toString(), item);
+        QJsonObject fileJson = fileArray.at(index).toObject();
+        folderFileMap[fileJson[JsonKeys::File::SymbolFolderPath].toString()].append(index);
     }
 
-    for(const QString &symbolFolderPath : multiFolderMap.uniqueKeys())
-    {
-        TreeItem *currentFolder = createTreeItemFolder(symbolFolderPath, treeRoot);
-        treeRoot->appendChild(currentFolder);
-
-        for(TreeItem *item : multiFolderMap.values(symbolFolderPath))
-        {
-            item->setParentItem(currentFolder);
-            currentFolder->appendChild(item);
-        }
-
-        folderItemMap.insert(symbolFolderPath,currentFolder);
-    }
+    folderPathList = folderFileMap.keys();
+    folderFileTable = folderFileMap.values();
 }
 
 Model::~Model()
 {
-    delete treeRoot;
+
 }
 
 int Model::getTotalFileCount() const
 {
-    int result = 0;
+    return fileArray.size();
+}
 
-    for(int index = 0; index < treeRoot->childCount(); index++)
-        result += treeRoot->child(index)->childCount();
+int Model::getFolderCount() const
+{
+    return folderPathList.size();
+}
+
+QString Model::getSymbolFolderPath(int folderNumber) const
+{
+    return folderPathList.at(folderNumber);
+}
+
+int Model::getFileCountOfFolder(int folderNumber) const
+{
+    return folderFileTable.at(folderNumber).size();
+}
+
+bool Model::isFolderImported(int folderNumber) const
+{
+    TreeItem *folderItem = treeRoot->child(folderNumber);
+
+    return folderItem == nullptr || folderItem->getAction() != TreeItem::Action::DoNotImport;
+}
+
+QList<QJsonObject> Model::getFileJsonListToImport(int folderNumber) const
+{
+    QList<QJsonObject> result;
+
+    if(!isFolderImported(folderNumber))
+        return result;
+
+    TreeItem *folderItem = treeRoot->child(folderNumber);
+    const QList<int> &fileIndexList = folderFileTable.at(folderNumber);
+
+    for(int row = 0; row < fileIndexList.size(); row++)
+    {
+        TreeItem *fileItem = folderItem != nullptr ? folderItem->child(row) : nullptr;
+
+        if(fileItem == nullptr ||
+           fileItem->getAction() == TreeItem::Action::Import ||
+           fileItem->getAction() == TreeItem::Action::Overwrite)
+        {
+            result.append(fileArray.at(fileIndexList.at(row)).toObject());
+        }
+    }
 
     return result;
 }
 
-QMap<QString, TreeItem *> Model::getFolderItemMap() const
+bool Model::isEveryFileSkipped(TreeItem *folderItem) const
 {
-    return folderItemMap;
+    if(folderItem->childCount() < childCountOf(folderItem)) // Not fetched files are imported
+        return false;
+
+    for(int index = 0; index < folderItem->childCount(); index++)
+    {
+        if(folderItem->child(index)->getAction() != TreeItem::Action::DoNotImport)
+            return false;
+    }
+
+    return true;
 }
 
 void Model::disableComboBoxes()
 {
+    isFetchLocked = true;
     emit layoutChanged(); // Allow comboxes to expand when result column is updated
     emit signalDisableItemDelegates();
 }
@@ -116,11 +157,7 @@ QModelIndex Model::index(int row, int column, const QModelIndex &parent) const
 
     TreeItem *childItem = parentItem->child(row);
     if (childItem)
-    {
-        QModelIndex result = createIndex(row, column, childItem);
-        childItem->setModelIndex(result);
-        return result;
-    }
+        return createIndex(row, column, childItem);
 
     return QModelIndex();
 }
@@ -250,15 +287,69 @@ QVariant Model::data(const QModelIndex &index, int role) const
     return QVariant();
 }
 
-TreeItem *Model::createTreeItemFolder(const QString &symbolFolderPath, TreeItem *parentItem) const
+bool Model::hasChildren(const QModelIndex &parent) const
 {
-    TreeItem *result = new TreeItem(parentItem);
-    result->setSymbolFolderPath(symbolFolderPath);
+    if(parent.column() > 0)
+        return false;
+
+    return childCountOf(itemOfIndex(parent)) > 0;
+}
+
+bool Model::canFetchMore(const QModelIndex &parent) const
+{
+    if(isFetchLocked || parent.column() > 0)
+        return false;
+
+    TreeItem *item = itemOfIndex(parent);
+
+    return item->childCount() < childCountOf(item);
+}
+
+void Model::fetchMore(const QModelIndex &parent)
+{
+    TreeItem *parentItem = itemOfIndex(parent);
+
+    int first = parentItem->childCount();
+    int last = childCountOf(parentItem) - 1;
+
+    if(parentItem == treeRoot)
+        last = qMin(last, first + FolderFetchBatchSize - 1);
+
+    if(last < first)
+        return;
+
+    beginInsertRows(parent, first, last);
+
+    for(int row = first; row <= last; row++)
+    {
+        TreeItem *item = nullptr;
+
+        if(parentItem == treeRoot)
+            item = createTreeItemFolder(row, parentItem);
+        else
+            item = createTreeItemFile(folderFileTable.at(parentItem->getSourceIndex()).at(row), parentItem);
+
+        item->setRow(row);
+        parentItem->appendChild(item);
+    }
+
+    endInsertRows();
+}
+
+TreeItem *Model::createTreeItemFolder(int folderNumber, TreeItem *parentItem)
+{
+    QString symbolFolderPath = folderPathList.at(folderNumber);
+
+    TreeItem *result = itemArena.create();
+    result->setParentItem(parentItem);
+    result->setName(symbolFolderPath);
     result->setType(TreeItem::ItemType::Folder);
+    result->setSourceIndex(folderNumber);
+    result->setAction(TreeItem::Action::ChooseEachChildren);
 
     auto fsm = FileStorageManager::instance();
 
-    if(fsm->getFolderJsonBySymbolPath(symbolFolderPath)[JsonKeys::IsExist].toBool())
+    if(fsm->getFolderBySymbolPath(symbolFolderPath).isExist)
         result->setStatus(TreeItem::Status::ExistingFolder);
     else
         result->setStatus(TreeItem::Status::NewFolder);
@@ -266,32 +357,81 @@ TreeItem *Model::createTreeItemFolder(const QString &symbolFolderPath, TreeItem
     return result;
 }
 
-TreeItem *Model::createTreeItemFile(QJsonObject fileJson, TreeItem *parentItem) const
+TreeItem *Model::createTreeItemFile(int fileIndex, TreeItem *parentItem)
 {
-    TreeItem *result = new TreeItem(parentItem);
-    result->setName(fileJson[JsonKeys::File::FileName].toString());
-    result->setSymbolFolderPath(fileJson[JsonKeys::File::SymbolFolderPath].toString());
+    QJsonObject fileJson = fileArray.at(fileIndex).toObject();
+
+    TreeItem *result = itemArena.create();
+    result->setParentItem(parentItem);
+    result->setName(segmentPool.intern(fileJson[JsonKeys::File::FileName].toString()));
     result->setType(TreeItem::ItemType::File);
-    result->setFileJson(fileJson);
+    result->setSourceIndex(fileIndex);
+    result->setResult(fileResultTable.take(fileIndex));
 
     QString symbolFilePath = fileJson[JsonKeys::File::SymbolFilePath].toString();
 
     auto fsm = FileStorageManager::instance();
 
-    if(fsm->getFileJsonBySymbolPath(symbolFilePath)[JsonKeys::IsExist].toBool())
+    if(fsm->getFileBySymbolPath(symbolFilePath).isExist)
         result->setStatus(TreeItem::Status::ExistingFile);
     else
         result->setStatus(TreeItem::Status::NewFile);
 
+    if(parentItem->getAction() == TreeItem::Action::DoNotImport)
+        result->setAction(TreeItem::Action::DoNotImport);
+    else if(result->getStatus() == TreeItem::Status::ExistingFile)
+        result->setAction(TreeItem::Action::Overwrite);
+    else
+        result->setAction(TreeItem::Action::Import);
+
+    fileItemTable.insert(fileIndex, result);
+
     return result;
 }
 
+// Number of children when everything is fetched.
+int Model::childCountOf(const TreeItem *item) const
+{
+    int result = 0;
+
+    if(item == treeRoot)
+        result = folderPathList.size();
+    else if(item->getType() == TreeItem::ItemType::Folder)
+        result = folderFileTable.at(item->getSourceIndex()).size();
+
+    return result;
+}
+
+TreeItem *Model::itemOfIndex(const QModelIndex &index) const
+{
+    if(!index.isValid())
+        return treeRoot;
+
+    return static_cast<TreeItem*>(index.internalPointer());
+}
+
 void Model::markFile(const QString &symbolFilePath, TreeItem::Result result)
 {
-    if(!symbolFileMap.contains(symbolFilePath))
+    if(symbolFileMap.isEmpty())
+    {
+        for(int index = 0; index < fileArray.size(); index++)
+            symbolFileMap.insert(fileArray.at(index).toObject()[JsonKeys::File::SymbolFilePath].toString(), index);
+    }
+
+    auto iterator = symbolFileMap.constFind(symbolFilePath);
+
+    if(iterator == symbolFileMap.constEnd())
         return;
 
-    TreeItem *item = symbolFileMap.value(symbolFilePath);
+    TreeItem *item = fileItemTable.value(iterator.value());
+
+    if(item == nullptr)
+    {
+        fileResultTable.insert(iterator.value(), result);
+        return;
+    }
+
     item->setResult(result);
-    emit dataChanged(item->getModelIndex(), item->getModelIndex());
+    emit dataChanged(createIndex(item->row(), ColumnIndexSymbolPath, item),
+                     createIndex(item->row(), ColumnIndexResult, item));
 }
@@ -6,6 +6,8 @@
 #include <QAbstractItemModel>
 
 #include "TreeItem.h"
+#include "DataModels/TreeItemArena.h"
+#include "DataModels/PathSegmentPool.h"
 
 namespace TreeModelDialogImport
 {
@@ -22,11 +24,23 @@ public:
     static const inline int ColumnIndexAction = 2;
     static const inline int ColumnIndexResult = 3;
 
+    // Folders are fetched in batches of this size, files of a folder all at once.
+    static const inline int FolderFetchBatchSize = 256;
+
     explicit Model(QJsonArray array, QObject *parent = nullptr);
     ~Model();
 
     int getTotalFileCount() const;
-    QMap<QString, TreeItem *> getFolderItemMap() const;
+
+    // Functions below cover not fetched items too; files without an item follow their folder.
+    int getFolderCount() const;
+    QString getSymbolFolderPath(int folderNumber) const;
+    int getFileCountOfFolder(int folderNumber) const;
+    bool isFolderImported(int folderNumber) const;
+    QList<QJsonObject> getFileJsonListToImport(int folderNumber) const;
+    bool isEveryFileSkipped(TreeItem *folderItem) const;
+
+    // Also stops fetching, so importing thread sees a fixed tree.
     void disableComboBoxes();
     void markFileAsPending(const QString &symbolFilePath);
     void markFileAsSuccessful(const QString &symbolFilePath);
@@ -38,18 +52,32 @@ public:
     int rowCount(const QModelIndex &parent = QModelIndex()) const override;
     int columnCount(const QModelIndex &parent = QModelIndex()) const override;
     QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    bool hasChildren(const QModelIndex &parent = QModelIndex()) const override;
+    bool canFetchMore(const QModelIndex &parent) const override;
+    void fetchMore(const QModelIndex &parent) override;
 
 signals:
     void signalDisableItemDelegates();
 
 private:
-    TreeItem *createTreeItemFolder(const QString &symbolFolderPath, TreeItem *parentItem) const;
-    TreeItem *createTreeItemFile(QJsonObject fileJson, TreeItem *parentItem) const;
+    TreeItem *createTreeItemFolder(int folderNumber, TreeItem *parentItem);
+    TreeItem *createTreeItemFile(int fileIndex, TreeItem *parentItem);
+    int childCountOf(const TreeItem *item) const;
+    TreeItem *itemOfIndex(const QModelIndex &index) const;
     void markFile(const QString &symbolFilePath, TreeItem::Result result);
 
+    TreeItemArena<TreeItem> itemArena;
+    PathSegmentPool segmentPool;
     TreeItem *treeRoot;
-    QMap<QString, TreeItem *> folderItemMap;
-    QHash<QString, TreeItem *> symbolFileMap; // Used for result update
+    bool isFetchLocked;
+
+    QJsonArray fileArray;
+    QStringList folderPathList;
+    QList<QList<int>> folderFileTable; // File positions in fileArray for each folder
+
+    QHash<QString, int> symbolFileMap; // Used for result update, built on first use
+    QHash<int, TreeItem *> fileItemTable;
+    QHash<int, TreeItem::Result> fileResultTable; // Results of files which aren't fetched yet
 };
 
 #endif // TREEMODELDIALOGIMPORT_H
@@ -0,0 +1,31 @@
+#ifndef PATHSEGMENTPOOL_H
+#define PATHSEGMENTPOOL_H
+
+#include <QSet>
+#include <QString>
+
+// Tree items keep only their own path segment; equal segments share one string buffer.
+class PathSegmentPool
+{
+public:
+    QString intern(const QString &segment)
+    {
+        auto iterator = pool.constFind(segment);
+
+        if(iterator != pool.constEnd())
+            return *iterator;
+
+        pool.insert(segment);
+        return segment;
+    }
+
+    void clear()
+    {
+        pool.clear();
+    }
+
+private:
+    QSet<QString> pool;
+};
+
+#endif // PATHSEGMENTPOOL_H
@@ -1,19 +1,25 @@
 #include "TableModelFileExplorer.h"
 
-#include "Utility/JsonDtoFormat.h"
+#include "Backend/FileStorageSubSystem/FileStorageManager.h"
 
 #include <QDir>
 #include <QColor>
+#include <QDateTime>
+#include <QLocale>
 #include <QPixmap>
-#include <QJsonArray>
-#include <QJsonObject>
+#include <QtConcurrent>
 #include <QStandardPaths>
 #include <QFileIconProvider>
 
-TableModelFileExplorer::TableModelFileExplorer(QJsonObject result, QObject *parent)
+TableModelFileExplorer::TableModelFileExplorer(const QString &symbolFolderPath, QObject *parent)
     : QAbstractTableModel(parent)
 {
-    itemList = tableItemListFrom(result);
+    this->symbolFolderPath = symbolFolderPath;
+    sortKey = FolderListingPage::SortKey::Name;
+    sortOrder = Qt::SortOrder::AscendingOrder;
+    isLastPageFetched = false;
+    isFetchInProgress = false;
+    generation = 0;
 }
 
 QString TableModelFileExplorer::getNameFromModelIndex(const QModelIndex &index) const
@@ -60,7 +66,12 @@ TableModelFileExplorer::TableItemType TableModelFileExplorer::getItemTypeFromMod
     TableItemType result = TableItemType::Invalid;
 
     if(index.isValid())
-        result = itemList.at(index.row()).type;
+    {
+        if(itemList.at(index.row()).isFolder)
+            result = TableItemType::Folder;
+        else
+            result = TableItemType::File;
+    }
 
     return result;
 }
@@ -72,7 +83,7 @@ int TableModelFileExplorer::rowCount(const QModelIndex &parent) const
 
 int TableModelFileExplorer::columnCount(const QModelIndex &parent) const
 {
-    return parent.isValid() ? 0 : 5;
+    return parent.isValid() ? 0 : 7;
 }
 
 QVariant TableModelFileExplorer::data(const QModelIndex &index, int role) const
@@ -83,7 +94,7 @@ QVariant TableModelFileExplorer::data(const QModelIndex &index, int role) const
     if (index.row() >= itemList.size() || index.row() < 0)
         return QVariant();
 
-    const TableItem item = itemList.at(index.row());
+    const FolderListingItem &item = itemList.at(index.row());
 
     if (role == Qt::ItemDataRole::DisplayRole)
     {
@@ -101,7 +112,19 @@ QVariant TableModelFileExplorer::data(const QModelIndex &index, int role) const
                 else
                     return tr("No");
             case ColumnIndexItemType:
-                return item.type;
+                return item.isFolder ? TableItemType::Folder : TableItemType::File;
+            case ColumnIndexSize:
+                if(item.isFolder)
+                    return QVariant();
+                return QLocale().formattedDataSize(item.size);
+            case ColumnIndexLastModified:
+            {
+                if(item.isFolder)
+                    return QVariant();
+
+                QDateTime lastModified = QDateTime::fromMSecsSinceEpoch(item.lastModifiedNsecs / 1000000);
+                return QLocale().toString(lastModified, QLocale::FormatType::ShortFormat);
+            }
             default:
                 break;
         }
@@ -110,10 +133,10 @@ QVariant TableModelFileExplorer::data(const QModelIndex &index, int role) const
     {
         QFileIconProvider provider;
 
-        if(item.type == TableModelFileExplorer::TableItemType::Folder)
+        if(item.isFolder)
             return provider.icon(QFileIconProvider::IconType::Folder);
 
-        else if(item.type == TableModelFileExplorer::TableItemType::File)
+        else
         {
             QString iconFilePath = QStandardPaths::writableLocation(QStandardPaths::StandardLocation::TempLocation);
             iconFilePath = QDir::toNativeSeparators(iconFilePath) + QDir::separator();
@@ -138,6 +161,10 @@ QVariant TableModelFileExplorer::data(const QModelIndex &index, int role) const
     {
         return Qt::AlignmentFlag::AlignCenter;
     }
+    else if(role == Qt::ItemDataRole::TextAlignmentRole && index.column() == ColumnIndexSize)
+    {
+        return QVariant(Qt::AlignmentFlag::AlignRight | Qt::AlignmentFlag::AlignVCenter);
+    }
 
     return QVariant();
 }
@@ -161,6 +188,10 @@ QVariant TableModelFileExplorer::headerData(int section, Qt::Orientation orienta
                 return tr("Frozen");
             case ColumnIndexItemType:
                 return tr("Type");
+            case ColumnIndexSize:
+                return tr("Size");
+            case ColumnIndexLastModified:
+                return tr("Last Modified");
             default:
                 break;
         }
@@ -177,98 +208,84 @@ Qt::ItemFlags TableModelFileExplorer::flags(const QModelIndex &index) const
     return QAbstractTableModel::flags(index) | Qt::ItemFlag::ItemIsEditable;
 }
 
-bool TableModelFileExplorer::setData(const QModelIndex &index, const QVariant &value, int role)
+bool TableModelFileExplorer::canFetchMore(const QModelIndex &parent) const
 {
-    if (index.isValid())
-    {
-        if(role == Qt::ItemDataRole::EditRole)
-        {
-            const int row = index.row();
-            auto item = this->itemList.value(row);
+    if(parent.isValid())
+        return false;
 
-            switch (index.column())
-            {
-            case 0:
-                item.name = value.toString();
-                break;
-            case 1:
-                item.symbolPath = value.toString();
-                break;
-            case 2:
-                item.type = value.value<TableItemType>();
-                break;
-            default:
-                return false;
-            }
-            this->itemList.replace(row, item);
-            emit dataChanged(index, index, {Qt::DisplayRole, Qt::EditRole});
-
-            return true;
-        }
-    }
-
-    return false;
+    return !isLastPageFetched && !isFetchInProgress;
 }
 
-bool TableModelFileExplorer::insertRows(int position, int rows, const QModelIndex &index)
+void TableModelFileExplorer::fetchMore(const QModelIndex &parent)
 {
-    Q_UNUSED(index);
-    beginInsertRows(QModelIndex(), position, position + rows - 1);
+    if(!canFetchMore(parent))
+        return;
+
+    isFetchInProgress = true;
+
+    FolderListingItem afterItem;
+    if(!itemList.isEmpty())
+        afterItem = itemList.last();
 
-    for (int row = 0; row < rows; ++row)
-        this->itemList.insert(position, { QString(), QString() });
+    QString folderPath = symbolFolderPath;
+    FolderListingPage::SortKey requestSortKey = sortKey;
+    Qt::SortOrder requestSortOrder = sortOrder;
+    quint64 requestGeneration = generation;
 
-    endInsertRows();
-    return true;
+    auto futureWatcher = new QFutureWatcher<FolderListingPage>(this);
+
+    QObject::connect(futureWatcher, &QFutureWatcher<FolderListingPage>::finished, this, [=]{
+        onPageFetched(futureWatcher->result(), requestGeneration);
+        futureWatcher->deleteLater();
+    });
+
+    QFuture<FolderListingPage> future = QtConcurrent::run([=]{
+        auto fsm = FileStorageManager::instance();
+        return fsm->getFolderListingPage(folderPath, requestSortKey, requestSortOrder, PageSize, afterItem);
+    });
+
+    futureWatcher->setFuture(future);
 }
 
-bool TableModelFileExplorer::removeRows(int position, int rows, const QModelIndex &index)
+void TableModelFileExplorer::sort(int column, Qt::SortOrder order)
 {
-    Q_UNUSED(index);
-    beginRemoveRows(QModelIndex(), position, position + rows - 1);
+    FolderListingPage::SortKey newSortKey = FolderListingPage::SortKey::Name;
+
+    if(column == ColumnIndexSize)
+        newSortKey = FolderListingPage::SortKey::Size;
+    else if(column == ColumnIndexLastModified)
+        newSortKey = FolderListingPage::SortKey::LastModified;
 
-    for (int row = 0; row < rows; ++row)
-        this->itemList.removeAt(position);
+    if(newSortKey == sortKey && order == sortOrder)
+        return;
 
-    endRemoveRows();
-    return true;
+    beginResetModel();
+
+    sortKey = newSortKey;
+    sortOrder = order;
+    itemList.clear();
+    isLastPageFetched = false;
+    isFetchInProgress = false;
+    ++generation;
+
+    endResetModel();
 }
 
-QList<TableModelFileExplorer::TableItem> TableModelFileExplorer::tableItemListFrom(QJsonObject parentFolder)
+void TableModelFileExplorer::onPageFetched(const FolderListingPage &page, quint64 requestGeneration)
 {
-    QList<TableItem> result;
-    QJsonArray childFolders = parentFolder[JsonKeys::Folder::ChildFolders].toArray();
-
-    for(const QJsonValue &jsonValue : childFolders)
-    {
-        QJsonObject child = jsonValue.toObject();
-        TableItem item {
-                        child[JsonKeys::Folder::SuffixPath].toString().chopped(1), // Remove / character at end
-                        child[JsonKeys::Folder::SymbolFolderPath].toString(),
-                        child[JsonKeys::Folder::UserFolderPath].toString(),
-                        child[JsonKeys::Folder::IsFrozen].toBool(),
-                        TableItemType::Folder,
-                       };
-
-        result.append(item);
-    }
+    if(requestGeneration != generation)
+        return;
 
-    QJsonArray childFiles = parentFolder[JsonKeys::Folder::ChildFiles].toArray();
+    isFetchInProgress = false;
+    isLastPageFetched = page.isLastPage;
 
-    for(const QJsonValue &jsonValue : childFiles)
+    if(!page.itemList.isEmpty())
     {
-        QJsonObject child = jsonValue.toObject();
-
-        TableItem item {
-                        child[JsonKeys::File::FileName].toString(),
-                        child[JsonKeys::File::SymbolFilePath].toString(),
-                        child[JsonKeys::File::UserFilePath].toString(),
-                        child[JsonKeys::File::IsFrozen].toBool(),
-                        TableItemType::File,
-                       };
+        int first = itemList.size();
+        int last = first + page.itemList.size() - 1;
 
-        result.append(item);
+        beginInsertRows(QModelIndex(), first, last);
+        itemList.append(page.itemList);
+        endInsertRows();
     }
-
-    return result;
 }
@@ -1,9 +1,12 @@
 #ifndef TABLEMODELFILEEXPLORER_H
 #define TABLEMODELFILEEXPLORER_H
 
+#include "Backend/FileStorageSubSystem/FolderListingPage.h"
+
 #include <QAbstractTableModel>
 #include <QIcon>
 
+// Lists a folder page by page as the view scrolls, pages are queried on a worker thread.
 class TableModelFileExplorer : public QAbstractTableModel
 {
     Q_OBJECT
@@ -14,6 +17,10 @@ public:
     static const inline int ColumnIndexUserPath = 2;
     static const inline int ColumnIndexIsFrozen = 3;
     static const inline int ColumnIndexItemType = 4;
+    static const inline int ColumnIndexSize = 5;
+    static const inline int ColumnIndexLastModified = 6;
+
+    static const inline int PageSize = 500;
 
     enum TableItemType
     {
@@ -22,22 +29,8 @@ public:
         File
     };
 
-    struct TableItem
-    {
-        QString name;
-        QString symbolPath;
-        QString userPath;
-        bool isFrozen;
-        TableItemType type;
-
-        bool operator==(const TableItem &other) const
-        {
-            return name == other.name && symbolPath == other.symbolPath;
-        }
-    };
-
 public:
-    TableModelFileExplorer(QJsonObject result, QObject *parent = nullptr);
+    TableModelFileExplorer(const QString &symbolFolderPath, QObject *parent = nullptr);
 
     QString getNameFromModelIndex(const QModelIndex &index) const;
     QString getSymbolPathFromModelIndex(const QModelIndex &index) const;
@@ -52,16 +45,21 @@ public:
     QVariant data(const QModelIndex &index, int role) const override;
     QVariant headerData(int section, Qt::Orientation orientation, int role) const override;
     Qt::ItemFlags flags(const QModelIndex &index) const override;
-    bool setData(const QModelIndex &index, const QVariant &value, int role = Qt::EditRole) override;
-    bool insertRows(int position, int rows, const QModelIndex &index = QModelIndex()) override;
-    bool removeRows(int position, int rows, const QModelIndex &index = QModelIndex()) override;
+    bool canFetchMore(const QModelIndex &parent) const override;
+    void fetchMore(const QModelIndex &parent) override;
+    void sort(int column, Qt::SortOrder order = Qt::AscendingOrder) override;
 
 private:
-    static QList<TableItem> tableItemListFrom(QJsonObject parentFolder);
+    void onPageFetched(const FolderListingPage &page, quint64 requestGeneration);
 
 private:
-    QList<TableItem> itemList;
-
+    QString symbolFolderPath;
+    FolderListingPage::SortKey sortKey;
+    Qt::SortOrder sortOrder;
+    QList<FolderListingItem> itemList;
+    bool isLastPageFetched;
+    bool isFetchInProgress;
+    quint64 generation; // Pages requested before a sort are dropped
 };
 
 #endif // TABLEMODELFILEEXPLORER_H
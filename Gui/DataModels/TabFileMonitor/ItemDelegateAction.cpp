@@ -36,10 +36,9 @@ QWidget *ItemDelegateAction::createEditor(QWidget *parent, const QStyleOptionVie
 
     FileSystemEventDb::ItemStatus status = item->getStatus();
 
+    // First choice of each status is the default action which model gives to the item.
     if(status == FileSystemEventDb::ItemStatus::NewAdded)
     {
-        item->setAction(TreeItem::Action::Save);
-
         if(item->getType() == TreeItem::ItemType::File)
             result->addItem(ITEM_TEXT_SAVE);
         else if(item->getType() == TreeItem::ItemType::Folder)
@@ -48,8 +47,6 @@ QWidget *ItemDelegateAction::createEditor(QWidget *parent, const QStyleOptionVie
     else if(status == FileSystemEventDb::ItemStatus::Updated ||
             status == FileSystemEventDb::ItemStatus::Renamed)
     {
-        item->setAction(TreeItem::Action::Save);
-
         if(item->getType() == TreeItem::ItemType::File)
         {
             result->addItem(ITEM_TEXT_SAVE);
@@ -63,8 +60,6 @@ QWidget *ItemDelegateAction::createEditor(QWidget *parent, const QStyleOptionVie
     }
     else if(status == FileSystemEventDb::ItemStatus::Deleted)
     {
-        item->setAction(TreeItem::Action::Delete);
-
         if(item->getType() == TreeItem::ItemType::File)
         {
             result->addItem(ITEM_TEXT_DELETE);
@@ -80,8 +75,6 @@ QWidget *ItemDelegateAction::createEditor(QWidget *parent, const QStyleOptionVie
     }
     else if(status == FileSystemEventDb::ItemStatus::Missing)
     {
-        item->setAction(TreeItem::Action::Restore);
-
         if(item->getType() == TreeItem::ItemType::File)
         {
             result->addItem(ITEM_TEXT_RESTORE);
@@ -7,12 +7,15 @@ TreeItem::TreeItem(TreeItem *parent)
     setParentItem(parent);
     setType(ItemType::Undefined);
     setAction(TreeItem::Action::NotSelected);
+    setStatus(FileSystemEventDb::ItemStatus::Invalid);
     setDescription("");
+    setChildrenFetched(false);
+    setContainEvent(false);
 }
 
 TreeItem::~TreeItem()
 {
-    qDeleteAll(childItems);
+    // Items are owned by the arena of the model.
 }
 
 TreeItem *TreeItem::getParentItem() const
@@ -25,15 +28,24 @@ void TreeItem::setParentItem(TreeItem *newParentItem)
     parentItem = newParentItem;
 }
 
-void TreeItem::setUserPath(const QString &newUserPath)
+QString TreeItem::getPathSegment() const
 {
-    userPath = newUserPath;
+    return pathSegment;
 }
 
+void TreeItem::setPathSegment(const QString &newPathSegment)
+{
+    pathSegment = newPathSegment;
+}
 
 QString TreeItem::getUserPath() const
 {
-    return userPath;
+    QString result = pathSegment;
+
+    for(TreeItem *current = parentItem; current != nullptr; current = current->parentItem)
+        result.prepend(current->pathSegment);
+
+    return result;
 }
 
 FileSystemEventDb::ItemStatus TreeItem::getStatus() const
@@ -76,11 +88,43 @@ void TreeItem::setDescription(const QString &newDescription)
     description = newDescription;
 }
 
+bool TreeItem::isChildrenFetched() const
+{
+    return childrenFetched;
+}
+
+void TreeItem::setChildrenFetched(bool newChildrenFetched)
+{
+    childrenFetched = newChildrenFetched;
+}
+
+bool TreeItem::isContainEvent() const
+{
+    return containEvent;
+}
+
+void TreeItem::setContainEvent(bool newContainEvent)
+{
+    containEvent = newContainEvent;
+}
+
 void TreeItem::appendChild(TreeItem *item)
 {
     childItems.append(item);
 }
 
+void TreeItem::insertChild(int row, TreeItem *child)
+{
+    childItems.insert(row, child);
+}
+
+TreeItem *TreeItem::takeChild(int row)
+{
+    if (row < 0 || row >= childItems.size())
+        return nullptr;
+    return childItems.takeAt(row);
+}
+
 TreeItem *TreeItem::child(int row)
 {
     if (row < 0 || row >= childItems.size())
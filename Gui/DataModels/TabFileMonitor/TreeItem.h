@@ -38,11 +38,15 @@ public:
     TreeItem *getParentItem() const;
     void setParentItem(TreeItem *newParentItem);
 
-    void setUserPath(const QString &newUserPath);
+    // Top level items keep their full path, others only their own name (folders end with separator).
+    QString getPathSegment() const;
+    void setPathSegment(const QString &newPathSegment);
     QString getUserPath() const;
     void setDescription(const QString &newDescription);
 
     void appendChild(TreeItem *child);
+    void insertChild(int row, TreeItem *child);
+    TreeItem *takeChild(int row);
 
     TreeItem *child(int row);
     int childCount() const;
@@ -60,12 +64,20 @@ public:
 
     QString getDescription() const;
 
+    bool isChildrenFetched() const;
+    void setChildrenFetched(bool newChildrenFetched);
+
+    bool isContainEvent() const;
+    void setContainEvent(bool newContainEvent);
+
 private:
-    QString userPath;
+    QString pathSegment;
     FileSystemEventDb::ItemStatus status;
     QString description;
     Action action;
     ItemType type;
+    bool childrenFetched;
+    bool containEvent;
     QList<TreeItem *> childItems;
     TreeItem *parentItem;
 };
@@ -1,8 +1,7 @@
 #include "TreeModelFileMonitor.h"
 
-#include "Utility/DatabaseRegistry.h"
-
 #include <QDir>
+#include <QQueue>
 #include <QStack>
 #include <QFileIconProvider>
 
@@ -10,23 +9,151 @@ using namespace TreeModelFileMonitor;
 
 Model::Model(QObject *parent) : QAbstractItemModel(parent)
 {
-    treeRoot = new TreeItem();
-    fsEventDb = new FileSystemEventDb(DatabaseRegistry::fileSystemEventDatabase());
+    treeRoot = itemArena.create();
+    treeRoot->setChildrenFetched(true);
+    isFetchLocked = false;
     descriptionNumberListModel = new QStringListModel(this);
-    setupModelData();
 }
 
 Model::~Model()
 {
-    delete treeRoot;
-    delete fsEventDb;
+
 }
 
 void Model::disableComboBoxes()
 {
+    isFetchLocked = true; // Save task works on current items
     emit signalDisableItemDelegates();
 }
 
+bool Model::applySnapshot(const FileMonitorSnapshot &newSnapshot)
+{
+    bool result = false;
+
+    snapshot = newSnapshot;
+    indexSnapshot();
+
+    // Remove items which are gone or moved under another parent.
+    auto isStale = [this](TreeItem *item, const QHash<QString, qsizetype> &entryTable) {
+        auto iterator = entryTable.constFind(item->getUserPath());
+
+        if(iterator == entryTable.constEnd())
+            return true;
+
+        QString parentPath = item->getParentItem()->getUserPath();
+        return snapshot.entryList.at(iterator.value()).parentPath != parentPath;
+    };
+
+    QStringList staleFilePathList;
+    for(auto iterator = fileItemMap.constBegin(); iterator != fileItemMap.constEnd(); ++iterator)
+    {
+        if(isStale(iterator.value(), fileEntryTable))
+            staleFilePathList.append(iterator.key());
+    }
+
+    QStringList staleFolderPathList;
+    for(auto iterator = folderItemMap.constBegin(); iterator != folderItemMap.constEnd(); ++iterator)
+    {
+        if(isStale(iterator.value(), folderEntryTable))
+            staleFolderPathList.append(iterator.key());
+    }
+
+    for(const QString &path : staleFilePathList)
+    {
+        TreeItem *item = fileItemMap.value(path);
+
+        if(item != nullptr)
+        {
+            removeTreeItem(item);
+            result = true;
+        }
+    }
+
+    for(const QString &path : staleFolderPathList)
+    {
+        TreeItem *item = folderItemMap.value(path); // Null when removed with its parent before
+
+        if(item != nullptr)
+        {
+            removeTreeItem(item);
+            result = true;
+        }
+    }
+
+    // Remaining items are a subset of the snapshot, only fetched folders are filled.
+    QQueue<TreeItem *> folderQueue;
+    folderQueue.enqueue(treeRoot);
+
+    while(!folderQueue.isEmpty())
+    {
+        TreeItem *folderItem = folderQueue.dequeue();
+
+        bool isSynced = syncChildren(folderItem);
+        result = result || isSynced;
+
+        for(int row = 0; row < folderItem->childCount(); ++row)
+        {
+            TreeItem *child = folderItem->child(row);
+
+            if(child->isChildrenFetched())
+                folderQueue.enqueue(child);
+        }
+    }
+
+    return result;
+}
+
+void Model::fetchEventfulItems()
+{
+    QQueue<TreeItem *> folderQueue;
+    folderQueue.enqueue(treeRoot);
+
+    while(!folderQueue.isEmpty())
+    {
+        TreeItem *folderItem = folderQueue.dequeue();
+
+        if(!folderItem->isChildrenFetched())
+        {
+            folderItem->setChildrenFetched(true);
+            syncChildren(folderItem);
+        }
+
+        for(int row = 0; row < folderItem->childCount(); ++row)
+        {
+            TreeItem *child = folderItem->child(row);
+
+            if(child->getType() == TreeItem::ItemType::Folder && child->isContainEvent())
+                folderQueue.enqueue(child);
+        }
+    }
+}
+
+bool Model::isContainEvent(const QModelIndex &index) const
+{
+    return itemOfIndex(index)->isContainEvent();
+}
+
+void Model::clear()
+{
+    beginResetModel();
+
+    itemArena.clear();
+    segmentPool.clear();
+    treeRoot = itemArena.create();
+    treeRoot->setChildrenFetched(true);
+    isFetchLocked = false;
+
+    folderItemMap.clear();
+    fileItemMap.clear();
+    snapshot = FileMonitorSnapshot();
+    indexSnapshot();
+
+    descriptionMap.clear();
+    descriptionNumberListModel->setStringList(QStringList());
+
+    endResetModel();
+}
+
 void Model::appendDescription()
 {
     if(descriptionMap.isEmpty())
@@ -144,19 +271,12 @@ QVariant Model::data(const QModelIndex &index, int role) const
             if(item->getType() == TreeItem::ItemType::Folder)
             {
                 if(item->getParentItem() == treeRoot)
-                    return item->getUserPath();
+                    return item->getPathSegment();
                 else
-                {
-                    QString userPath = item->getUserPath();
-                    userPath.chop(1); // Remove QDir::seperator()
-                    return userPath.split(QDir::separator()).last();
-                }
+                    return item->getPathSegment().chopped(1); // Remove QDir::seperator()
             }
             else if(item->getType() == TreeItem::ItemType::File)
-            {
-                QString userPath = item->getUserPath();
-                return userPath.split(QDir::separator()).last();
-            }
+                return item->getPathSegment();
         }
         else if(index.column() == ColumnIndexStatus)
         {
@@ -247,63 +367,238 @@ int Model::rowCount(const QModelIndex &parent) const
     return parentItem->childCount();
 }
 
-void Model::setupModelData()
+bool Model::hasChildren(const QModelIndex &parent) const
+{
+    if(parent.column() > 0)
+        return false;
+
+    TreeItem *item = itemOfIndex(parent);
+
+    if(item->isChildrenFetched())
+        return item->childCount() > 0;
+
+    return childEntryTable.contains(item->getUserPath());
+}
+
+bool Model::canFetchMore(const QModelIndex &parent) const
+{
+    if(isFetchLocked || parent.column() > 0)
+        return false;
+
+    TreeItem *item = itemOfIndex(parent);
+
+    return !item->isChildrenFetched() && childEntryTable.contains(item->getUserPath());
+}
+
+void Model::fetchMore(const QModelIndex &parent)
+{
+    TreeItem *item = itemOfIndex(parent);
+
+    if(item->isChildrenFetched())
+        return;
+
+    item->setChildrenFetched(true);
+    syncChildren(item);
+}
+
+void Model::indexSnapshot()
 {
-    QStringList rootFolders = fsEventDb->getMonitoredRootFolderList();
-    rootFolders.append(fsEventDb->getMissingRootFolderList());
+    childEntryTable.clear();
+    folderEntryTable.clear();
+    fileEntryTable.clear();
 
-    for(const QString &currentRootFolderPath : rootFolders)
+    for(qsizetype index = 0; index < snapshot.entryList.size(); ++index)
     {
-        TreeItem *activeRoot = createTreeItem(currentRootFolderPath, TreeItem::ItemType::Folder, nullptr);
-        QStack<TreeItem *> itemStack;
-        itemStack.push(activeRoot);
+        const FileMonitorSnapshot::Entry &entry = snapshot.entryList.at(index);
+
+        childEntryTable[entry.parentPath].append(index);
 
-        while(!itemStack.isEmpty())
+        if(entry.isFolder)
+            folderEntryTable.insert(entry.path, index);
+        else
+            fileEntryTable.insert(entry.path, index);
+    }
+}
+
+// Makes children of a fetched folder match the snapshot, in snapshot order.
+bool Model::syncChildren(TreeItem *folderItem)
+{
+    bool result = false;
+
+    const QList<qsizetype> entryIndexList = childEntryTable.value(folderItem->getUserPath());
+
+    if(folderItem->childCount() == 0)
+    {
+        if(!entryIndexList.isEmpty())
         {
-            TreeItem *parentItem = itemStack.pop();
+            beginInsertRows(indexOfItem(folderItem), 0, entryIndexList.size() - 1);
 
-            if(parentItem->getParentItem() == nullptr)
-            {
-                parentItem->setParentItem(treeRoot);
-                treeRoot->appendChild(activeRoot);
-                folderItemMap.insert(parentItem->getUserPath(), parentItem);
-            }
+            for(qsizetype entryIndex : entryIndexList)
+                folderItem->appendChild(createTreeItem(snapshot.entryList.at(entryIndex), folderItem));
 
-            QStringList childFolderPathList = fsEventDb->getDirectChildFolderListOfFolder(parentItem->getUserPath());
-            QStringList eventFulFileList = fsEventDb->getEventfulFileListOfFolder(parentItem->getUserPath());
+            endInsertRows();
+            result = true;
+        }
 
-            for(const QString &childFilePath : eventFulFileList)
-            {
-                TreeItem *fileItem = createTreeItem(childFilePath, TreeItem::ItemType::File, parentItem);
-                parentItem->appendChild(fileItem);
-                fileItemMap.insert(fileItem->getUserPath(), fileItem);
-            }
+        return result;
+    }
 
-            for(const QString &currentChildFolderPath : childFolderPathList)
-            {
-                TreeItem *childItem = createTreeItem(currentChildFolderPath, TreeItem::ItemType::Folder, parentItem);
-                parentItem->appendChild(childItem);
-                itemStack.push(childItem);
-                folderItemMap.insert(childItem->getUserPath(), childItem);
-            }
+    for(int row = 0; row < entryIndexList.size(); ++row)
+    {
+        const FileMonitorSnapshot::Entry &entry = snapshot.entryList.at(entryIndexList.at(row));
+        TreeItem *item = entry.isFolder ? folderItemMap.value(entry.path) : fileItemMap.value(entry.path);
+
+        if(item != nullptr && folderItem->child(row) != item) // Order changed
+        {
+            removeTreeItem(item);
+            item = nullptr;
+        }
+
+        if(item == nullptr)
+        {
+            insertTreeItem(folderItem, row, entry);
+            result = true;
+        }
+        else
+        {
+            bool isUpdated = updateTreeItem(item, row, entry);
+            result = result || isUpdated;
         }
     }
+
+    return result;
 }
 
-TreeItem *Model::createTreeItem(const QString &pathToFileOrFolder, TreeItem::ItemType type, TreeItem *root) const
+TreeItem *Model::createTreeItem(const FileMonitorSnapshot::Entry &entry, TreeItem *parentItem)
 {
-    TreeItem *result = new TreeItem(root);
-    result->setUserPath(pathToFileOrFolder);
+    TreeItem *result = itemArena.create();
+    result->setParentItem(parentItem);
 
-    auto status = FileSystemEventDb::ItemStatus::Invalid;
+    if(parentItem == treeRoot)
+        result->setPathSegment(segmentPool.intern(entry.path));
+    else
+        result->setPathSegment(segmentPool.intern(entry.path.mid(entry.parentPath.size())));
 
-    if(type == TreeItem::ItemType::Folder)
-        status = fsEventDb->getStatusOfFolder(pathToFileOrFolder);
+    result->setStatus(entry.status);
+    result->setType(entry.isFolder ? TreeItem::ItemType::Folder : TreeItem::ItemType::File);
+    result->setContainEvent(entry.isContainEvent);
+    result->setAction(defaultActionOf(result));
+
+    if(entry.isFolder)
+        folderItemMap.insert(entry.path, result);
     else
-        status = fsEventDb->getStatusOfFile(pathToFileOrFolder);
+        fileItemMap.insert(entry.path, result);
+
+    return result;
+}
+
+void Model::insertTreeItem(TreeItem *parentItem, int row, const FileMonitorSnapshot::Entry &entry)
+{
+    beginInsertRows(indexOfItem(parentItem), row, row);
+
+    parentItem->insertChild(row, createTreeItem(entry, parentItem));
+
+    endInsertRows();
+}
+
+bool Model::updateTreeItem(TreeItem *item, int row, const FileMonitorSnapshot::Entry &entry)
+{
+    bool result = false;
+
+    if(item->getStatus() != entry.status)
+    {
+        item->setStatus(entry.status);
+        item->setAction(defaultActionOf(item));
+        emit dataChanged(createIndex(row, ColumnIndexStatus, item), createIndex(row, ColumnIndexAction, item));
+        result = true;
+    }
+
+    if(item->isContainEvent() != entry.isContainEvent)
+    {
+        item->setContainEvent(entry.isContainEvent);
+
+        if(entry.isContainEvent && item->getType() == TreeItem::ItemType::Folder)
+            emit signalEventAppeared(createIndex(row, ColumnIndexUserPath, item));
+    }
+
+    return result;
+}
+
+void Model::removeTreeItem(TreeItem *item)
+{
+    TreeItem *parentItem = item->getParentItem();
+    int row = item->row();
+
+    QList<TreeItem *> subtree;
+    QStack<TreeItem *> itemStack;
+    itemStack.push(item);
+
+    while(!itemStack.isEmpty())
+    {
+        TreeItem *current = itemStack.pop();
+        subtree.append(current);
+
+        for(int childRow = 0; childRow < current->childCount(); ++childRow)
+            itemStack.push(current->child(childRow));
+    }
+
+    beginRemoveRows(indexOfItem(parentItem), row, row);
+
+    // Paths are built from parents, so items are unregistered before anything is detached.
+    for(TreeItem *current : subtree)
+    {
+        if(current->getType() == TreeItem::ItemType::Folder)
+            folderItemMap.remove(current->getUserPath());
+        else
+            fileItemMap.remove(current->getUserPath());
+    }
+
+    parentItem->takeChild(row);
+
+    endRemoveRows();
+
+    for(TreeItem *current : subtree)
+        itemArena.release(current);
+}
+
+TreeItem *Model::itemOfIndex(const QModelIndex &index) const
+{
+    if(!index.isValid())
+        return treeRoot;
+
+    return static_cast<TreeItem*>(index.internalPointer());
+}
+
+QModelIndex Model::indexOfItem(TreeItem *item) const
+{
+    if(item == treeRoot)
+        return QModelIndex();
+
+    return createIndex(item->row(), 0, item);
+}
+
+// Children of deleted or missing folders follow their parent, others start with the first choice of their status.
+TreeItem::Action Model::defaultActionOf(const TreeItem *item) const
+{
+    TreeItem::Action result = TreeItem::Action::NotSelected;
+    TreeItem *parentItem = item->getParentItem();
 
-    result->setStatus(status);
-    result->setType(type);
+    if(parentItem != treeRoot &&
+       (parentItem->getStatus() == FileSystemEventDb::ItemStatus::Deleted ||
+        parentItem->getStatus() == FileSystemEventDb::ItemStatus::Missing))
+    {
+        result = parentItem->getAction();
+    }
+    else if(item->getStatus() == FileSystemEventDb::ItemStatus::NewAdded ||
+            item->getStatus() == FileSystemEventDb::ItemStatus::Updated ||
+            item->getStatus() == FileSystemEventDb::ItemStatus::Renamed)
+    {
+        result = TreeItem::Action::Save;
+    }
+    else if(item->getStatus() == FileSystemEventDb::ItemStatus::Deleted)
+        result = TreeItem::Action::Delete;
+    else if(item->getStatus() == FileSystemEventDb::ItemStatus::Missing)
+        result = TreeItem::Action::Restore;
 
     return result;
 }
@@ -2,8 +2,10 @@
 #define TREEMODELFOLDERMONITOR_H
 
 #include "TreeItem.h"
+#include "DataModels/TreeItemArena.h"
+#include "DataModels/PathSegmentPool.h"
 
-#include "Backend/FileMonitorSubSystem/FileSystemEventDb.h"
+#include "Backend/FileMonitorSubSystem/FileMonitorSnapshot.h"
 
 #include <QStringListModel>
 #include <QAbstractItemModel>
@@ -28,6 +30,18 @@ public:
 
     void disableComboBoxes();
 
+    // Brings the tree in line with snapshot by inserting, removing and updating only the rows which differ.
+    // Children of a folder are created when the folder is fetched; returns true when any row changed.
+    bool applySnapshot(const FileMonitorSnapshot &newSnapshot);
+
+    // Fetches every folder which has an event below it, so all eventful items get a tree item.
+    void fetchEventfulItems();
+
+    bool isContainEvent(const QModelIndex &index) const;
+
+    // Removes all items and descriptions.
+    void clear();
+
     void appendDescription();
     void updateDescription(int number, const QString &data);
     void deleteDescription(int number);
@@ -49,17 +63,36 @@ public:
     QModelIndex parent(const QModelIndex &index) const override;
     int rowCount(const QModelIndex &parent = QModelIndex()) const override;
     int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    bool hasChildren(const QModelIndex &parent = QModelIndex()) const override;
+    bool canFetchMore(const QModelIndex &parent) const override;
+    void fetchMore(const QModelIndex &parent) override;
 
 signals:
     void signalDisableItemDelegates();
+    void signalEventAppeared(const QModelIndex &folderIndex);
 
 private:
-    void setupModelData();
-    TreeItem *createTreeItem(const QString &pathToFileOrFolder, TreeItem::ItemType type, TreeItem *root) const;
+    void indexSnapshot();
+    bool syncChildren(TreeItem *folderItem);
+    TreeItem *createTreeItem(const FileMonitorSnapshot::Entry &entry, TreeItem *parentItem);
+    void insertTreeItem(TreeItem *parentItem, int row, const FileMonitorSnapshot::Entry &entry);
+    bool updateTreeItem(TreeItem *item, int row, const FileMonitorSnapshot::Entry &entry);
+    void removeTreeItem(TreeItem *item);
+    TreeItem *itemOfIndex(const QModelIndex &index) const;
+    QModelIndex indexOfItem(TreeItem *item) const;
+    TreeItem::Action defaultActionOf(const TreeItem *item) const;
     QString itemStatusToString(FileSystemEventDb::ItemStatus status) const;
 
+    TreeItemArena<TreeItem> itemArena;
+    PathSegmentPool segmentPool;
     TreeItem *treeRoot;
-    FileSystemEventDb *fsEventDb;
+    bool isFetchLocked;
+
+    FileMonitorSnapshot snapshot;
+    QHash<QString, QList<qsizetype>> childEntryTable; // Parent path -> entry positions in snapshot
+    QHash<QString, qsizetype> folderEntryTable;
+    QHash<QString, qsizetype> fileEntryTable;
+
     QMap<int, QString> descriptionMap;
     QStringListModel *descriptionNumberListModel;
 
@@ -0,0 +1,51 @@
+#ifndef TREEITEMARENA_H
+#define TREEITEMARENA_H
+
+#include <deque>
+
+#include <QList>
+
+// Owns tree items of a model in chunks instead of one heap allocation per item.
+// Addresses stay valid until the item is released; released slots are reused.
+template<typename T>
+class TreeItemArena
+{
+public:
+    T *create()
+    {
+        T *result = nullptr;
+
+        if(!freeList.isEmpty())
+            result = freeList.takeLast();
+        else
+        {
+            storage.emplace_back();
+            result = &storage.back();
+        }
+
+        return result;
+    }
+
+    void release(T *item)
+    {
+        *item = T();
+        freeList.append(item);
+    }
+
+    void clear()
+    {
+        storage.clear();
+        freeList.clear();
+    }
+
+    qsizetype liveItemCount() const
+    {
+        return (qsizetype) storage.size() - freeList.size();
+    }
+
+private:
+    std::deque<T> storage;
+    QList<T *> freeList;
+};
+
+#endif // TREEITEMARENA_H
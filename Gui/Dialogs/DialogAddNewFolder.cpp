@@ -2,10 +2,12 @@
 #include "ui_DialogAddNewFolder.h"
 
 #include "Utility/JsonDtoFormat.h"
+#include "Utility/IoScheduler.h"
 #include "Tasks/TaskAddNewFolders.h"
 #include "Backend/FileStorageSubSystem/FileStorageManager.h"
 
 #include <QFileIconProvider>
+#include <QLocale>
 #include <QStandardPaths>
 #include <QHashIterator>
 #include <QStorageInfo>
@@ -200,6 +202,13 @@ QString DialogAddNewFolder::statusTextAdding()
     return tr("Folders & files are being added in background...");
 }
 
+QString DialogAddNewFolder::statusTextAddingWithThroughput(qint64 bytesPerSecond)
+{
+    QString text = tr("Folders & files are being added in background at <b>%1/s</b>...");
+    text = text.arg(QLocale().formattedDataSize(bytesPerSecond));
+    return text;
+}
+
 QString DialogAddNewFolder::statusTextNoFreeSpace(QString folderName)
 {
     QString text = tr("Not enough free space available for: <b>%1</b>");
@@ -280,6 +289,13 @@ void DialogAddNewFolder::on_buttonAddFilesToDb_clicked()
     QObject::connect(task, &TaskAddNewFolders::signalFileProcessed,
                      this->ui->progressBar, &QProgressBar::setValue);
 
+    QObject::connect(task, &TaskAddNewFolders::signalFileProcessed, this, [=]{
+        qint64 throughput = IoScheduler::instance()->getThroughput(IoScheduler::Budget::Background);
+
+        if(throughput > 0)
+            this->showStatusInfo(statusTextAddingWithThroughput(throughput), ui->labelStatus);
+    });
+
     QObject::connect(task, &TaskAddNewFolders::finished,
                      this, &DialogAddNewFolder::slotOnTaskAddNewFoldersFinished);
 
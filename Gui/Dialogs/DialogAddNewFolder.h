@@ -56,6 +56,7 @@ private:
     static QString statusTextContentReadyToAdd();
     static QString statusTextEmptyFolder();
     static QString statusTextAdding();
+    static QString statusTextAddingWithThroughput(qint64 bytesPerSecond);
     static QString statusTextNoFreeSpace(QString folderName);
     static QString statusTextFolderExist(QString folderName);
     static QString statusTextSuccess(QString folderName);
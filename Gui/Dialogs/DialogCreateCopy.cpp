@@ -123,13 +123,10 @@ void DialogCreateCopy::on_buttonCreateCopy_clicked()
     QFuture<void> future = QtConcurrent::run([=, &isCopied] {
 
         auto fsm = FileStorageManager::instance();
-        QJsonObject versionJson = fsm->getFileVersionJson(currentFileSymbolPath, ui->comboBox->currentText().toInt());
-
-        QString internalFilePath = fsm->getStorageFolderPath();
-        internalFilePath += versionJson[JsonKeys::FileVersion::InternalFileName].toString();
+        FileVersionRecord versionRecord = fsm->getFileVersion(currentFileSymbolPath, ui->comboBox->currentText().toInt());
 
         QFile::remove(userFilePath);
-        isCopied = QFile::copy(internalFilePath, userFilePath);
+        isCopied = fsm->copyVersionFile(versionRecord, userFilePath, IoScheduler::Budget::Foreground);
     });
 
     futureWatcher.setFuture(future);
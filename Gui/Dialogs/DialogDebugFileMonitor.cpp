@@ -4,6 +4,7 @@
 #include <QSqlQueryModel>
 
 #include "Utility/DatabaseRegistry.h"
+#include "Backend/FileMonitorSubSystem/FileSystemEventDb.h"
 
 DialogDebugFileMonitor::DialogDebugFileMonitor(QWidget *parent) :
     QDialog(parent),
@@ -24,6 +25,10 @@ DialogDebugFileMonitor::~DialogDebugFileMonitor()
 
 void DialogDebugFileMonitor::on_buttonExecute_clicked()
 {
+    // Events live in memory, so every refresh works on a fresh copy of them.
+    FileSystemEventDb fsEventDb;
+    fsEventDb.exportSnapshot(database);
+
     int currentIndex = ui->tabWidget->currentIndex();
     if(currentIndex == 0)
     {
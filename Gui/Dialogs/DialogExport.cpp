@@ -1,6 +1,8 @@
 #include "DialogExport.h"
 #include "ui_DialogExport.h"
 #include "Utility/JsonDtoFormat.h"
+#include "Utility/IoScheduler.h"
+#include "Utility/ChunkBufferPool.h"
 #include "Backend/FileStorageSubSystem/FileStorageManager.h"
 
 #include <quazip/quazip.h>
@@ -95,6 +97,8 @@ void DialogExport::on_buttonExport_clicked()
     ui->progressBar->setValue(0);
 
     QFuture<void> future = QtConcurrent::run([=]{
+        IoScheduler::BackgroundScope backgroundScope;
+
         QJsonArray fileJsonArray;
         qlonglong totalFileCount = 0;
         auto fsm = FileStorageManager::instance();
@@ -162,25 +166,35 @@ void DialogExport::on_buttonExport_clicked()
             {
                 QJsonObject versionJson = currentFileVersion.toObject();
                 QString internalFileName = versionJson[JsonKeys::FileVersion::InternalFileName].toString();
-                QString internalFilePath = fsm->getStorageFolderPath() + internalFileName;
+                FileVersionRecord versionRecord = fsm->getFileVersion(versionJson[JsonKeys::FileVersion::SymbolFilePath].toString(),
+                                                                      versionJson[JsonKeys::FileVersion::VersionNumber].toInteger());
 
-                QFile rawFile(internalFilePath);
-                bool isReadable = rawFile.open(QFile::OpenModeFlag::ReadOnly);
+                QSharedPointer<QIODevice> rawFile = fsm->openVersionFile(versionRecord);
 
-                if(!isReadable)
+                if(rawFile.isNull())
                 {
                     emit signalZippingFinished(false);
                     return;
                 }
 
-                QuaZipNewInfo info(internalFileName, internalFilePath);
+                // Packed versions have no file, entry gets current time for them.
+                QuaZipNewInfo info(internalFileName, fsm->getInternalFilePath(internalFileName));
                 QuaZipFile fileInZip(&archive);
                 fileInZip.open(QFile::OpenModeFlag::WriteOnly, info);
 
-                while(!rawFile.atEnd())
+                ChunkBufferPool::Lease buffer;
+
+                while(!rawFile->atEnd())
                 {
-                    // Write up to 100mb in every iteration.
-                    qlonglong bytesWritten = fileInZip.write(rawFile.read(104857600));
+                    qlonglong readCount = rawFile->read(buffer.data(), buffer.size());
+                    qlonglong bytesWritten = -1;
+
+                    if(readCount != -1)
+                    {
+                        IoScheduler::instance()->acquire(IoScheduler::Budget::Background, readCount);
+                        bytesWritten = fileInZip.write(buffer.data(), readCount);
+                    }
+
                     if(bytesWritten == -1)
                     {
                         emit signalZippingFinished(false);
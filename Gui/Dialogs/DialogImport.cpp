@@ -1,18 +1,16 @@
 #include "DialogImport.h"
 #include "ui_DialogImport.h"
 #include "Utility/JsonDtoFormat.h"
+#include "Utility/JobScheduler.h"
 #include "DataModels/DialogImport/TreeModelDialogImport.h"
-#include "Backend/FileStorageSubSystem/FileStorageManager.h"
+#include "Tasks/TaskImportZip.h"
 
 #include <quazip/quazip.h>
 #include <quazip/quazipfile.h>
-#include <QDataStream>
 #include <QFileDialog>
 #include <QJsonObject>
-#include <QtConcurrent>
 #include <QJsonDocument>
 #include <QStandardPaths>
-#include <QTemporaryFile>
 
 DialogImport::DialogImport(QWidget *parent) :
     QDialog(parent),
@@ -20,9 +18,7 @@ DialogImport::DialogImport(QWidget *parent) :
 {
     ui->setupUi(this);
     itemDelegateAction = new TreeModelDialogImport::ItemDelegateAction(this);
-
-    QObject::connect(this, &DialogImport::signalProgressUpdate,
-                     ui->progressBar, &QProgressBar::setValue);
+    activeJobId = 0;
 
     QObject::connect(this, &DialogImport::signalFileImportStarted, this, [=](const QString &symbolFilePath){
         auto treeModel = (TreeModelDialogImport::Model *) ui->treeView->model();
@@ -37,13 +33,32 @@ DialogImport::DialogImport(QWidget *parent) :
     QObject::connect(this, &DialogImport::signalFileImportFailed, this, [=](const QString &symbolFilePath){
         auto treeModel = (TreeModelDialogImport::Model *) ui->treeView->model();
         treeModel->markFileAsFailed(symbolFilePath);
+        allFilesImportedSuccessfully = false;
+    });
+
+    QObject::connect(JobScheduler::instance(), &JobScheduler::signalJobProgress,
+                     this, [=](qint64 jobId, qint64 doneCount, qint64 totalCount, qint64 remainingMsecs){
+        if(jobId != activeJobId)
+            return;
+
+        ui->progressBar->setValue(doneCount);
+
+        if(remainingMsecs >= 0 && doneCount < totalCount)
+            showStatusInfo(statusTextFilesBeingImportedWithRemainingTime(remainingMsecs), ui->labelStatus);
     });
 
-    QObject::connect(&futureWatcher, &QFutureWatcher<void>::finished, this, [=]{
+    QObject::connect(JobScheduler::instance(), &JobScheduler::signalJobFinished,
+                     this, [=](qint64 jobId, BackgroundJob::State state){
+        if(jobId != activeJobId)
+            return;
+
+        activeJobId = 0;
         ui->buttonImport->hide();
         ui->buttonClearResults->show();
 
-        if(allFilesImportedSuccessfully)
+        if(state == BackgroundJob::State::Cancelled)
+            showStatusWarning(statusTextFileImportCancelled(), ui->labelStatus);
+        else if(state == BackgroundJob::State::Succeeded && allFilesImportedSuccessfully)
             showStatusSuccess(statusTextFileImportFinishedWithoutError(), ui->labelStatus);
         else
             showStatusError(statusTextFileImportFinishedWithError(), ui->labelStatus);
@@ -57,6 +72,12 @@ DialogImport::~DialogImport()
 
 void DialogImport::show()
 {
+    if(activeJobId != 0) // Import is still stopping, its results stay visible
+    {
+        QWidget::show();
+        return;
+    }
+
     if(ui->treeView->model() != nullptr)
         delete ui->treeView->model();
 
@@ -73,6 +94,9 @@ void DialogImport::show()
 
 void DialogImport::closeEvent(QCloseEvent *event)
 {
+    if(activeJobId != 0)
+        JobScheduler::instance()->cancel(activeJobId);
+
     emit accepted();
     QDialog::closeEvent(event);
 }
@@ -137,6 +161,21 @@ void DialogImport::on_buttonSelectFile_clicked()
         delete ui->treeView->model();
 
     auto treeModel = new TreeModelDialogImport::Model(document.array(), ui->treeView);
+    bool isExpandedOnFetch = treeModel->getTotalFileCount() <= ExpandedFileCountLimit;
+
+    // Items are fetched while the tree is scrolled or expanded, editors are opened for the fetched rows.
+    QObject::connect(treeModel, &QAbstractItemModel::rowsInserted,
+                     this, [=](const QModelIndex &parent, int first, int last){
+        for(int row = first; row <= last; row++)
+        {
+            QModelIndex index = treeModel->index(row, TreeModelDialogImport::Model::ColumnIndexAction, parent);
+            ui->treeView->openPersistentEditor(index);
+
+            if(isExpandedOnFetch && !parent.isValid())
+                ui->treeView->expand(index.siblingAtColumn(TreeModelDialogImport::Model::ColumnIndexSymbolPath));
+        }
+    });
+
     ui->treeView->setModel(treeModel);
 
     ui->treeView->header()->setSectionResizeMode(QHeaderView::ResizeMode::ResizeToContents);
@@ -148,14 +187,6 @@ void DialogImport::on_buttonSelectFile_clicked()
 
     ui->treeView->setSelectionMode(QAbstractItemView::SelectionMode::ContiguousSelection);
     ui->treeView->setItemDelegateForColumn(TreeModelDialogImport::Model::ColumnIndexAction, itemDelegateAction);
-    ui->treeView->expandAll();
-    ui->treeView->selectAll();
-
-    QItemSelectionModel *selectionModel = ui->treeView->selectionModel();
-    for(const QModelIndex &index : selectionModel->selectedRows(TreeModelDialogImport::Model::ColumnIndexAction))
-        ui->treeView->openPersistentEditor(index);
-
-    ui->treeView->clearSelection();
 }
 
 void DialogImport::on_buttonImport_clicked()
@@ -169,94 +200,18 @@ void DialogImport::on_buttonImport_clicked()
     ui->treeView->showColumn(TreeModelDialogImport::Model::ColumnIndexResult);
     showStatusInfo(statusTextFilesBeingImported(), ui->labelStatus);
 
-    QFuture<void> future = QtConcurrent::run([=]{
-        QMapIterator<QString, TreeModelDialogImport::TreeItem *> mapIterator(treeModel->getFolderItemMap());
-        auto fsm = FileStorageManager::instance();
-        QuaZip archive(ui->lineEdit->text());
-        archive.open(QuaZip::Mode::mdUnzip);
-        int progressValue = 0;
+    auto task = QSharedPointer<TaskImportZip>(new TaskImportZip(ui->lineEdit->text(), treeModel), &QObject::deleteLater);
 
-        while(mapIterator.hasNext())
-        {
-            mapIterator.next();
-
-            TreeModelDialogImport::TreeItem *folderItem = mapIterator.value();
-            if(folderItem->getAction() == TreeModelDialogImport::TreeItem::DoNotImport)
-            {
-                progressValue += folderItem->childCount();
-                emit signalProgressUpdate(progressValue);
-                continue;
-            }
-
-            fsm->addNewFolder(mapIterator.key(), "");
-
-            for(int index = 0; index < folderItem->childCount(); index++)
-            {
-                emit signalProgressUpdate(++progressValue);
-
-                bool addingFirstVersion = true;
-                TreeModelDialogImport::TreeItem *childFileItem = folderItem->child(index);
-                if(childFileItem->getAction() != TreeModelDialogImport::TreeItem::Action::Import &&
-                   childFileItem->getAction() != TreeModelDialogImport::TreeItem::Action::Overwrite)
-                {
-                    continue;
-                }
-
-                QString symbolFilePath = childFileItem->getFileJson()[JsonKeys::File::SymbolFilePath].toString();
-                QJsonObject previousFile = fsm->getFileJsonBySymbolPath(symbolFilePath);
-                fsm->deleteFile(symbolFilePath);
-
-                if(previousFile[JsonKeys::IsExist].toBool() && !previousFile[JsonKeys::File::IsFrozen].toBool())
-                    emit signalFileImportStartedForActiveFile(previousFile[JsonKeys::File::UserFilePath].toString());
-
-                emit signalFileImportStarted(symbolFilePath);
-
-                QJsonArray versionList = childFileItem->getFileJson()[JsonKeys::File::VersionList].toArray();
-                for(const QJsonValue &currentValue : versionList)
-                {
-                    QJsonObject versionJson = currentValue.toObject();
-                    archive.setCurrentFile(versionJson[JsonKeys::FileVersion::InternalFileName].toString());
-
-                    QuaZipFile fileInZip(&archive);
-                    fileInZip.open(QFile::OpenModeFlag::ReadOnly);
-                    QTemporaryFile tempFile;
-                    tempFile.open();
-
-                    while(!fileInZip.atEnd())
-                    {
-                        tempFile.write(fileInZip.read(104857600)); // Read up to 100mb.
-                        tempFile.flush();
-                    }
-
-                    bool isAdded = false;
-                    QString description = versionJson[JsonKeys::FileVersion::Description].toString();
-
-                    if(!addingFirstVersion)
-                        isAdded = fsm->appendVersion(symbolFilePath, tempFile.fileName(), description);
-                    else
-                    {
-                        isAdded = fsm->addNewFile(childFileItem->getFileJson()[JsonKeys::File::SymbolFolderPath].toString(),
-                                                  tempFile.fileName(),
-                                                  true,
-                                                  childFileItem->getName(),
-                                                  description);
-                    }
-
-                    addingFirstVersion = false;
-
-                    if(isAdded)
-                        emit signalFileImported(symbolFilePath);
-                    else
-                    {
-                        emit signalFileImportFailed(symbolFilePath);
-                        allFilesImportedSuccessfully = false;
-                    }
-                }
-            }
-        }
-    });
+    QObject::connect(task.get(), &TaskImportZip::signalFileImportStartedForActiveFile,
+                     this, &DialogImport::signalFileImportStartedForActiveFile);
+    QObject::connect(task.get(), &TaskImportZip::signalFileImportStarted,
+                     this, &DialogImport::signalFileImportStarted);
+    QObject::connect(task.get(), &TaskImportZip::signalFileImported,
+                     this, &DialogImport::signalFileImported);
+    QObject::connect(task.get(), &TaskImportZip::signalFileImportFailed,
+                     this, &DialogImport::signalFileImportFailed);
 
-    futureWatcher.setFuture(future);
+    activeJobId = JobScheduler::instance()->submit(task);
     ui->buttonImport->setEnabled(false);
 }
 
@@ -304,6 +259,21 @@ QString DialogImport::statusTextFilesBeingImported()
     return tr("Files being imported in background...");
 }
 
+QString DialogImport::statusTextFilesBeingImportedWithRemainingTime(qint64 remainingMsecs)
+{
+    qint64 remainingSeconds = remainingMsecs / 1000;
+    QString remainingTime = QString("%1:%2:%3").arg(remainingSeconds / 3600)
+                                               .arg((remainingSeconds / 60) % 60, 2, 10, QChar('0'))
+                                               .arg(remainingSeconds % 60, 2, 10, QChar('0'));
+
+    return tr("Files being imported in background, about <b>%1</b> left...").arg(remainingTime);
+}
+
+QString DialogImport::statusTextFileImportCancelled()
+{
+    return tr("Import cancelled. Importing same <b>zip file</b> again continues where it stopped");
+}
+
 QString DialogImport::statusTextFileImportFinishedWithoutError()
 {
     return tr("<b>All files</b> added successfully");
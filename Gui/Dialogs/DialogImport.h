@@ -3,9 +3,9 @@
 
 #include "BaseDialog.h"
 #include "DataModels/DialogImport/ItemDelegateAction.h"
+#include "Utility/BackgroundJob.h"
 
 #include <QDialog>
-#include <QFutureWatcher>
 
 namespace Ui {
 class DialogImport;
@@ -16,13 +16,15 @@ class DialogImport : public QDialog, public BaseDialog
     Q_OBJECT
 
 public:
+    // Folders of smaller archives are expanded as soon as they are fetched.
+    static const inline int ExpandedFileCountLimit = 1000;
+
     explicit DialogImport(QWidget *parent = nullptr);
     ~DialogImport();
 
     void show();
 
 signals:
-    void signalProgressUpdate(int value);
     void signalFileImportStartedForActiveFile(const QString &userFilePath);
     void signalFileImportStarted(const QString &symbolFilePath);
     void signalFileImported(const QString &symbolFilePath);
@@ -44,12 +46,14 @@ private:
     static QString statusTextImportJsonFileCorrupt();
     static QString statusTextZipFileReadyToImport();
     static QString statusTextFilesBeingImported();
+    static QString statusTextFilesBeingImportedWithRemainingTime(qint64 remainingMsecs);
+    static QString statusTextFileImportCancelled();
     static QString statusTextFileImportFinishedWithoutError();
     static QString statusTextFileImportFinishedWithError();
 
     Ui::DialogImport *ui;
     TreeModelDialogImport::ItemDelegateAction *itemDelegateAction;
-    QFutureWatcher<void> futureWatcher;
+    qint64 activeJobId; // 0 when no import is running
     bool allFilesImportedSuccessfully;
 };
 
@@ -2,8 +2,9 @@
 #include "ui_MainWindow.h"
 
 #include "Utility/AppConfig.h"
-#include "Utility/JsonDtoFormat.h"
+#include "Utility/JobScheduler.h"
 #include "Backend/FileStorageSubSystem/FileStorageManager.h"
+#include "Backend/FileStorageSubSystem/IntegrityScrubJob.h"
 
 #include <QDir>
 #include <QTabBar>
@@ -50,6 +51,15 @@ MainWindow::MainWindow(QWidget *parent) :
     QObject::connect(tabFileMonitor, &TabFileMonitor::signalEnableSaveAllButton,
                      ui->tab2Action_SaveAll, &QAction::setEnabled);
 
+    // Integrity scrub may be started at launch, before this window exists.
+    scrubJobId = -1;
+
+    QObject::connect(JobScheduler::instance(), &JobScheduler::signalJobProgress,
+                     this, &MainWindow::onJobProgress);
+
+    QObject::connect(JobScheduler::instance(), &JobScheduler::signalJobFinished,
+                     this, &MainWindow::onJobFinished);
+
     createFileMonitorThread(dialogImport, tabFileExplorer);
 }
 
@@ -190,20 +200,24 @@ void MainWindow::createFileMonitorThread(const DialogImport * const dialogImport
 
     auto fsm = FileStorageManager::instance();
 
-    QJsonArray activeFolders = fsm->getActiveFolderList();
-    QJsonArray activeFiles = fsm->getActiveFileList();
+    QList<FolderRecord> activeFolders = fsm->getActiveFolders();
+    QList<FileRecord> activeFiles = fsm->getActiveFiles();
     QStringList predictionList;
+    predictionList.reserve(activeFolders.size() + activeFiles.size());
 
-    for(const QJsonValue &value : activeFolders)
-        predictionList << value.toObject()[JsonKeys::Folder::UserFolderPath].toString();
+    for(const FolderRecord &record : activeFolders)
+        predictionList << record.userFolderPath;
 
-    for(const QJsonValue &value : activeFiles)
-        predictionList << value.toObject()[JsonKeys::File::UserFilePath].toString();
+    for(const FileRecord &record : activeFiles)
+        predictionList << record.userFilePath;
 
     fmm->setPredictionList(predictionList);
 
-    QObject::connect(fmm, &FileMonitoringManager::signalEventDbUpdated,
-                     tabFileMonitor, &TabFileMonitor::onEventDbUpdated);
+    QObject::connect(fmm, &FileMonitoringManager::signalSnapshotPublished,
+                     tabFileMonitor, &TabFileMonitor::onSnapshotPublished);
+
+    QObject::connect(tabFileMonitor, &TabFileMonitor::signalSnapshotRequested,
+                     fmm, &FileMonitoringManager::requestSnapshot);
 
     QObject::connect(fileMonitorThread, &QThread::started,
                      fmm, &FileMonitoringManager::start);
@@ -270,6 +284,48 @@ void MainWindow::on_menuAction_Settings_triggered()
     dialogSettings->show();
 }
 
+void MainWindow::on_menuAction_VerifyStorage_triggered()
+{
+    scrubJobId = IntegrityScrubJob::submitIfIdle();
+    ui->statusbar->showMessage(tr("Storage verification is queued."));
+}
+
+void MainWindow::onJobProgress(qint64 jobId, qint64 doneCount, qint64 totalCount, qint64 remainingMsecs)
+{
+    IntegrityScrubJob::Status status = IntegrityScrubJob::getStatus();
+
+    if(jobId != status.jobId)
+        return;
+
+    scrubJobId = jobId;
+
+    QString message = tr("Verifying storage: %1 of %2 versions checked").arg(doneCount).arg(totalCount);
+
+    if(status.corruptCount > 0)
+        message += tr(", %1 corrupt").arg(status.corruptCount);
+
+    if(remainingMsecs >= 0)
+        message += tr(", about %1 minutes left").arg(remainingMsecs / 60000 + 1);
+
+    ui->statusbar->showMessage(message);
+}
+
+void MainWindow::onJobFinished(qint64 jobId, BackgroundJob::State state)
+{
+    if(jobId != scrubJobId)
+        return;
+
+    scrubJobId = -1;
+    IntegrityScrubJob::Status status = IntegrityScrubJob::getStatus();
+
+    if(state != BackgroundJob::State::Succeeded)
+        ui->statusbar->showMessage(tr("Storage verification stopped, it continues on next start."));
+    else if(status.corruptCount > 0)
+        ui->statusbar->showMessage(tr("Storage verified, %1 corrupt versions found. See the log for details.").arg(status.corruptCount));
+    else
+        ui->statusbar->showMessage(tr("Storage verified, no corrupt versions found."));
+}
+
 void MainWindow::on_menuAction_DebugFileMonitor_triggered()
 {
     dialogDebugFileMonitor->show();
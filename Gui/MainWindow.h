@@ -8,6 +8,7 @@
 #include "Dialogs/DialogAddNewFolder.h"
 #include "Dialogs/DialogDebugFileMonitor.h"
 #include "Backend/FileMonitorSubSystem/FileMonitoringManager.h"
+#include "Utility/BackgroundJob.h"
 
 #include <QThread>
 #include <QMainWindow>
@@ -42,6 +43,9 @@ private slots:
     void on_tab1Action_Import_triggered();
     void on_tab2Action_SaveAll_triggered();
     void on_menuAction_Settings_triggered();
+    void on_menuAction_VerifyStorage_triggered();
+    void onJobProgress(qint64 jobId, qint64 doneCount, qint64 totalCount, qint64 remainingMsecs);
+    void onJobFinished(qint64 jobId, BackgroundJob::State state);
     void on_menuAction_DebugFileMonitor_triggered();
     void on_menuAction_AboutApp_triggered();
     void on_menuAction_AboutQt_triggered();
@@ -69,6 +73,7 @@ private:
     DialogDebugFileMonitor *dialogDebugFileMonitor;
     FileMonitoringManager *fmm;
     QThread *fileMonitorThread;
+    qint64 scrubJobId; // Last integrity scrub seen, -1 when none
 
 };
 
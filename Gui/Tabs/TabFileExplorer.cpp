@@ -36,6 +36,8 @@ TabFileExplorer::TabFileExplorer(QWidget *parent) :
     ui->tableView->horizontalHeader()->setMinimumSectionSize(110);
     ui->tableView->horizontalHeader()->setSectionResizeMode(QHeaderView::ResizeMode::Interactive);
     ui->tableView->viewport()->installEventFilter(this); // uses TabFileExplorer::eventFilter();
+    ui->tableView->horizontalHeader()->setSortIndicator(TableModelFileExplorer::ColumnIndexName, Qt::SortOrder::AscendingOrder);
+    ui->tableView->setSortingEnabled(true);
 
     ui->lineEditWorkingDir->setText(FileStorageManager::separator);
     displayFolderInTableViewFileExplorer(FileStorageManager::separator);
@@ -107,13 +109,22 @@ void TabFileExplorer::createNavigationHistoryIndex(const QString &path)
 void TabFileExplorer::displayFolderInTableViewFileExplorer(const QString &symbolFolderPath)
 {
     auto fsm = FileStorageManager::instance();
-    QJsonObject folderJson = fsm->getFolderJsonBySymbolPath(symbolFolderPath, true);
+    QJsonObject folderJson = fsm->getFolderJsonBySymbolPath(symbolFolderPath);
     QTableView *tableView = ui->tableView;
+    QHeaderView *header = tableView->horizontalHeader();
 
     if(tableView->model() != nullptr)
         delete tableView->model();
 
-    auto tableModel = new TableModelFileExplorer(folderJson, this);
+    // Rows are fetched page by page in background when view asks for them.
+    auto tableModel = new TableModelFileExplorer(folderJson[JsonKeys::Folder::SymbolFolderPath].toString(), this);
+    tableModel->sort(header->sortIndicatorSection(), header->sortIndicatorOrder());
+
+    QObject::connect(tableModel, &QAbstractItemModel::rowsInserted, tableView, [tableView](const QModelIndex &parent, int first) {
+        if(!parent.isValid() && first == 0)
+            tableView->resizeColumnsToContents();
+    });
+
     tableView->setModel(tableModel);
 
     ui->lineEditWorkingDir->setText(folderJson[JsonKeys::Folder::SymbolFolderPath].toString());
@@ -121,7 +132,6 @@ void TabFileExplorer::displayFolderInTableViewFileExplorer(const QString &symbol
     tableView->hideColumn(TableModelFileExplorer::ColumnIndexSymbolPath);
     tableView->hideColumn(TableModelFileExplorer::ColumnIndexItemType);
     tableView->viewport()->update();
-    tableView->resizeColumnsToContents();
 }
 
 // https://stackoverflow.com/a/73912542
@@ -398,13 +408,7 @@ void TabFileExplorer::on_contextActionListView_Preview_triggered()
     QFuture<void> future = QtConcurrent::run([=, &isCopied, &tempFilePath] {
 
         auto fsm = FileStorageManager::instance();
-        QJsonObject versionJson = fsm->getFileVersionJson(fileSymbolPath, versionNumber);
-
-        QString internalFilePath = fsm->getStorageFolderPath();
-        internalFilePath += versionJson[JsonKeys::FileVersion::InternalFileName].toString();
-
-        QFile actualFile(internalFilePath);
-        actualFile.open(QFile::OpenModeFlag::ReadOnly);
+        FileVersionRecord versionRecord = fsm->getFileVersion(fileSymbolPath, versionNumber);
 
         QTemporaryFile tempFile;
         tempFile.open();
@@ -414,7 +418,7 @@ void TabFileExplorer::on_contextActionListView_Preview_triggered()
         if(!fileExtension.isEmpty())
             tempFilePath += "." + fileExtension;
 
-        isCopied = QFile::copy(internalFilePath, tempFilePath);
+        isCopied = fsm->copyVersionFile(versionRecord, tempFilePath, IoScheduler::Budget::Foreground);
     });
 
     futureWatcher.setFuture(future);
@@ -511,10 +515,9 @@ void TabFileExplorer::on_contextActionListView_DeleteVersion_triggered()
             if(recentMaxVersion == selectedVersionNumber) // If current version is deleted
             {
                 fileJson = fsm->getFileJsonBySymbolPath(symbolFilePath);
-                QJsonObject versionJson = fsm->getFileVersionJson(symbolFilePath, fileJson[JsonKeys::File::MaxVersionNumber].toInteger());
-                QString internalFilePath = fsm->getStorageFolderPath() + versionJson[JsonKeys::FileVersion::InternalFileName].toString();
+                FileVersionRecord versionRecord = fsm->getFileVersion(symbolFilePath, fileJson[JsonKeys::File::MaxVersionNumber].toInteger());
                 QFile::remove(userFilePath);
-                QFile::copy(internalFilePath, userFilePath);
+                fsm->copyVersionFile(versionRecord, userFilePath, IoScheduler::Budget::Foreground);
 
                 emit signalStopMonitoringItem(userFilePath);
                 emit signalStartMonitoringItem(userFilePath);
@@ -577,21 +580,15 @@ void TabFileExplorer::on_contextActionListView_SetAsCurrentVersion_triggered()
             auto fsm = FileStorageManager::instance();
             QJsonObject fileJson = fsm->getFileJsonBySymbolPath(symbolFilePath);
             QJsonObject versionJson = fsm->getFileVersionJson(symbolFilePath, selectedVersionNumber);
+            FileVersionRecord versionRecord = fsm->getFileVersion(symbolFilePath, selectedVersionNumber);
             qlonglong newVersionNumber = fileJson[JsonKeys::File::MaxVersionNumber].toInteger() + 1;
             versionJson[JsonKeys::FileVersion::NewVersionNumber] = newVersionNumber;
 
             fsm->updateFileVersionEntity(versionJson);
             fsm->sortFileVersionsInIncreasingOrder(symbolFilePath);
 
-            QString internalFilePath = fsm->getStorageFolderPath();
-            internalFilePath += versionJson[JsonKeys::FileVersion::InternalFileName].toString();
-
-            QFile::copy(internalFilePath, userFilePath);
-            QFile file(userFilePath);
-            file.open(QFile::OpenModeFlag::Append);
-            QString strLastModifiedTimestamp = versionJson[JsonKeys::FileVersion::LastModifiedTimestamp].toString();
-            QDateTime lastModifiedTimestamp = QDateTime::fromString(strLastModifiedTimestamp, Qt::DateFormat::ISODateWithMs);
-            file.setFileTime(lastModifiedTimestamp, QFileDevice::FileTime::FileModificationTime);
+            fsm->copyVersionFile(versionRecord, userFilePath, IoScheduler::Budget::Foreground);
+            FileStat::setModifiedTime(userFilePath, versionRecord.lastModifiedNsecs);
         });
 
         futureWatcher.setFuture(future);
@@ -804,10 +801,9 @@ void TabFileExplorer::executeFreezingOrThawingOfFile(const QString &name, const
             return;
         }
 
-        QJsonObject versionJson = fsm->getFileVersionJson(symbolPath, fileJson[JsonKeys::File::MaxVersionNumber].toInteger());
+        FileVersionRecord versionRecord = fsm->getFileVersion(symbolPath, fileJson[JsonKeys::File::MaxVersionNumber].toInteger());
         QString userFolderPath = parentFolderJson[JsonKeys::Folder::UserFolderPath].toString();
         QString userFilePath = userFolderPath + name;
-        QString internalFilePath = fsm->getStorageFolderPath() + versionJson[JsonKeys::FileVersion::InternalFileName].toString();
 
         bool isExist = QFile::exists(userFilePath);
         if(isExist)
@@ -841,14 +837,8 @@ void TabFileExplorer::executeFreezingOrThawingOfFile(const QString &name, const
             if(isExist)
                 QFile::remove(userFilePath);
 
-            isCopied = QFile::copy(internalFilePath, userFilePath);
-
-            QString strLastModifiedTimestamp = versionJson[JsonKeys::FileVersion::LastModifiedTimestamp].toString();
-            QDateTime lastModifiedTimestamp = QDateTime::fromString(strLastModifiedTimestamp, Qt::DateFormat::ISODateWithMs);
-
-            QFile file(userFilePath);
-            file.open(QFile::OpenModeFlag::Append);
-            isTimestampSet = file.setFileTime(lastModifiedTimestamp, QFileDevice::FileTime::FileModificationTime);
+            isCopied = fsm->copyVersionFile(versionRecord, userFilePath, IoScheduler::Budget::Foreground);
+            isTimestampSet = FileStat::setModifiedTime(userFilePath, versionRecord.lastModifiedNsecs);
         });
 
         futureWatcher.setFuture(future);
@@ -913,19 +903,13 @@ void TabFileExplorer::thawFolderTree(const QString folderName, const QString &pa
                 for(const QJsonValue &currentChildFile : childFiles)
                 {
                     QJsonObject fileJson = currentChildFile.toObject();
-                    QJsonObject versionJson = fsm->getFileVersionJson(fileJson[JsonKeys::File::SymbolFilePath].toString(),
-                                                                      fileJson[JsonKeys::File::MaxVersionNumber].toInteger());
+                    FileVersionRecord versionRecord = fsm->getFileVersion(fileJson[JsonKeys::File::SymbolFilePath].toString(),
+                                                                          fileJson[JsonKeys::File::MaxVersionNumber].toInteger());
 
-                    QString internalFilePath = fsm->getStorageFolderPath();
-                    internalFilePath.append(versionJson[JsonKeys::FileVersion::InternalFileName].toString());
                     QString userFilePath = currentUserPath + fileJson[JsonKeys::File::FileName].toString();
 
-                    bool isCopied = QFile::copy(internalFilePath, userFilePath);
-                    QFile file(userFilePath);
-                    file.open(QFile::OpenModeFlag::Append);
-                    QString strLastModifiedTimestamp = versionJson[JsonKeys::FileVersion::LastModifiedTimestamp].toString();
-                    QDateTime lastModifiedTimestamp = QDateTime::fromString(strLastModifiedTimestamp, Qt::DateFormat::ISODateWithMs);
-                    bool isTimestampSet = file.setFileTime(lastModifiedTimestamp, QFileDevice::FileTime::FileModificationTime);
+                    bool isCopied = fsm->copyVersionFile(versionRecord, userFilePath, IoScheduler::Budget::Foreground);
+                    bool isTimestampSet = FileStat::setModifiedTime(userFilePath, versionRecord.lastModifiedNsecs);
 
                     if(isCopied && isTimestampSet)
                         emit signalStartMonitoringItem(userFilePath); // Notify about copied file
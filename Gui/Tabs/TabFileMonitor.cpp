@@ -2,8 +2,6 @@
 #include "ui_TabFileMonitor.h"
 
 #include "Tasks/TaskSaveChanges.h"
-#include "Utility/DatabaseRegistry.h"
-#include "DataModels/TabFileMonitor/TreeModelFileMonitor.h"
 
 TabFileMonitor::TabFileMonitor(QWidget *parent) :
     QWidget(parent),
@@ -12,14 +10,38 @@ TabFileMonitor::TabFileMonitor(QWidget *parent) :
     ui->setupUi(this);
     ui->progressBar->hide();
 
+    ui->labelStatus->setText("Analyzing detected changes...");
+
+    isSaveInProgress = false;
     itemDelegateAction = new TreeModelFileMonitor::ItemDelegateAction(this);
     itemDelegateDescription = new TreeModelFileMonitor::ItemDelegateDescription(this);
 
-    timer.setInterval(2000);
-    timer.stop();
+    // Model lives as long as the tab, snapshots only patch the rows which changed.
+    treeModel = new TreeModelFileMonitor::Model(this);
+    ui->treeView->setModel(treeModel);
+    ui->comboBoxDescriptionNumber->setModel(treeModel->getDescriptionNumberListModel());
+
+    QHeaderView *header = ui->treeView->header();
+    header->setSectionResizeMode(QHeaderView::ResizeMode::ResizeToContents);
+    header->setSectionResizeMode(TreeModelFileMonitor::Model::ColumnIndexUserPath, QHeaderView::ResizeMode::Interactive);
+    header->setMinimumSectionSize(130);
+    ui->treeView->setColumnWidth(TreeModelFileMonitor::Model::ColumnIndexUserPath, 500);
+
+    ui->treeView->setItemDelegateForColumn(TreeModelFileMonitor::Model::ColumnIndexAction, itemDelegateAction);
+    ui->treeView->setItemDelegateForColumn(TreeModelFileMonitor::Model::ColumnIndexDescription, itemDelegateDescription);
+    ui->treeView->setSelectionMode(QAbstractItemView::SelectionMode::SingleSelection);
+
+    QObject::connect(treeModel, &QAbstractItemModel::rowsInserted,
+                     this, &TabFileMonitor::onRowsInserted);
 
-    QObject::connect(&timer, &QTimer::timeout,
-                     this, &TabFileMonitor::displayFileMonitorContent);
+    QObject::connect(treeModel, &QAbstractItemModel::dataChanged,
+                     this, &TabFileMonitor::onDataChanged);
+
+    QObject::connect(treeModel, &QAbstractItemModel::modelReset,
+                     this, &TabFileMonitor::onModelReset);
+
+    QObject::connect(treeModel, &TreeModelFileMonitor::Model::signalEventAppeared,
+                     ui->treeView, &QTreeView::expand);
 }
 
 TabFileMonitor::~TabFileMonitor()
@@ -35,8 +57,9 @@ void TabFileMonitor::saveChanges(FileMonitoringManager *fmm)
     ui->buttonAddDescription->setDisabled(true);
     ui->buttonDeleteDescription->setDisabled(true);
 
-    auto treeModel = (TreeModelFileMonitor::Model *)(ui->treeView->model());
-    Q_ASSERT(treeModel);
+    // Task works on tree items, so snapshots wait until it finishes.
+    isSaveInProgress = true;
+    treeModel->fetchEventfulItems();
 
     TaskSaveChanges *task = new TaskSaveChanges(treeModel->getFolderItemMap(),
                                                 treeModel->getFileItemMap(),
@@ -61,6 +84,9 @@ void TabFileMonitor::saveChanges(FileMonitoringManager *fmm)
                      fmm, &FileMonitoringManager::addTargetAtRuntime,
                      Qt::ConnectionType::BlockingQueuedConnection);
 
+    QObject::connect(task, &QThread::finished,
+                     this, &TabFileMonitor::onSaveChangesFinished);
+
     QObject::connect(task, &QThread::finished,
                      task, &QThread::deleteLater);
 
@@ -71,34 +97,45 @@ void TabFileMonitor::saveChanges(FileMonitoringManager *fmm)
 
 void TabFileMonitor::onEventDbUpdated()
 {
-    emit signalEnableSaveAllButton(false);
+    emit signalSnapshotRequested();
+}
+
+void TabFileMonitor::onSnapshotPublished(QSharedPointer<const FileMonitorSnapshot> snapshot)
+{
+    if(isSaveInProgress)
+        pendingSnapshot = snapshot;
+    else
+        displayFileMonitorContent(*snapshot);
+}
 
-    QString statusText = "Analyzing detected changes...";
-    ui->labelStatus->setHidden(false);
-    ui->labelStatus->setText(statusText);
+void TabFileMonitor::onSaveChangesFinished()
+{
+    isSaveInProgress = false;
 
-    ui->textEditDescription->setDisabled(true);
+    // Processed items and disabled editors are dropped, tree is rebuilt from the latest state.
     ui->textEditDescription->blockSignals(true);
     ui->textEditDescription->clear();
     ui->textEditDescription->blockSignals(false);
 
-    ui->buttonAddDescription->setDisabled(true);
-    ui->buttonDeleteDescription->setDisabled(true);
+    treeModel->clear();
 
-    timer.start();
+    if(!pendingSnapshot.isNull())
+    {
+        displayFileMonitorContent(*pendingSnapshot);
+        pendingSnapshot.reset();
+    }
+
+    emit signalSnapshotRequested();
 }
 
-void TabFileMonitor::displayFileMonitorContent()
+void TabFileMonitor::displayFileMonitorContent(const FileMonitorSnapshot &snapshot)
 {
-    timer.stop();
+    bool isChanged = treeModel->applySnapshot(snapshot);
 
-    FileSystemEventDb fsEventDb(DatabaseRegistry::fileSystemEventDatabase());
+    emit signalEnableSaveAllButton(snapshot.isContainAnyEvent);
 
-    if(fsEventDb.isContainAnyFolderEvent() || fsEventDb.isContainAnyFileEvent())
-    {
-        emit signalEnableSaveAllButton(true);
+    if(isChanged && snapshot.isContainAnyEvent)
         emit signalFileMonitorRefreshed();
-    }
 
     ui->labelStatus->setHidden(true);
     ui->progressBar->hide();
@@ -106,39 +143,45 @@ void TabFileMonitor::displayFileMonitorContent()
     ui->textEditDescription->setReadOnly(false);
     ui->buttonAddDescription->setEnabled(true);
     ui->buttonDeleteDescription->setEnabled(true);
+}
 
-    TreeModelFileMonitor::Model *treeModel = new TreeModelFileMonitor::Model();
-    QAbstractItemModel *oldModel = ui->treeView->model();
-
-    if(oldModel != nullptr)
-        delete oldModel;
+void TabFileMonitor::onRowsInserted(const QModelIndex &parent, int first, int last)
+{
+    if(parent.isValid())
+        ui->treeView->expand(parent);
 
-    ui->treeView->setModel(treeModel);
-    ui->comboBoxDescriptionNumber->setModel(treeModel->getDescriptionNumberListModel());
+    prepareRows(parent, first, last);
+}
 
-    QHeaderView *header = ui->treeView->header();
-    header->setSectionResizeMode(QHeaderView::ResizeMode::ResizeToContents);
-    header->setSectionResizeMode(TreeModelFileMonitor::Model::ColumnIndexUserPath, QHeaderView::ResizeMode::Interactive);
-    header->setMinimumSectionSize(130);
-    ui->treeView->setColumnWidth(TreeModelFileMonitor::Model::ColumnIndexUserPath, 500);
+// Action choices depend on status, so action editors are created again.
+void TabFileMonitor::onDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight)
+{
+    for(int row = topLeft.row(); row <= bottomRight.row(); ++row)
+    {
+        QModelIndex index = treeModel->index(row, TreeModelFileMonitor::Model::ColumnIndexAction, topLeft.parent());
+        ui->treeView->closePersistentEditor(index);
+        ui->treeView->openPersistentEditor(index);
+    }
+}
 
-    ui->treeView->setItemDelegateForColumn(TreeModelFileMonitor::Model::ColumnIndexAction, itemDelegateAction);
-    ui->treeView->setItemDelegateForColumn(TreeModelFileMonitor::Model::ColumnIndexDescription, itemDelegateDescription);
+void TabFileMonitor::onModelReset()
+{
+    prepareRows(QModelIndex(), 0, treeModel->rowCount() - 1);
+}
 
-    ui->treeView->expandAll();
+// Opens editors of the rows, folders with events below them are expanded and fetched by the view.
+void TabFileMonitor::prepareRows(const QModelIndex &parent, int first, int last)
+{
+    for(int row = first; row <= last; ++row)
+    {
+        QModelIndex index = treeModel->index(row, TreeModelFileMonitor::Model::ColumnIndexUserPath, parent);
 
-    ui->treeView->setSelectionMode(QAbstractItemView::SelectionMode::ContiguousSelection);
-    ui->treeView->selectAll();
-    QModelIndexList selectedIndices = ui->treeView->selectionModel()->selectedIndexes();
+        ui->treeView->openPersistentEditor(index.siblingAtColumn(TreeModelFileMonitor::Model::ColumnIndexAction));
+        ui->treeView->openPersistentEditor(index.siblingAtColumn(TreeModelFileMonitor::Model::ColumnIndexDescription));
 
-    for(const QModelIndex &current : selectedIndices)
-    {
-        ui->treeView->openPersistentEditor(current.siblingAtColumn(TreeModelFileMonitor::Model::ColumnIndexAction));
-        ui->treeView->openPersistentEditor(current.siblingAtColumn(TreeModelFileMonitor::Model::ColumnIndexDescription));
+        if(treeModel->isContainEvent(index))
+            ui->treeView->expand(index);
     }
-
-    ui->treeView->setSelectionMode(QAbstractItemView::SelectionMode::SingleSelection);
-    ui->treeView->selectionModel()->clearSelection();
 }
 
 void TabFileMonitor::on_buttonAddDescription_clicked()
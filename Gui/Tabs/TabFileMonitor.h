@@ -3,10 +3,11 @@
 
 #include "DataModels/TabFileMonitor/ItemDelegateAction.h"
 #include "DataModels/TabFileMonitor/ItemDelegateDescription.h"
+#include "DataModels/TabFileMonitor/TreeModelFileMonitor.h"
 #include "Backend/FileMonitorSubSystem/FileMonitoringManager.h"
 
-#include <QTimer>
 #include <QWidget>
+#include <QSharedPointer>
 
 namespace Ui {
 class TabFileMonitor;
@@ -24,13 +25,18 @@ public:
 
 public slots:
     void onEventDbUpdated();
+    void onSnapshotPublished(QSharedPointer<const FileMonitorSnapshot> snapshot);
 
 signals:
     void signalEnableSaveAllButton(bool flag);
     void signalFileMonitorRefreshed();
+    void signalSnapshotRequested();
 
 private slots:
-    void displayFileMonitorContent();
+    void onSaveChangesFinished();
+    void onRowsInserted(const QModelIndex &parent, int first, int last);
+    void onDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight);
+    void onModelReset();
 
     void on_buttonAddDescription_clicked();
     void on_buttonDeleteDescription_clicked();
@@ -38,10 +44,15 @@ private slots:
     void on_comboBoxDescriptionNumber_activated(int index);
 
 private:
+    void displayFileMonitorContent(const FileMonitorSnapshot &snapshot);
+    void prepareRows(const QModelIndex &parent, int first, int last);
+
     Ui::TabFileMonitor *ui;
+    TreeModelFileMonitor::Model *treeModel;
     TreeModelFileMonitor::ItemDelegateAction *itemDelegateAction;
     TreeModelFileMonitor::ItemDelegateDescription *itemDelegateDescription;
-    QTimer timer;
+    QSharedPointer<const FileMonitorSnapshot> pendingSnapshot;
+    bool isSaveInProgress;
 };
 
 #endif // TABFILEMONITOR_H
@@ -1,5 +1,6 @@
 #include "TaskAddNewFolders.h"
 
+#include "Utility/IoScheduler.h"
 #include "Backend/FileStorageSubSystem/FileStorageManager.h"
 
 #include <QDir>
@@ -26,6 +27,7 @@ int TaskAddNewFolders::fileCount() const
 
 void TaskAddNewFolders::run()
 {
+    IoScheduler::BackgroundScope backgroundScope;
     auto fsm = FileStorageManager::instance();
     int fileNumber = 1;
     bool isAllRequestSuccessful = true;
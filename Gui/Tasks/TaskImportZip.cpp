@@ -0,0 +1,146 @@
+#include "TaskImportZip.h"
+
+#include "Utility/FileStat.h"
+#include "Utility/ChunkBufferPool.h"
+#include "Utility/JsonDtoFormat.h"
+#include "Backend/FileStorageSubSystem/FileStorageManager.h"
+
+#include <quazip/quazip.h>
+#include <quazip/quazipfile.h>
+#include <QJsonArray>
+#include <QTemporaryFile>
+
+TaskImportZip::TaskImportZip(const QString &zipFilePath, TreeModelDialogImport::Model *treeModel)
+    : QObject{nullptr},
+      BackgroundJob(BackgroundJob::Priority::Normal, BackgroundJob::PoolType::Io)
+{
+    this->zipFilePath = zipFilePath;
+    this->treeModel = treeModel;
+
+    // Same path with different content must not resume old checkpoint.
+    FileStat stat = FileStat::read(zipFilePath);
+    zipFileKey = QString("%1|%2|%3").arg(zipFilePath).arg(stat.size).arg(stat.modifiedNsecs);
+}
+
+QString TaskImportZip::checkpointKey() const
+{
+    return "import_zip|" + zipFileKey;
+}
+
+bool TaskImportZip::run()
+{
+    auto fsm = FileStorageManager::instance();
+    QuaZip archive(zipFilePath);
+
+    if(!archive.open(QuaZip::Mode::mdUnzip))
+        return false;
+
+    // Checkpoint is position of last file whose all versions are imported.
+    qint64 resumePosition = loadCheckpoint().toLongLong();
+    qint64 totalFileCount = treeModel->getTotalFileCount();
+    qint64 position = 0;
+
+    for(int folderNumber = 0; folderNumber < treeModel->getFolderCount(); folderNumber++)
+    {
+        int fileCount = treeModel->getFileCountOfFolder(folderNumber);
+
+        if(!treeModel->isFolderImported(folderNumber))
+        {
+            position += fileCount;
+            setProgress(position, totalFileCount);
+            continue;
+        }
+
+        fsm->addNewFolder(treeModel->getSymbolFolderPath(folderNumber), "");
+
+        QList<QJsonObject> fileJsonList = treeModel->getFileJsonListToImport(folderNumber);
+        position += fileCount - fileJsonList.size(); // Skipped files
+
+        for(const QJsonObject &fileJson : fileJsonList)
+        {
+            if(isCancelRequested())
+                return false;
+
+            ++position;
+            setProgress(position, totalFileCount);
+
+            QString symbolFilePath = fileJson[JsonKeys::File::SymbolFilePath].toString();
+
+            if(position <= resumePosition) // Imported by the interrupted run
+            {
+                emit signalFileImported(symbolFilePath);
+                continue;
+            }
+
+            bool addingFirstVersion = true;
+
+            FileRecord previousFile = fsm->getFileBySymbolPath(symbolFilePath);
+            fsm->deleteFile(symbolFilePath);
+
+            if(previousFile.isExist && !previousFile.isFrozen)
+                emit signalFileImportStartedForActiveFile(previousFile.userFilePath);
+
+            emit signalFileImportStarted(symbolFilePath);
+
+            QJsonArray versionList = fileJson[JsonKeys::File::VersionList].toArray();
+            for(const QJsonValue &currentValue : versionList)
+            {
+                QJsonObject versionJson = currentValue.toObject();
+                archive.setCurrentFile(versionJson[JsonKeys::FileVersion::InternalFileName].toString());
+
+                QuaZipFile fileInZip(&archive);
+                fileInZip.open(QFile::OpenModeFlag::ReadOnly);
+                QTemporaryFile tempFile;
+                tempFile.open();
+
+                // Lease is released before adding the file, which copies through the pool too.
+                {
+                    ChunkBufferPool::Lease buffer;
+
+                    while(!fileInZip.atEnd())
+                    {
+                        // Half imported file is imported again from its first version on resume.
+                        if(isCancelRequested())
+                            return false;
+
+                        qint64 readCount = fileInZip.read(buffer.data(), buffer.size());
+
+                        if(readCount > 0)
+                            tempFile.write(buffer.data(), readCount);
+                        else
+                            break;
+                    }
+
+                    tempFile.flush();
+                }
+
+                bool isAdded = false;
+                QString description = versionJson[JsonKeys::FileVersion::Description].toString();
+
+                if(!addingFirstVersion)
+                    isAdded = fsm->appendVersion(symbolFilePath, tempFile.fileName(), description);
+                else
+                {
+                    isAdded = fsm->addNewFile(fileJson[JsonKeys::File::SymbolFolderPath].toString(),
+                                              tempFile.fileName(),
+                                              true,
+                                              fileJson[JsonKeys::File::FileName].toString(),
+                                              description);
+                }
+
+                addingFirstVersion = false;
+
+                if(isAdded)
+                    emit signalFileImported(symbolFilePath);
+                else
+                    emit signalFileImportFailed(symbolFilePath);
+            }
+
+            saveCheckpoint(QByteArray::number(position));
+        }
+    }
+
+    setProgress(totalFileCount, totalFileCount);
+
+    return true;
+}
@@ -0,0 +1,34 @@
+#ifndef TASKIMPORTZIP_H
+#define TASKIMPORTZIP_H
+
+#include "Utility/BackgroundJob.h"
+#include "DataModels/DialogImport/TreeModelDialogImport.h"
+
+#include <QObject>
+
+// Imports selected files of an exported zip file as frozen files.
+// Interrupted imports of the same zip file continue after the last imported file.
+class TaskImportZip : public QObject, public BackgroundJob
+{
+    Q_OBJECT
+public:
+    TaskImportZip(const QString &zipFilePath, TreeModelDialogImport::Model *treeModel);
+
+    QString checkpointKey() const override;
+
+signals:
+    void signalFileImportStartedForActiveFile(const QString &userFilePath);
+    void signalFileImportStarted(const QString &symbolFilePath);
+    void signalFileImported(const QString &symbolFilePath);
+    void signalFileImportFailed(const QString &symbolFilePath);
+
+protected:
+    bool run() override;
+
+private:
+    QString zipFilePath;
+    QString zipFileKey;
+    TreeModelDialogImport::Model *treeModel;
+};
+
+#endif // TASKIMPORTZIP_H
@@ -1,8 +1,6 @@
 #include "TaskSaveChanges.h"
 
 #include "Backend/FileStorageSubSystem/FileStorageManager.h"
-#include "Utility/DatabaseRegistry.h"
-#include "Utility/JsonDtoFormat.h"
 
 #include <QDir>
 #include <QFile>
@@ -30,7 +28,7 @@ void TaskSaveChanges::run()
 void TaskSaveChanges::saveFolderChanges()
 {
     auto fsm = FileStorageManager::instance();
-    FileSystemEventDb fsEventDb(DatabaseRegistry::fileSystemEventDatabase());
+    FileSystemEventDb fsEventDb;
 
     while(folderItemIterator.hasNext())
     {
@@ -40,12 +38,12 @@ void TaskSaveChanges::saveFolderChanges()
         emit itemBeingProcessed(currentItemNumber);
 
         TreeModelFileMonitor::TreeItem *item = folderItemIterator.value();
-        QJsonObject folderJson = fsm->getFolderJsonByUserPath(item->getUserPath());
+        FolderRecord folderRecord = fsm->getFolderByUserPath(item->getUserPath());
         FileSystemEventDb::ItemStatus status = item->getStatus();
         TreeModelFileMonitor::TreeItem::Action action = item->getAction();
         QDir dir(item->getUserPath());
 
-        if(folderJson[JsonKeys::IsExist].toBool()) // If folder info exist in db
+        if(folderRecord.isExist) // If folder info exist in db
         {
             if(action == TreeModelFileMonitor::TreeItem::Action::Restore) // Restore deleted folders
             {
@@ -55,22 +53,22 @@ void TaskSaveChanges::saveFolderChanges()
             }
             else if(action == TreeModelFileMonitor::TreeItem::Action::Delete) // Remove deleted folders from db
             {
-                bool isRemoved = fsm->deleteFolder(folderJson[JsonKeys::Folder::SymbolFolderPath].toString());
+                bool isRemoved = fsm->deleteFolder(folderRecord.symbolFolderPath);
                 if(isRemoved)
                     fsEventDb.deleteFolder(item->getUserPath());
             }
             else if(action ==  TreeModelFileMonitor::TreeItem::Action::Freeze) // Freeze deleted folders
             {
-                folderJson[JsonKeys::Folder::IsFrozen] = true;
-                bool isUpdated = fsm->updateFolderEntity(folderJson, true);
+                folderRecord.isFrozen = true;
+                bool isUpdated = fsm->updateFolder(folderRecord, true);
                 if(isUpdated)
                     fsEventDb.deleteFolder(item->getUserPath());
             }
         }
         else // If folder info not exist in db
         {
-            QJsonObject parentFolderJson = fsm->getFolderJsonByUserPath(item->getParentItem()->getUserPath());
-            QString symbolFolderPath = parentFolderJson[JsonKeys::Folder::SymbolFolderPath].toString();
+            FolderRecord parentFolderRecord = fsm->getFolderByUserPath(item->getParentItem()->getUserPath());
+            QString symbolFolderPath = parentFolderRecord.symbolFolderPath;
 
             if(action == TreeModelFileMonitor::TreeItem::Action::Save)
             {
@@ -86,11 +84,11 @@ void TaskSaveChanges::saveFolderChanges()
                     symbolFolderPath += fsEventDb.getOldNameOfFolder(item->getUserPath());
                     symbolFolderPath += FileStorageManager::separator;
 
-                    folderJson = fsm->getFolderJsonBySymbolPath(symbolFolderPath);
-                    folderJson[JsonKeys::Folder::SuffixPath] = dir.dirName();
-                    folderJson[JsonKeys::Folder::UserFolderPath] = item->getUserPath();
+                    folderRecord = fsm->getFolderBySymbolPath(symbolFolderPath);
+                    folderRecord.suffixPath = dir.dirName();
+                    folderRecord.userFolderPath = item->getUserPath();
 
-                    bool isSaved = fsm->updateFolderEntity(folderJson);
+                    bool isSaved = fsm->updateFolder(folderRecord);
 
                     if(isSaved)
                     {
@@ -101,7 +99,7 @@ void TaskSaveChanges::saveFolderChanges()
             }
             else if(action == TreeModelFileMonitor::TreeItem::Action::Restore) // Restore renamed folders
             {
-                QString oldFolderPath = parentFolderJson[JsonKeys::Folder::UserFolderPath].toString();
+                QString oldFolderPath = parentFolderRecord.userFolderPath;
                 oldFolderPath += fsEventDb.getOldNameOfFolder(item->getUserPath());
                 dir.removeRecursively();
                 bool isCreated = dir.mkpath(oldFolderPath);
@@ -120,7 +118,7 @@ void TaskSaveChanges::saveFolderChanges()
 void TaskSaveChanges::saveFileChanges()
 {
     auto fsm = FileStorageManager::instance();
-    FileSystemEventDb fsEventDb(DatabaseRegistry::fileSystemEventDatabase());
+    FileSystemEventDb fsEventDb;
 
     while(fileItemIterator.hasNext())
     {
@@ -130,12 +128,12 @@ void TaskSaveChanges::saveFileChanges()
         emit itemBeingProcessed(currentItemNumber);
 
         TreeModelFileMonitor::TreeItem *item = fileItemIterator.value();
-        QJsonObject fileJson = fsm->getFileJsonByUserPath(fileItemIterator.key());
-        QString symbolFilePath = fileJson[JsonKeys::File::SymbolFilePath].toString();
+        FileRecord fileRecord = fsm->getFileByUserPath(fileItemIterator.key());
+        QString symbolFilePath = fileRecord.symbolFilePath;
         FileSystemEventDb::ItemStatus status = item->getStatus();
         TreeModelFileMonitor::TreeItem::Action action = item->getAction();
 
-        if(fileJson[JsonKeys::IsExist].toBool()) // If file info exist in db
+        if(fileRecord.isExist) // If file info exist in db
         {
             if(action == TreeModelFileMonitor::TreeItem::Action::Delete)
             {
@@ -151,27 +149,20 @@ void TaskSaveChanges::saveFileChanges()
             }
             else if(action == TreeModelFileMonitor::TreeItem::Action::Freeze) // Freezes FileSystemEventDb::ItemStatus::Deleted files
             {
-                fileJson[JsonKeys::File::IsFrozen] = true;
-                bool isUpdated = fsm->updateFileEntity(fileJson);
+                fileRecord.isFrozen = true;
+                bool isUpdated = fsm->updateFile(fileRecord);
                 if(isUpdated)
                     fsEventDb.deleteFile(item->getUserPath());
             }
             else if(action == TreeModelFileMonitor::TreeItem::Action::Restore)
             {
-                qlonglong maxVersionNumber = fileJson[JsonKeys::File::MaxVersionNumber].toInteger();
-                QJsonObject versionJson = fsm->getFileVersionJson(symbolFilePath, maxVersionNumber);
-                QString internalFileName = versionJson[JsonKeys::FileVersion::InternalFileName].toString();
-                QString internalFilePath = fsm->getStorageFolderPath() + internalFileName;
-                QString userFilePath = fileJson[JsonKeys::File::UserFilePath].toString();
+                FileVersionRecord versionRecord = fsm->getFileVersion(symbolFilePath, fileRecord.maxVersionNumber);
+                QString userFilePath = fileRecord.userFilePath;
 
                 QFile::remove(item->getUserPath()); // If restored file exist remove it
-                bool isCopied = QFile::copy(internalFilePath, userFilePath);
+                bool isCopied = fsm->copyVersionFile(versionRecord, userFilePath, IoScheduler::Budget::Foreground);
 
-                QFile file(userFilePath);
-                file.open(QFile::OpenModeFlag::Append);
-                QString strLastModifiedTimestamp = versionJson[JsonKeys::FileVersion::LastModifiedTimestamp].toString();
-                QDateTime lastModifiedTimestamp = QDateTime::fromString(strLastModifiedTimestamp, Qt::DateFormat::ISODateWithMs);
-                bool isTimestampSet = file.setFileTime(lastModifiedTimestamp, QFileDevice::FileTime::FileModificationTime);
+                bool isTimestampSet = FileStat::setModifiedTime(userFilePath, versionRecord.lastModifiedNsecs);
 
                 if(isCopied && isTimestampSet)
                     fsEventDb.setStatusOfFile(item->getUserPath(), FileSystemEventDb::ItemStatus::Monitored);
@@ -180,19 +171,16 @@ void TaskSaveChanges::saveFileChanges()
         else // If file info NOT exist in db
         {
             QString userPathToOldFile = item->getParentItem()->getUserPath() + fsEventDb.getOldNameOfFile(item->getUserPath());
-            fileJson = fsm->getFileJsonByUserPath(userPathToOldFile);
-            symbolFilePath = fileJson[JsonKeys::File::SymbolFilePath].toString();
+            fileRecord = fsm->getFileByUserPath(userPathToOldFile);
+            symbolFilePath = fileRecord.symbolFilePath;
 
             if(action == TreeModelFileMonitor::TreeItem::Action::Restore) // Restores FileSystemEventDb::ItemStatus::Renamed and UpdatedAndRenamed files
             {
-                qlonglong maxVersionNumber = fileJson[JsonKeys::File::MaxVersionNumber].toInteger();
-                QJsonObject versionJson = fsm->getFileVersionJson(symbolFilePath, maxVersionNumber);
-                QString internalFileName = versionJson[JsonKeys::FileVersion::InternalFileName].toString();
-                auto internalFilePath = fsm->getStorageFolderPath() + internalFileName;
-                QString userFilePath = fileJson[JsonKeys::File::UserFilePath].toString();
+                FileVersionRecord versionRecord = fsm->getFileVersion(symbolFilePath, fileRecord.maxVersionNumber);
+                QString userFilePath = fileRecord.userFilePath;
 
                 QFile::remove(item->getUserPath());
-                bool isCopied = QFile::copy(internalFilePath, userFilePath);
+                bool isCopied = fsm->copyVersionFile(versionRecord, userFilePath, IoScheduler::Budget::Foreground);
                 if(isCopied)
                     fsEventDb.setStatusOfFile(item->getUserPath(), FileSystemEventDb::ItemStatus::Monitored);
             }
@@ -200,16 +188,16 @@ void TaskSaveChanges::saveFileChanges()
             {
                 if(status == FileSystemEventDb::ItemStatus::NewAdded)
                 {
-                    QJsonObject folderJson = fsm->getFolderJsonByUserPath(item->getParentItem()->getUserPath());
-                    bool isAdded = fsm->addNewFile(folderJson[JsonKeys::Folder::SymbolFolderPath].toString(), item->getUserPath());
+                    FolderRecord folderRecord = fsm->getFolderByUserPath(item->getParentItem()->getUserPath());
+                    bool isAdded = fsm->addNewFile(folderRecord.symbolFolderPath, item->getUserPath());
                     if(isAdded)
                         fsEventDb.setStatusOfFile(item->getUserPath(), FileSystemEventDb::ItemStatus::Monitored);
                 }
                 else if(status == FileSystemEventDb::ItemStatus::Renamed)
                 {
                     // Rename file
-                    fileJson[JsonKeys::File::FileName] = fsEventDb.getNameOfFile(item->getUserPath());
-                    bool isUpdated = fsm->updateFileEntity(fileJson);
+                    fileRecord.fileName = fsEventDb.getNameOfFile(item->getUserPath());
+                    bool isUpdated = fsm->updateFile(fileRecord);
                     if(isUpdated)
                     {
                         fsEventDb.setOldNameOfFile(item->getUserPath(), "");
@@ -0,0 +1,202 @@
+#include "FileHasher.h"
+
+#include <atomic>
+
+#include <QtEndian>
+#include <QFileInfo>
+#include <QtConcurrent>
+
+bool FileHasher::isSupported(const QString &algorithm)
+{
+    return supportedAlgorithms().contains(algorithm);
+}
+
+QStringList FileHasher::supportedAlgorithms()
+{
+    return {AlgorithmSha3_256, AlgorithmBlake2b_256, AlgorithmBlake2bTree_256};
+}
+
+QString FileHasher::hashFile(const QString &pathToFile, const QString &algorithm)
+{
+    QString result = "";
+
+    if(algorithm == AlgorithmSha3_256)
+        result = hashSequential(pathToFile, QCryptographicHash::Algorithm::Sha3_256);
+    else if(algorithm == AlgorithmBlake2b_256)
+        result = hashSequential(pathToFile, QCryptographicHash::Algorithm::Blake2b_256);
+    else if(algorithm == AlgorithmBlake2bTree_256)
+        result = hashTree(pathToFile);
+
+    return result;
+}
+
+QString FileHasher::hashData(const QByteArray &data, const QString &algorithm)
+{
+    if(algorithm == AlgorithmSha3_256)
+        return QString(QCryptographicHash::hash(data, QCryptographicHash::Algorithm::Sha3_256).toHex());
+
+    if(algorithm == AlgorithmBlake2b_256)
+        return QString(QCryptographicHash::hash(data, QCryptographicHash::Algorithm::Blake2b_256).toHex());
+
+    if(algorithm != AlgorithmBlake2bTree_256)
+        return "";
+
+    // Root digest is built the same way as in hashTree(), empty data still has one (empty) chunk.
+    QCryptographicHash rootHasher(QCryptographicHash::Algorithm::Blake2b_256);
+
+    for(qint64 offset = 0; offset < data.size() || offset == 0; offset += TreeChunkSize)
+    {
+        QByteArrayView chunk = QByteArrayView(data).sliced(offset, qMin(TreeChunkSize, data.size() - offset));
+        rootHasher.addData(QCryptographicHash::hash(chunk, QCryptographicHash::Algorithm::Blake2b_256));
+    }
+
+    QByteArray sizeBytes(sizeof(quint64), Qt::Initialization::Uninitialized);
+    qToLittleEndian<quint64>(data.size(), sizeBytes.data());
+    rootHasher.addData(sizeBytes);
+
+    return QString(rootHasher.result().toHex());
+}
+
+QString FileHasher::hashDevice(QIODevice &device, const QString &algorithm, IoScheduler::Budget budget)
+{
+    bool isTree = (algorithm == AlgorithmBlake2bTree_256);
+    QCryptographicHash::Algorithm chunkAlgorithm = QCryptographicHash::Algorithm::Blake2b_256;
+
+    if(algorithm == AlgorithmSha3_256)
+        chunkAlgorithm = QCryptographicHash::Algorithm::Sha3_256;
+    else if(!isTree && algorithm != AlgorithmBlake2b_256)
+        return "";
+
+    // Tree chunks are hashed one after another here, root digest is built the same way as in hashTree().
+    QCryptographicHash chunkHasher(chunkAlgorithm);
+    QCryptographicHash rootHasher(QCryptographicHash::Algorithm::Blake2b_256);
+    qint64 chunkByteCount = 0;
+    qint64 totalByteCount = 0;
+
+    // Own buffer instead of ChunkBufferPool, long scrubs mustn't hold leases foreground copies wait for.
+    QByteArray buffer(DeviceReadChunkSize, Qt::Initialization::Uninitialized);
+
+    while(true)
+    {
+        qint64 readLimit = buffer.size();
+
+        if(isTree)
+            readLimit = qMin(readLimit, TreeChunkSize - chunkByteCount);
+
+        qint64 readCount = device.read(buffer.data(), readLimit);
+
+        if(readCount < 0)
+            return "";
+
+        if(readCount == 0)
+            break;
+
+        IoScheduler::instance()->acquire(budget, readCount);
+        chunkHasher.addData(QByteArrayView(buffer.constData(), readCount));
+        chunkByteCount += readCount;
+        totalByteCount += readCount;
+
+        if(isTree && chunkByteCount == TreeChunkSize)
+        {
+            rootHasher.addData(chunkHasher.result());
+            chunkHasher.reset();
+            chunkByteCount = 0;
+        }
+    }
+
+    if(!isTree)
+        return QString(chunkHasher.result().toHex());
+
+    // Last partial chunk, or the single empty chunk of an empty file.
+    if(chunkByteCount > 0 || totalByteCount == 0)
+        rootHasher.addData(chunkHasher.result());
+
+    QByteArray sizeBytes(sizeof(quint64), Qt::Initialization::Uninitialized);
+    qToLittleEndian<quint64>(totalByteCount, sizeBytes.data());
+    rootHasher.addData(sizeBytes);
+
+    return QString(rootHasher.result().toHex());
+}
+
+QString FileHasher::hashSequential(const QString &pathToFile, QCryptographicHash::Algorithm algorithm)
+{
+    QFile file(pathToFile);
+    bool isOpen = file.open(QFile::OpenModeFlag::ReadOnly);
+
+    if(!isOpen)
+        return "";
+
+    QCryptographicHash hasher(algorithm);
+    bool isAdded = hasher.addData(&file);
+
+    if(!isAdded)
+        return "";
+
+    return QString(hasher.result().toHex());
+}
+
+// Every chunk is hashed independently on the global thread pool, then the root digest is
+// calculated from the ordered chunk digests followed by the file size (little endian).
+QString FileHasher::hashTree(const QString &pathToFile)
+{
+    QFileInfo info(pathToFile);
+
+    if(!info.isFile() || !info.isReadable())
+        return "";
+
+    qint64 fileSize = info.size();
+    QList<qint64> offsetList;
+
+    for(qint64 offset = 0; offset < fileSize; offset += TreeChunkSize)
+        offsetList.append(offset);
+
+    if(offsetList.isEmpty()) // Empty files still have one (empty) chunk.
+        offsetList.append(0);
+
+    std::atomic_bool isAllChunksRead(true);
+
+    auto mapper = [pathToFile, &isAllChunksRead](qint64 offset) {
+        bool isOk = false;
+        QByteArray digest = hashChunk(pathToFile, offset, &isOk);
+
+        if(!isOk)
+            isAllChunksRead = false;
+
+        return digest;
+    };
+
+    QList<QByteArray> chunkDigestList = QtConcurrent::blockingMapped<QList<QByteArray>>(offsetList, mapper);
+
+    if(!isAllChunksRead)
+        return "";
+
+    QCryptographicHash rootHasher(QCryptographicHash::Algorithm::Blake2b_256);
+
+    for(const QByteArray &digest : chunkDigestList)
+        rootHasher.addData(digest);
+
+    QByteArray sizeBytes(sizeof(quint64), Qt::Initialization::Uninitialized);
+    qToLittleEndian<quint64>(fileSize, sizeBytes.data());
+    rootHasher.addData(sizeBytes);
+
+    return QString(rootHasher.result().toHex());
+}
+
+QByteArray FileHasher::hashChunk(const QString &pathToFile, qint64 offset, bool *isOk)
+{
+    *isOk = false;
+
+    QFile file(pathToFile);
+    bool isOpen = file.open(QFile::OpenModeFlag::ReadOnly);
+
+    if(!isOpen || !file.seek(offset))
+        return {};
+
+    QByteArray chunk = file.read(TreeChunkSize);
+
+    if(file.error() != QFileDevice::FileError::NoError)
+        return {};
+
+    *isOk = true;
+    return QCryptographicHash::hash(chunk, QCryptographicHash::Algorithm::Blake2b_256);
+}
@@ -0,0 +1,42 @@
+#ifndef FILEHASHER_H
+#define FILEHASHER_H
+
+#include "Utility/IoScheduler.h"
+
+#include <QFile>
+#include <QString>
+#include <QIODevice>
+#include <QCryptographicHash>
+
+class FileHasher
+{
+public:
+    static const inline QString AlgorithmSha3_256 = "sha3_256";
+    static const inline QString AlgorithmBlake2b_256 = "blake2b_256";
+    static const inline QString AlgorithmBlake2bTree_256 = "blake2b_tree_256";
+    static const inline QString DefaultAlgorithm = AlgorithmSha3_256;
+
+    // Files are split into chunks of this size when hashing with AlgorithmBlake2bTree_256.
+    static const inline qint64 TreeChunkSize = 8 * 1024 * 1024;
+
+    static bool isSupported(const QString &algorithm);
+    static QStringList supportedAlgorithms();
+
+    // Returns hex encoded digest, or empty string when file can't be read or algorithm is not supported.
+    static QString hashFile(const QString &pathToFile, const QString &algorithm = DefaultAlgorithm);
+
+    // Same digests with hashFile(), for content which is already in memory.
+    static QString hashData(const QByteArray &data, const QString &algorithm = DefaultAlgorithm);
+
+    // Same digests with hashFile(), read sequentially from current position to the end. Read bytes are charged to budget.
+    static QString hashDevice(QIODevice &device, const QString &algorithm, IoScheduler::Budget budget);
+
+    static const inline qint64 DeviceReadChunkSize = 1048576; // 1 MiB
+
+private:
+    static QString hashSequential(const QString &pathToFile, QCryptographicHash::Algorithm algorithm);
+    static QString hashTree(const QString &pathToFile);
+    static QByteArray hashChunk(const QString &pathToFile, qint64 offset, bool *isOk);
+};
+
+#endif // FILEHASHER_H
@@ -4,7 +4,14 @@
 #include "ORM/Repository/FolderRepository.h"
 #include "ORM/Repository/FileRepository.h"
 #include "ORM/Repository/FileVersionRepository.h"
+#include "FolderListingPage.h"
+#include "StorageRecords.h"
+#include "PackStore.h"
 
+#include "Utility/FileStat.h"
+#include "Utility/IoScheduler.h"
+
+#include <QIODevice>
 #include <QJsonObject>
 
 class FileStorageManager
@@ -36,12 +43,28 @@ public:
     bool deleteFile(const QString &symbolFilePath);
     bool deleteFileVersion(const QString &symbolFilePath, qlonglong versionNumber);
 
+    bool updateFolder(const FolderRecord &record, bool updateFrozenStatusOfChildren = false);
+    bool updateFile(const FileRecord &record);
+
     bool updateFolderEntity(QJsonObject folderDto, bool updateFrozenStatusOfChildren = false);
     bool updateFileEntity(QJsonObject fileDto);
     bool updateFileVersionEntity(QJsonObject versionDto);
 
     bool sortFileVersionsInIncreasingOrder(const QString &symbolFilePath);
 
+    FolderRecord getFolderBySymbolPath(const QString &symbolFolderPath, bool includeChildren = false) const;
+    FolderRecord getFolderByUserPath(const QString &userFolderPath, bool includeChildren = false) const;
+    FileRecord getFileBySymbolPath(const QString &symbolFilePath, bool includeVersions = false) const;
+    FileRecord getFileByUserPath(const QString &userFilePath, bool includeVersions = false) const;
+    FileVersionRecord getFileVersion(const QString &symbolFilePath, qlonglong versionNumber) const;
+    bool isFileUnchanged(const QString &symbolFilePath, const FileStat &stat) const;
+    QList<FolderRecord> getActiveFolders() const;
+    QList<FileRecord> getActiveFiles() const;
+
+    // Latest version of each active file by user file path, without a query per file.
+    QHash<QString, FileVersionRecord> getLatestVersionsOfActiveFiles() const;
+
+    // Json variants are meant for callers outside of the process.
     QJsonObject getFolderJsonBySymbolPath(const QString &symbolFolderPath, bool includeChildren = false) const;
     QJsonObject getFolderJsonByUserPath(const QString &userFolderPath, bool includeChildren = false) const;
     QJsonObject getFileJsonBySymbolPath(const QString &symbolFilePath, bool includeVersions = false) const;
@@ -50,18 +73,65 @@ public:
     QJsonArray getActiveFolderList() const;
     QJsonArray getActiveFileList() const;
 
+    // Child folders and files of a folder, at most pageSize items per call without N+1 queries.
+    FolderListingPage getFolderListingPage(const QString &symbolFolderPath,
+                                           FolderListingPage::SortKey sortKey,
+                                           Qt::SortOrder order,
+                                           int pageSize,
+                                           const FolderListingItem &afterItem = FolderListingItem()) const;
+
     QString getStorageFolderPath() const;
     void setStorageFolderPath(const QString &newStorageFolderPath);
 
+    // Absolute path of a version file, wherever StorageLayout placed it. Packed and inline versions have no file of their own.
+    QString getInternalFilePath(const QString &internalFileName) const;
+
+    // Content of a version, whether it is stored as its own file, inside a pack or in the database.
+    bool copyVersionFile(const FileVersionRecord &record, const QString &destinationFilePath, IoScheduler::Budget budget) const;
+    QSharedPointer<QIODevice> openVersionFile(const FileVersionRecord &record) const; // Callers charge what they read
+
+    // Packs other than the active one whose live versions fill less than RepackLiveRatio of the file.
+    QStringList getPackFilesToRepack() const;
+
+    // Moves live versions of the pack into the active pack and retires the pack, see PackStore::retire().
+    bool repackPackFile(const QString &packFileName);
+
+    // Sorted internal file names of versions stored as their own file, whose names start with prefix.
+    QStringList getStoredFileNamesWithPrefix(const QString &prefix) const;
+
+    // Never verified versions first, then the ones verified longest ago.
+    QList<FileVersionRecord> getVersionsToVerify(qint64 verifiedBeforeMsecs, int count) const;
+    qlonglong countVersionsToVerify(qint64 verifiedBeforeMsecs) const;
+    qlonglong countCorruptVersions() const;
+
+    // Re-hashes stored content and records the result. Returns false when content is missing or doesn't match its hash.
+    bool verifyVersion(const FileVersionRecord &record, IoScheduler::Budget budget);
+
+    static const inline double RepackLiveRatio = 0.5;
+    static const inline qint64 RepackMinAgeSecs = 600;
+
+    QString getHashAlgorithm() const;
+    void setHashAlgorithm(const QString &newHashAlgorithm);
+
+    qint64 getInlineFileSizeLimit() const;
+    void setInlineFileSizeLimit(qint64 newInlineFileSizeLimit);
+
+    static QJsonObject toJson(const FolderRecord &record);
+    static QJsonObject toJson(const FileRecord &record);
+    static QJsonObject toJson(const FileVersionRecord &record);
+
 private:
     QString generateRandomFileName();
-    QJsonObject folderEntityToJsonObject(const FolderEntity &entity) const;
-    QJsonObject fileEntityToJsonObject(const FileEntity &entity) const;
-    QJsonObject fileVersionEntityToJsonObject(const FileVersionEntity &entity) const;
-    bool sortFileVersionEntities(const FileEntity &parentEntity);
+    static bool isSameStat(const FileStat &first, const FileStat &second);
+    FolderRecord folderRecordFrom(const FolderEntity &entity) const;
+    FileRecord fileRecordFrom(const FileEntity &entity, const QString &parentUserFolderPath) const;
+    FileVersionRecord fileVersionRecordFrom(const FileVersionEntity &entity) const;
+    bool readStoredContent(const FileVersionRecord &record, QByteArray &data) const;
 
 private:
     QString storageFolderPath;
+    QString hashAlgorithm;
+    qint64 inlineFileSizeLimit;
     QSqlDatabase database;
     FolderRepository *folderRepository;
     FileRepository *fileRepository;
@@ -0,0 +1,188 @@
+#include "IntegrityScrubJob.h"
+
+#include "FileStorageManager.h"
+#include "Utility/Logger.h"
+#include "Utility/AppConfig.h"
+#include "Utility/IoScheduler.h"
+#include "Utility/JobScheduler.h"
+
+#include <atomic>
+
+#include <QSet>
+#include <QDateTime>
+#include <QThreadPool>
+#include <QtConcurrent>
+
+QMutex IntegrityScrubJob::statusMutex;
+IntegrityScrubJob::Status IntegrityScrubJob::status;
+
+IntegrityScrubJob::IntegrityScrubJob()
+    : BackgroundJob(BackgroundJob::Priority::Low, BackgroundJob::PoolType::Io)
+{
+
+}
+
+IntegrityScrubJob::~IntegrityScrubJob()
+{
+    // Only needed when job is cancelled before it starts, run() clears status otherwise.
+    QMutexLocker locker(&statusMutex);
+
+    if(status.jobId == getJobId())
+    {
+        status.jobId = -1;
+        status.isRunning = false;
+    }
+}
+
+QString IntegrityScrubJob::checkpointKey() const
+{
+    return "integrity_scrub";
+}
+
+qint64 IntegrityScrubJob::submitIfIdle()
+{
+    return submitJob(QSharedPointer<IntegrityScrubJob>::create());
+}
+
+qint64 IntegrityScrubJob::submitIfDue()
+{
+    auto job = QSharedPointer<IntegrityScrubJob>::create();
+
+    bool isInterrupted = !job->loadCheckpoint().isEmpty();
+    bool isDue = isInterrupted || !FileStorageManager::instance()->getVersionsToVerify(newPassCutoffMsecs(), 1).isEmpty();
+
+    if(!isDue)
+        return -1;
+
+    return submitJob(job);
+}
+
+qint64 IntegrityScrubJob::newPassCutoffMsecs()
+{
+    return QDateTime::currentMSecsSinceEpoch() - AppConfig().getScrubIntervalDays() * MsecsPerDay;
+}
+
+qint64 IntegrityScrubJob::submitJob(QSharedPointer<IntegrityScrubJob> job)
+{
+    QMutexLocker locker(&statusMutex);
+
+    if(status.jobId >= 0)
+        return status.jobId;
+
+    status.jobId = JobScheduler::instance()->submit(job);
+
+    return status.jobId;
+}
+
+IntegrityScrubJob::Status IntegrityScrubJob::getStatus()
+{
+    QMutexLocker locker(&statusMutex);
+    return status;
+}
+
+bool IntegrityScrubJob::run()
+{
+    auto fsm = FileStorageManager::instance();
+
+    // Versions verified after cutoff are done for this pass.
+    QByteArray checkpoint = loadCheckpoint();
+    qint64 cutoffMsecs = newPassCutoffMsecs();
+
+    if(!checkpoint.isEmpty())
+        cutoffMsecs = checkpoint.toLongLong();
+
+    saveCheckpoint(QByteArray::number(cutoffMsecs));
+
+    qint64 totalCount = fsm->countVersionsToVerify(cutoffMsecs);
+    std::atomic<qint64> checkedCount = 0;
+    std::atomic<qint64> corruptCount = 0;
+
+    {
+        QMutexLocker locker(&statusMutex);
+        status.isRunning = true;
+        status.checkedCount = 0;
+        status.totalCount = totalCount;
+        status.corruptCount = 0;
+    }
+
+    LOG_INFO("IntegrityScrubJob", QString("%1 versions to verify").arg(totalCount));
+
+    QThreadPool scrubPool;
+    scrubPool.setMaxThreadCount(ScrubThreadCount);
+
+    QSet<QString> previousBatchNames;
+    bool result = true;
+
+    while(!isCancelRequested())
+    {
+        QList<FileVersionRecord> batch = fsm->getVersionsToVerify(cutoffMsecs, BatchSize);
+
+        if(batch.isEmpty())
+            break;
+
+        // Results which can't be saved would bring the same batch back forever.
+        QSet<QString> batchNames;
+        for(const FileVersionRecord &record : batch)
+            batchNames.insert(record.internalFileName);
+
+        if(batchNames == previousBatchNames)
+        {
+            LOG_WARNING("IntegrityScrubJob", "couldn't save verification results");
+            result = false;
+            break;
+        }
+
+        previousBatchNames = batchNames;
+
+        // Every slice gets its own connection, records are dealt out so large files spread over threads.
+        QList<QList<FileVersionRecord>> sliceList(ScrubThreadCount);
+        for(qsizetype index = 0; index < batch.size(); index++)
+            sliceList[index % ScrubThreadCount].append(batch.at(index));
+
+        QtConcurrent::blockingMap(&scrubPool, sliceList, [this, &checkedCount, &corruptCount](const QList<FileVersionRecord> &slice) {
+            IoScheduler::BackgroundScope backgroundScope;
+            auto sliceFsm = FileStorageManager::instance();
+
+            for(const FileVersionRecord &record : slice)
+            {
+                if(isCancelRequested())
+                    return;
+
+                if(!sliceFsm->verifyVersion(record, IoScheduler::Budget::Background))
+                {
+                    LOG_WARNING("IntegrityScrubJob", QString("version %1 of %2 is corrupt").arg(record.versionNumber)
+                                                                                             .arg(record.symbolFilePath));
+                    ++corruptCount;
+                }
+
+                ++checkedCount;
+            }
+        });
+
+        // Versions added during the pass are never verified, so they are picked up too.
+        totalCount = qMax(totalCount, checkedCount.load());
+        setProgress(checkedCount, totalCount);
+
+        QMutexLocker locker(&statusMutex);
+        status.checkedCount = checkedCount;
+        status.totalCount = totalCount;
+        status.corruptCount = corruptCount;
+    }
+
+    if(isCancelRequested())
+        result = false;
+
+    {
+        QMutexLocker locker(&statusMutex);
+        status.jobId = -1;
+        status.isRunning = false;
+
+        if(result)
+            status.lastFinishedMsecs = QDateTime::currentMSecsSinceEpoch();
+    }
+
+    LOG_INFO("IntegrityScrubJob", QString("%1 versions verified, %2 corrupt").arg(checkedCount.load())
+                                                                              .arg(corruptCount.load()));
+
+    return result;
+}
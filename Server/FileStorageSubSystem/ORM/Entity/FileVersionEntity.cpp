@@ -8,8 +8,16 @@ FileVersionEntity::FileVersionEntity()
     versionNumber = 0;
     internalFileName = "";
     size = 0;
+    lastModifiedNsecs = 0;
+    inode = 0;
+    packFileName = "";
+    packOffset = -1;
+    isInline = false;
     description = "";
     hash = "";
+    hashAlgorithm = "";
+    lastVerifiedMsecs = 0;
+    isCorrupt = false;
 }
 
 bool FileVersionEntity::isExist() const
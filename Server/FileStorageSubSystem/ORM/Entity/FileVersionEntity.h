@@ -2,7 +2,7 @@
 #define FILEVERSIONENTITY_H
 
 #include <QString>
-#include <QDateTime>
+#include <QByteArray>
 
 class FileVersionEntity
 {
@@ -16,9 +16,17 @@ public:
     qlonglong versionNumber;
     QString internalFileName;
     qlonglong size;
-    QDateTime lastModifiedTimestamp;
+    qint64 lastModifiedNsecs; // Since epoch
+    quint64 inode;
+    QString packFileName; // Empty when version is stored as its own file
+    qint64 packOffset;
+    bool isInline; // Content is in FileVersionContent table
+    QByteArray inlineContent; // Only used when saving a new inline version
     QString description;
     QString hash;
+    QString hashAlgorithm;
+    qint64 lastVerifiedMsecs; // Since epoch, 0 when never verified
+    bool isCorrupt; // Content didn't match hash at last verification
 
     bool isExist() const;
 
@@ -2,6 +2,7 @@
 #define FILEREPOSITORY_H
 
 #include "Entity/FileEntity.h"
+#include "FolderListingPage.h"
 
 #include <QSqlError>
 #include <QSqlDatabase>
@@ -15,6 +16,11 @@ public:
     FileEntity findBySymbolPath(const QString &symbolFilePath, bool includeVersions = false) const;
     QList<FileEntity> findActiveFiles() const;
     QList<FileEntity> findAllChildFiles(const QString &symbolFolderPath) const;
+    QList<FolderListingItem> findChildFilePage(const QString &symbolFolderPath,
+                                               FolderListingPage::SortKey sortKey,
+                                               Qt::SortOrder order,
+                                               const FolderListingItem &afterItem,
+                                               int limit) const;
     bool save(FileEntity &entity, QSqlError *error = nullptr);
     bool deleteEntity(FileEntity &entity, QSqlError *error = nullptr);
 
@@ -3,7 +3,9 @@
 
 #include "Entity/FileVersionEntity.h"
 
+#include <QHash>
 #include <QSqlError>
+#include <QSqlRecord>
 #include <QSqlDatabase>
 
 class FileVersionRepository
@@ -13,12 +15,52 @@ public:
     ~FileVersionRepository();
 
     FileVersionEntity findVersion(const QString &symbolFilePath, qlonglong versionNumber) const;
+    FileVersionEntity findByInternalFileName(const QString &internalFileName) const;
     QList<FileVersionEntity> findAllVersions(const QString &symbolFilePath) const;
     qlonglong maxVersionNumber(const QString &symbolFilePath) const;
+    bool isLatestVersionMatching(const QString &symbolFilePath, qlonglong size, qint64 modifiedNsecs) const;
+    // Latest version of every file, in one query.
+    QList<FileVersionEntity> findLatestVersions() const;
+    // Inline content is inserted with its row, run it in a write command so both are rolled back together.
     bool save(FileVersionEntity &entity, QSqlError *error = nullptr);
     bool deleteEntity(FileVersionEntity &entity, QSqlError *error = nullptr);
 
+    // Closes gaps in version numbers starting from fromVersionNumber, keeping their order.
+    // Runs as two statements and relies on the savepoint of the caller's write command, a failure between them leaves numbers shifted.
+    bool renumberVersions(const QString &symbolFilePath, qlonglong fromVersionNumber = 1);
+
+    // Total size of versions still referencing each pack file.
+    QHash<QString, qint64> packLiveSizes() const;
+    QList<FileVersionEntity> findAllInPack(const QString &packFileName) const;
+
+    // Empty when version isn't inline.
+    QByteArray findInlineContent(const QString &internalFileName) const;
+
+    // Sorted names of versions stored as their own file, one index range scan per call.
+    QStringList findFileNamesWithPrefix(const QString &prefix) const;
+
+    // Names of versions stored as their own file, of all files in the folder and its sub folders.
+    QStringList findFileNamesUnderFolder(const QString &symbolFolderPath) const;
+
+    // Never verified versions come first, then the ones verified longest ago.
+    QList<FileVersionEntity> findLeastRecentlyVerified(qint64 verifiedBeforeMsecs, int count) const;
+    qlonglong countVerifiedBefore(qint64 verifiedBeforeMsecs) const;
+    qlonglong countCorrupt() const;
+    bool updateVerifyResult(const QString &internalFileName, qint64 verifiedMsecs, bool isCorrupt);
+
+    // Moves a packed version only if it is still in oldPackFileName, so concurrent changes aren't overwritten.
+    bool updatePackLocation(const QString &internalFileName,
+                            const QString &oldPackFileName,
+                            const QString &newPackFileName,
+                            qint64 newPackOffset);
+
 private:
+    static FileVersionEntity entityFrom(const QSqlRecord &record);
+
+    // Smallest string greater than every string starting with prefix, so prefix searches use indexes instead of LIKE.
+    static QString prefixUpperBound(const QString &prefix);
+    bool saveInlineContent(const FileVersionEntity &entity);
+
     QSqlDatabase database;
 };
 
@@ -134,10 +134,58 @@ QList<FolderEntity> FolderRepository::findActiveFolders() const
     return result;
 }
 
+// Keyset pagination over (parent_folder_path, suffix_path) primary key, no row is skipped by OFFSET.
+QList<FolderListingItem> FolderRepository::findChildFolderPage(const QString &symbolFolderPath,
+                                                               Qt::SortOrder order,
+                                                               const QString &afterSuffixPath,
+                                                               int limit) const
+{
+    QList<FolderListingItem> result;
+
+    bool isAscending = (order == Qt::SortOrder::AscendingOrder);
+
+    QSqlQuery query(database);
+    QString queryTemplate = " SELECT symbol_folder_path, suffix_path, user_folder_path, is_frozen"
+                            " FROM FolderEntity WHERE parent_folder_path = :1";
+
+    if(!afterSuffixPath.isEmpty())
+        queryTemplate += isAscending ? " AND suffix_path > :2" : " AND suffix_path < :2";
+
+    queryTemplate += isAscending ? " ORDER BY suffix_path ASC" : " ORDER BY suffix_path DESC";
+    queryTemplate += " LIMIT :3;";
+
+    query.setForwardOnly(true);
+    query.prepare(queryTemplate);
+    query.bindValue(":1", symbolFolderPath);
+
+    if(!afterSuffixPath.isEmpty())
+        query.bindValue(":2", afterSuffixPath);
+
+    query.bindValue(":3", limit);
+    query.exec();
+
+    while(query.next())
+    {
+        FolderListingItem item;
+
+        item.isFolder = true;
+        item.name = query.value(1).toString().chopped(1); // Remove / character at end
+        item.symbolPath = query.value(0).toString();
+        item.isFrozen = query.value(3).toBool();
+
+        if(!item.isFrozen)
+            item.userPath = query.value(2).toString();
+
+        result.append(item);
+    }
+
+    return result;
+}
+
 bool FolderRepository::save(FolderEntity &entity, QSqlError *error)
 {
     bool result = false;
-    bool isExist = findBySymbolPath(entity.getPrimaryKey()).isExist();
+    bool isExist = entity.isExist(); // Loaded entities may be renamed, so they are updated by their old key
     QSqlQuery query(database);
     QString queryTemplate;
 
@@ -150,7 +198,10 @@ bool FolderRepository::save(FolderEntity &entity, QSqlError *error)
     else
     {
         queryTemplate = " INSERT INTO FolderEntity (parent_folder_path, suffix_path, user_folder_path, is_frozen)"
-                        " VALUES(:1, :2, :3, :4);" ;
+                        " VALUES(:1, :2, :3, :4)"
+                        " ON CONFLICT (parent_folder_path, suffix_path) DO UPDATE"
+                        " SET user_folder_path = excluded.user_folder_path, is_frozen = excluded.is_frozen"
+                        " RETURNING symbol_folder_path;" ;
     }
 
     query.prepare(queryTemplate);
@@ -179,7 +230,16 @@ bool FolderRepository::save(FolderEntity &entity, QSqlError *error)
 
     if(query.lastError().type() == QSqlError::ErrorType::NoError)
     {
-        result = true;
+        if(!isExist && query.next()) // Inserted or updated row is returned
+            result = true;
+        else if(isExist && query.numRowsAffected() == 1) // Row deleted meanwhile isn't brought back
+            result = true;
+    }
+
+    query.finish(); // Statement with RETURNING stays open otherwise and blocks the commit
+
+    if(result)
+    {
         entity.setIsExist(true);
         entity.setPrimaryKey(entity.symbolFolderPath());
     }
@@ -187,6 +247,56 @@ bool FolderRepository::save(FolderEntity &entity, QSqlError *error)
     return result;
 }
 
+bool FolderRepository::saveAll(const QList<FolderEntity> &entityList, QSqlError *error)
+{
+    bool result = false;
+
+    if(entityList.isEmpty())
+        return true;
+
+    QStringList rowList;
+    for(qsizetype index = 0; index < entityList.size(); index++)
+        rowList.append(QString("(:p%1, :s%1, :u%1, :f%1)").arg(index));
+
+    QSqlQuery query(database);
+    QString queryTemplate = " INSERT INTO FolderEntity (parent_folder_path, suffix_path, user_folder_path, is_frozen)"
+                            " VALUES %1"
+                            " ON CONFLICT (parent_folder_path, suffix_path) DO UPDATE"
+                            " SET user_folder_path = excluded.user_folder_path, is_frozen = excluded.is_frozen"
+                            " WHERE excluded.user_folder_path IS NOT NULL;" ; // Only the folder given a user path, not its parents
+
+    query.prepare(queryTemplate.arg(rowList.join(", ")));
+
+    for(qsizetype index = 0; index < entityList.size(); index++)
+    {
+        const FolderEntity &entity = entityList.at(index);
+
+        if(entity.parentFolderPath.isEmpty())
+            query.bindValue(QString(":p%1").arg(index), QVariant());
+        else
+            query.bindValue(QString(":p%1").arg(index), entity.parentFolderPath);
+
+        query.bindValue(QString(":s%1").arg(index), entity.suffixPath);
+
+        if(entity.userFolderPath.isEmpty())
+            query.bindValue(QString(":u%1").arg(index), QVariant());
+        else
+            query.bindValue(QString(":u%1").arg(index), entity.userFolderPath);
+
+        query.bindValue(QString(":f%1").arg(index), entity.isFrozen);
+    }
+
+    query.exec();
+
+    if(error != nullptr)
+        error = new QSqlError(query.lastError());
+
+    if(query.lastError().type() == QSqlError::ErrorType::NoError)
+        result = true;
+
+    return result;
+}
+
 bool FolderRepository::deleteEntity(FolderEntity &entity, QSqlError *error)
 {
     bool result = false;
@@ -2,6 +2,7 @@
 #define FOLDERREPOSITORY_H
 
 #include "Entity/FolderEntity.h"
+#include "FolderListingPage.h"
 
 #include <QSqlError>
 #include <QSqlDatabase>
@@ -15,7 +16,14 @@ public:
     FolderEntity findBySymbolPath(const QString &symbolFolderPath, bool includeChildren = false) const;
     QString findSymbolPathByUserFolderPath(const QString &userFolderPath) const;
     QList<FolderEntity> findActiveFolders() const;
+    QList<FolderListingItem> findChildFolderPage(const QString &symbolFolderPath,
+                                                 Qt::SortOrder order,
+                                                 const QString &afterSuffixPath,
+                                                 int limit) const;
     bool save(FolderEntity &entity, QSqlError *error = nullptr);
+
+    // Upserts all folders with one statement, existing parents keep their user path and state. Parents must come first.
+    bool saveAll(const QList<FolderEntity> &entityList, QSqlError *error = nullptr);
     bool deleteEntity(FolderEntity &entity, QSqlError *error = nullptr);
     bool setIsFrozenOfChildren(const QString &symbolFolderPath, bool isFrozen, QSqlError *error = nullptr);
 
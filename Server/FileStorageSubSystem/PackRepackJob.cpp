@@ -0,0 +1,62 @@
+#include "PackRepackJob.h"
+
+#include "FileStorageManager.h"
+#include "Utility/Logger.h"
+#include "Utility/JobScheduler.h"
+
+#include <QSharedPointer>
+
+QMutex PackRepackJob::activeJobMutex;
+qint64 PackRepackJob::activeJobId = -1;
+
+PackRepackJob::PackRepackJob()
+    : BackgroundJob(BackgroundJob::Priority::Low, BackgroundJob::PoolType::Io)
+{
+
+}
+
+PackRepackJob::~PackRepackJob()
+{
+    QMutexLocker locker(&activeJobMutex);
+
+    if(activeJobId == getJobId())
+        activeJobId = -1;
+}
+
+qint64 PackRepackJob::submitIfIdle()
+{
+    QMutexLocker locker(&activeJobMutex);
+
+    if(activeJobId < 0)
+        activeJobId = JobScheduler::instance()->submit(QSharedPointer<PackRepackJob>::create());
+
+    return activeJobId;
+}
+
+bool PackRepackJob::run()
+{
+    auto fsm = FileStorageManager::instance();
+    bool result = PackStore(fsm->getStorageFolderPath()).removeExpiredPacks();
+
+    if(!result)
+        LOG_WARNING("PackRepackJob", "couldn't delete some retired packs, will retry on next run");
+
+    QStringList packList = fsm->getPackFilesToRepack();
+
+    // No checkpoint needed, repacked files aren't listed again.
+    for(qsizetype index = 0; index < packList.size(); index++)
+    {
+        if(isCancelRequested())
+            return false;
+
+        if(!fsm->repackPackFile(packList.at(index)))
+        {
+            LOG_WARNING("PackRepackJob", "couldn't repack " + packList.at(index));
+            result = false;
+        }
+
+        setProgress(index + 1, packList.size());
+    }
+
+    return result;
+}
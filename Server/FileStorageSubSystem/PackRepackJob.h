@@ -0,0 +1,30 @@
+#ifndef PACKREPACKJOB_H
+#define PACKREPACKJOB_H
+
+#include "Utility/BackgroundJob.h"
+
+#include <QMutex>
+
+// Reclaims space of deleted versions by rewriting mostly empty pack files.
+// Packs retired by an earlier run are deleted once their grace period passed.
+class PackRepackJob : public BackgroundJob
+{
+public:
+    // Server runs for long, it repacks at this interval instead of only at startup.
+    static const inline int RepackIntervalMsecs = 3600000;
+
+    PackRepackJob();
+    ~PackRepackJob();
+
+    // Returns id of the queued or already running repack.
+    static qint64 submitIfIdle();
+
+protected:
+    bool run() override;
+
+private:
+    static QMutex activeJobMutex;
+    static qint64 activeJobId; // -1 when no repack is queued or running
+};
+
+#endif // PACKREPACKJOB_H
@@ -0,0 +1,112 @@
+#include "PackStore.h"
+
+#include <QDir>
+#include <QFile>
+#include <QUuid>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QMutexLocker>
+
+QMutex PackStore::appendMutex;
+QString PackStore::activePack;
+
+PackStore::PackStore(const QString &storageFolderPath)
+{
+    packFolderPath = storageFolderPath + PackFolderName + QDir::separator();
+}
+
+bool PackStore::append(const QByteArray &data, QString &packFileName, qint64 &offset, IoScheduler::Budget budget)
+{
+    // Throttled before locking, a background append waiting for its budget mustn't hold up foreground ones.
+    IoScheduler::instance()->acquire(budget, data.size());
+
+    QMutexLocker locker(&appendMutex);
+
+    QDir().mkpath(packFolderPath);
+
+    // Packs of previous runs aren't appended to, they are left to the repacker.
+    if(activePack.isEmpty() || QFileInfo(getPackFilePath(activePack)).size() + data.size() > MaxPackSize)
+        activePack = "pack_" + QUuid::createUuid().toString(QUuid::StringFormat::Id128) + PackFileSuffix;
+
+    QFile packFile(getPackFilePath(activePack));
+
+    if(!packFile.open(QFile::OpenModeFlag::WriteOnly | QFile::OpenModeFlag::Append))
+        return false;
+
+    qint64 position = packFile.size();
+    bool result = (packFile.write(data) == data.size()) && packFile.flush();
+
+    if(!result)
+    {
+        packFile.resize(position); // Don't leave a partial entry behind
+        return false;
+    }
+
+    packFileName = activePack;
+    offset = position;
+
+    return true;
+}
+
+bool PackStore::read(const QString &packFileName, qint64 offset, qint64 size, QByteArray &data) const
+{
+    QFile packFile(getPackFilePath(packFileName));
+
+    if(!packFile.open(QFile::OpenModeFlag::ReadOnly) || !packFile.seek(offset))
+        return false;
+
+    data = packFile.read(size);
+
+    return data.size() == size;
+}
+
+QString PackStore::getPackFilePath(const QString &packFileName) const
+{
+    return packFolderPath + packFileName;
+}
+
+QStringList PackStore::listPackFileNames() const
+{
+    return QDir(packFolderPath).entryList({"*" + PackFileSuffix}, QDir::Filter::Files);
+}
+
+bool PackStore::retire(const QString &packFileName)
+{
+    QFile marker(getPackFilePath(packFileName) + RetiredMarkerSuffix);
+    return marker.open(QFile::OpenModeFlag::WriteOnly);
+}
+
+bool PackStore::isRetired(const QString &packFileName) const
+{
+    return QFile::exists(getPackFilePath(packFileName) + RetiredMarkerSuffix);
+}
+
+bool PackStore::removeExpiredPacks()
+{
+    bool result = true;
+
+    QDir packFolder(packFolderPath);
+    QDateTime expiry = QDateTime::currentDateTimeUtc().addSecs(-RetiredPackGraceSecs);
+
+    for(const QFileInfo &markerInfo : packFolder.entryInfoList({"*" + PackFileSuffix + RetiredMarkerSuffix}, QDir::Filter::Files))
+    {
+        if(markerInfo.lastModified().toUTC() >= expiry)
+            continue;
+
+        QString packFilePath = markerInfo.filePath().chopped(RetiredMarkerSuffix.size());
+
+        // Marker goes last, so an interrupted removal is retried on next run.
+        bool isRemoved = (!QFile::exists(packFilePath) || QFile::remove(packFilePath)) && QFile::remove(markerInfo.filePath());
+
+        if(!isRemoved)
+            result = false;
+    }
+
+    return result;
+}
+
+QString PackStore::activePackFileName()
+{
+    QMutexLocker locker(&appendMutex);
+    return activePack;
+}
@@ -0,0 +1,53 @@
+#ifndef PACKSTORE_H
+#define PACKSTORE_H
+
+#include "Utility/IoScheduler.h"
+
+#include <QMutex>
+#include <QString>
+#include <QByteArray>
+#include <QStringList>
+
+// Small versions are appended back to back into shared pack files instead of getting a file each.
+// Location of a version inside its pack is kept in FileVersionEntity, pack files have no index of their own.
+class PackStore
+{
+public:
+    static const inline QString PackFolderName = "packs";
+    static const inline QString PackFileSuffix = ".pack";
+    static const inline qint64 MaxPackedFileSize = 65536; // 64 KiB, larger versions are stored as their own file
+    static const inline qint64 MaxPackSize = 268435456; // 256 MiB, a new pack is started after
+    static const inline QString RetiredMarkerSuffix = ".retired";
+
+    // Clients read byte ranges of packs directly, so a repacked pack is kept this long after its versions moved out.
+    static const inline qint64 RetiredPackGraceSecs = 3600;
+
+    PackStore(const QString &storageFolderPath);
+
+    // Appends data to the active pack and returns where it is written. Budget is charged before the pack is locked.
+    bool append(const QByteArray &data, QString &packFileName, qint64 &offset, IoScheduler::Budget budget);
+
+    // Not charged to a budget, callers charge what they pass on.
+    bool read(const QString &packFileName, qint64 offset, qint64 size, QByteArray &data) const;
+
+    QString getPackFilePath(const QString &packFileName) const;
+    QStringList listPackFileNames() const;
+
+    // Marks a pack whose versions all moved out, removeExpiredPacks() deletes it once the grace period passed.
+    bool retire(const QString &packFileName);
+    bool isRetired(const QString &packFileName) const;
+
+    // Returns false when a pack couldn't be deleted, it is retried on next call.
+    bool removeExpiredPacks();
+
+    // Pack currently appended to. It is never repacked.
+    static QString activePackFileName();
+
+private:
+    QString packFolderPath;
+
+    static QMutex appendMutex; // Shared by all instances, each FileStorageManager call creates its own
+    static QString activePack;
+};
+
+#endif // PACKSTORE_H
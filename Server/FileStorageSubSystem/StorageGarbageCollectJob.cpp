@@ -0,0 +1,142 @@
+#include "StorageGarbageCollectJob.h"
+
+#include "FileStorageManager.h"
+#include "Utility/Logger.h"
+#include "Utility/IoScheduler.h"
+#include "Utility/StorageLayout.h"
+
+#include <QDir>
+#include <QMutex>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QThreadPool>
+#include <QtConcurrent>
+
+StorageGarbageCollectJob::StorageGarbageCollectJob(const QString &storageFolderPath)
+    : BackgroundJob(BackgroundJob::Priority::Low, BackgroundJob::PoolType::Io)
+{
+    this->storageFolderPath = storageFolderPath;
+}
+
+qint64 StorageGarbageCollectJob::getOrphanCount() const
+{
+    return orphanCount;
+}
+
+qint64 StorageGarbageCollectJob::getReclaimedBytes() const
+{
+    return reclaimedBytes;
+}
+
+qint64 StorageGarbageCollectJob::getMissingCount() const
+{
+    return missingCount;
+}
+
+bool StorageGarbageCollectJob::run()
+{
+    // Flat files would be reported as missing from their shards.
+    if(!StorageLayout::listFlatFileNames(storageFolderPath).isEmpty())
+    {
+        LOG_INFO("StorageGarbageCollectJob", "skipped, shard migration isn't finished");
+        return true;
+    }
+
+    QStringList prefixList;
+    for(int value = 0; value < 256; value++)
+        prefixList.append(QString::number(value, 16).rightJustified(StorageLayout::ShardPrefixLength, '0'));
+
+    QThreadPool scanPool;
+    scanPool.setMaxThreadCount(ScanThreadCount);
+
+    QMutex progressMutex;
+    qint64 doneCount = 0;
+
+    QtConcurrent::blockingMap(&scanPool, prefixList, [this, &progressMutex, &doneCount, &prefixList](const QString &prefix) {
+        if(isCancelRequested())
+            return;
+
+        scanShard(prefix);
+
+        QMutexLocker locker(&progressMutex);
+        setProgress(++doneCount, prefixList.size());
+    });
+
+    if(isCancelRequested())
+        return false;
+
+    LOG_INFO("StorageGarbageCollectJob", QString("deleted %1 orphan files, %2 bytes reclaimed")
+                                                 .arg(orphanCount.load())
+                                                 .arg(reclaimedBytes.load()));
+
+    if(missingCount > 0)
+        LOG_WARNING("StorageGarbageCollectJob", QString("%1 versions have no file in storage folder").arg(missingCount.load()));
+
+    return true;
+}
+
+void StorageGarbageCollectJob::scanShard(const QString &prefix)
+{
+    auto fsm = FileStorageManager::instance();
+    QStringList storedList = fsm->getStoredFileNamesWithPrefix(prefix);
+
+    QDir shardDir(storageFolderPath + prefix);
+    QStringList leafList = shardDir.entryList(QDir::Filter::Dirs | QDir::Filter::NoDotAndDotDot);
+
+    QStringList presentList;
+    for(const QString &leaf : leafList)
+    {
+        QDir leafDir(shardDir.filePath(leaf));
+        presentList.append(leafDir.entryList({"*.file"}, QDir::Filter::Files | QDir::Filter::Hidden, QDir::SortFlag::NoSort));
+    }
+
+    // Merge needs the same order as the query, which compares names binary.
+    presentList.sort(Qt::CaseSensitivity::CaseSensitive);
+
+    QDateTime ageLimit = QDateTime::currentDateTimeUtc().addSecs(-MinOrphanAgeSecs);
+    qsizetype storedIndex = 0;
+    qsizetype presentIndex = 0;
+
+    while(storedIndex < storedList.size() || presentIndex < presentList.size())
+    {
+        int order = 0;
+
+        if(storedIndex == storedList.size())
+            order = 1;
+        else if(presentIndex == presentList.size())
+            order = -1;
+        else
+            order = storedList.at(storedIndex).compare(presentList.at(presentIndex));
+
+        if(order == 0)
+        {
+            ++storedIndex;
+            ++presentIndex;
+        }
+        else if(order < 0)
+        {
+            LOG_TRACE("StorageGarbageCollectJob", "missing file " + storedList.at(storedIndex));
+            ++missingCount;
+            ++storedIndex;
+        }
+        else
+        {
+            QString fileName = presentList.at(presentIndex);
+            QFileInfo info(storageFolderPath + StorageLayout::shardedRelativePath(fileName));
+
+            if(info.lastModified().toUTC() < ageLimit)
+            {
+                IoScheduler::instance()->acquire(IoScheduler::Budget::Background, UnlinkCost);
+                qint64 size = info.size();
+
+                if(QFile::remove(info.filePath()))
+                {
+                    ++orphanCount;
+                    reclaimedBytes += size;
+                }
+            }
+
+            ++presentIndex;
+        }
+    }
+}
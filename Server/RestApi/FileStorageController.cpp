@@ -1,8 +1,11 @@
 #include "FileStorageController.h"
 
 #include "JsonDtoFormat.h"
+#include "Utility/Logger.h"
 #include "FileStorageSubSystem/FileStorageManager.h"
+#include "FileStorageSubSystem/IntegrityScrubJob.h"
 
+#include <QDateTime>
 #include <QJsonObject>
 #include <QDirIterator>
 #include <QJsonDocument>
@@ -29,8 +32,8 @@ QHttpServerResponse FileStorageController::addNewFolder(const QHttpServerRequest
         userFolderPath = userFolderPath.normalized(QString::NormalizationForm::NormalizationForm_D);
     }
 
-    qDebug() << "symbolFolderPath = " << symbolFolderPath;
-    qDebug() << "userFolderPath = " << userFolderPath;
+    LOG_DEBUG("RestApi", "symbolFolderPath = " + symbolFolderPath);
+    LOG_DEBUG("RestApi", "userFolderPath = " + userFolderPath);
 
     auto fsm = FileStorageManager::instance();
     bool isAdded = fsm->addNewFolder(symbolFolderPath, userFolderPath);
@@ -59,10 +62,10 @@ QHttpServerResponse FileStorageController::addNewFile(const QHttpServerRequest &
         pathToFile = pathToFile.normalized(QString::NormalizationForm::NormalizationForm_D);
     }
 
-    qDebug() << "symbolFolderPath = " << symbolFolderPath;
-    qDebug() << "pathToFile = " << pathToFile;
-    qDebug() << "description = " << description;
-    qDebug() << "isFrozen = " << isFrozen;
+    LOG_DEBUG("RestApi", "symbolFolderPath = " + symbolFolderPath);
+    LOG_DEBUG("RestApi", "pathToFile = " + pathToFile);
+    LOG_DEBUG("RestApi", "description = " + description);
+    LOG_DEBUG("RestApi", "isFrozen = " + QString(isFrozen ? "true" : "false"));
 
     auto fsm = FileStorageManager::instance();
 
@@ -70,8 +73,7 @@ QHttpServerResponse FileStorageController::addNewFile(const QHttpServerRequest &
 
     bool isAdded = fsm->addNewFile(symbolFolderPath, pathToFile, isFrozen, "", description);
 
-    qDebug() << "isAdded = " << isAdded;
-    qDebug() << "";
+    LOG_DEBUG("RestApi", "isAdded = " + QString(isAdded ? "true" : "false"));
 
     QJsonObject responseBody {{"isAdded", isAdded}};
     QHttpServerResponse response(responseBody, QHttpServerResponse::StatusCode::Ok);
@@ -92,8 +94,8 @@ QHttpServerResponse FileStorageController::appendVersion(const QHttpServerReques
     if(QOperatingSystemVersion::currentType() == QOperatingSystemVersion::OSType::MacOS)
         pathToFile = pathToFile.normalized(QString::NormalizationForm::NormalizationForm_D);
 
-    qDebug() << "pathToFile = " << pathToFile;
-    qDebug() << "description = " << description;
+    LOG_DEBUG("RestApi", "pathToFile = " + pathToFile);
+    LOG_DEBUG("RestApi", "description = " + description);
 
     auto fsm = FileStorageManager::instance();
 
@@ -101,8 +103,7 @@ QHttpServerResponse FileStorageController::appendVersion(const QHttpServerReques
 
     bool isAppended = fsm->appendVersion(fileJson[JsonKeys::File::SymbolFilePath].toString(), pathToFile, description);
 
-    qDebug() << "isAppended = " << isAppended;
-    qDebug() << "";
+    LOG_DEBUG("RestApi", "isAppended = " + QString(isAppended ? "true" : "false"));
 
     QJsonObject responseBody {{"isAppended", isAppended}};
 
@@ -119,7 +120,7 @@ QHttpServerResponse FileStorageController::deleteFolder(const QHttpServerRequest
     QJsonObject jsonObject = jsonDoc.object();
 
     QString symbolFolderPath = jsonObject["symbolPath"].toString();
-    qDebug() << "symbolFolderPath = " << symbolFolderPath;
+    LOG_DEBUG("RestApi", "symbolFolderPath = " + symbolFolderPath);
 
     auto fsm = FileStorageManager::instance();
     bool result = fsm->deleteFolder(symbolFolderPath);
@@ -138,7 +139,7 @@ QHttpServerResponse FileStorageController::deleteFile(const QHttpServerRequest &
     QJsonObject jsonObject = jsonDoc.object();
 
     QString symbolFilePath = jsonObject["symbolPath"].toString();
-    qDebug() << "symbolFilePath = " << symbolFilePath;
+    LOG_DEBUG("RestApi", "symbolFilePath = " + symbolFilePath);
 
     auto fsm = FileStorageManager::instance();
     bool result = fsm->deleteFile(symbolFilePath);
@@ -157,7 +158,7 @@ QHttpServerResponse FileStorageController::getFolder(const QHttpServerRequest &r
     QJsonObject jsonObject = jsonDoc.object();
 
     QString symbolFolderPath = jsonObject["symbolPath"].toString();
-    qDebug() << "symbolFolderPath = " << symbolFolderPath;
+    LOG_DEBUG("RestApi", "symbolFolderPath = " + symbolFolderPath);
 
     auto fsm = FileStorageManager::instance();
     QJsonObject responseBody = fsm->getFolderJsonBySymbolPath(symbolFolderPath, true);
@@ -174,7 +175,7 @@ QHttpServerResponse FileStorageController::getFolderUserPath(const QHttpServerRe
     QJsonObject jsonObject = jsonDoc.object();
 
     QString userFolderPath = jsonObject["userFolderPath"].toString();
-    qDebug() << "userFolderPath = " << userFolderPath;
+    LOG_DEBUG("RestApi", "userFolderPath = " + userFolderPath);
 
     auto fsm = FileStorageManager::instance();
     QJsonObject responseBody = fsm->getFolderJsonByUserPath(userFolderPath, true);
@@ -188,8 +189,7 @@ QHttpServerResponse FileStorageController::getStorageFolderPath(const QHttpServe
     QJsonObject result;
     auto fsm = FileStorageManager::instance();
 
-    qDebug() << "storageFolderPath = " << fsm->getStorageFolderPath();
-    qDebug() << "";
+    LOG_DEBUG("RestApi", "storageFolderPath = " + fsm->getStorageFolderPath());
 
     result.insert("storageFolderPath", fsm->getStorageFolderPath());
 
@@ -204,8 +204,7 @@ QHttpServerResponse FileStorageController::getFile(const QHttpServerRequest &req
     QJsonObject jsonObject = jsonDoc.object();
 
     QString symbolFilePath = jsonObject["symbolPath"].toString();
-    qDebug() << "symbolFilePath = " << symbolFilePath;
-    qDebug() << "";
+    LOG_DEBUG("RestApi", "symbolFilePath = " + symbolFilePath);
 
     auto fsm = FileStorageManager::instance();
     QJsonObject responseBody = fsm->getFileJsonBySymbolPath(symbolFilePath, true);
@@ -222,8 +221,7 @@ QHttpServerResponse FileStorageController::getFileByUserPath(const QHttpServerRe
     QJsonObject jsonObject = jsonDoc.object();
 
     QString userFilePath = jsonObject["userFilePath"].toString();
-    qDebug() << "userFilePath = " << userFilePath;
-    qDebug() << "";
+    LOG_DEBUG("RestApi", "userFilePath = " + userFilePath);
 
     auto fsm = FileStorageManager::instance();
     QJsonObject responseBody = fsm->getFileJsonByUserPath(userFilePath, true);
@@ -231,3 +229,55 @@ QHttpServerResponse FileStorageController::getFileByUserPath(const QHttpServerRe
     QHttpServerResponse response(responseBody);
     return response;
 }
+
+// Inline versions live in the database, clients can't read them from the storage folder.
+QHttpServerResponse FileStorageController::getInlineVersionContent(const QHttpServerRequest &request)
+{
+    QByteArray requestBody = request.body();
+
+    QJsonDocument jsonDoc = QJsonDocument::fromJson(requestBody);
+    QJsonObject jsonObject = jsonDoc.object();
+
+    QString symbolFilePath = jsonObject["symbolPath"].toString();
+    qlonglong versionNumber = jsonObject["versionNumber"].toInteger();
+    LOG_DEBUG("RestApi", "symbolFilePath = " + symbolFilePath);
+
+    auto fsm = FileStorageManager::instance();
+    FileVersionRecord versionRecord = fsm->getFileVersion(symbolFilePath, versionNumber);
+
+    if(!versionRecord.isExist || !versionRecord.isInline)
+        return QHttpServerResponse(QHttpServerResponse::StatusCode::NotFound);
+
+    QSharedPointer<QIODevice> content = fsm->openVersionFile(versionRecord);
+
+    if(content.isNull())
+        return QHttpServerResponse(QHttpServerResponse::StatusCode::InternalServerError);
+
+    return QHttpServerResponse("application/octet-stream", content->readAll());
+}
+
+QHttpServerResponse FileStorageController::startIntegrityScrub(const QHttpServerRequest &request)
+{
+    QJsonObject responseBody {{"jobId", IntegrityScrubJob::submitIfIdle()}};
+
+    return QHttpServerResponse(responseBody, QHttpServerResponse::StatusCode::Ok);
+}
+
+QHttpServerResponse FileStorageController::getIntegrityScrubStatus(const QHttpServerRequest &request)
+{
+    IntegrityScrubJob::Status status = IntegrityScrubJob::getStatus();
+    QJsonObject responseBody;
+
+    responseBody["isRunning"] = status.isRunning;
+    responseBody["checkedCount"] = status.checkedCount;
+    responseBody["totalCount"] = status.totalCount;
+    responseBody["corruptCount"] = status.corruptCount;
+    responseBody["storedCorruptCount"] = FileStorageManager::instance()->countCorruptVersions();
+
+    if(status.lastFinishedMsecs == 0)
+        responseBody["lastFinishedTimestamp"] = QJsonValue(QJsonValue::Type::Null);
+    else
+        responseBody["lastFinishedTimestamp"] = QDateTime::fromMSecsSinceEpoch(status.lastFinishedMsecs).toString(Qt::DateFormat::ISODateWithMs);
+
+    return QHttpServerResponse(responseBody, QHttpServerResponse::StatusCode::Ok);
+}
@@ -21,6 +21,9 @@ public:
     QHttpServerResponse getStorageFolderPath(const QHttpServerRequest& request);
     QHttpServerResponse getFile(const QHttpServerRequest& request);
     QHttpServerResponse getFileByUserPath(const QHttpServerRequest& request);
+    QHttpServerResponse getInlineVersionContent(const QHttpServerRequest& request);
+    QHttpServerResponse startIntegrityScrub(const QHttpServerRequest& request);
+    QHttpServerResponse getIntegrityScrubStatus(const QHttpServerRequest& request);
 
 signals:
 
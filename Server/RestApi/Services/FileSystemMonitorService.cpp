@@ -1,8 +1,8 @@
 #include "FileSystemMonitorService.h"
 
-#include "JsonDtoFormat.h"
 #include "FileStorageSubSystem/FileStorageManager.h"
 
+#include <QJsonArray>
 #include <QJsonObject>
 #include <QDirIterator>
 #include <QJsonDocument>
@@ -21,26 +21,22 @@ QJsonObject FileSystemMonitorService::deletedItemsObject() const
     QStringList folderList;
     QMultiHash<QString, QString> fileMap;
 
-    for(const QJsonValue &folderObject : fsm->getActiveFolderList())
+    for(const FolderRecord &folderRecord : fsm->getActiveFolders())
     {
-        QString folderPath = folderObject[JsonKeys::Folder::UserFolderPath].toString();
+        QString folderPath = folderRecord.userFolderPath;
         QFileInfo folderInfo(folderPath);
-        bool isFolderFrozen = folderObject[JsonKeys::Folder::IsFrozen].toBool();
 
-        if(!folderInfo.exists() && !isFolderFrozen)
+        if(!folderInfo.exists() && !folderRecord.isFrozen)
             folderList.append(folderPath);
 
-        QJsonObject fatFolderJson = fsm->getFolderJsonByUserPath(folderPath, true);
+        FolderRecord fatFolderRecord = fsm->getFolderBySymbolPath(folderRecord.symbolFolderPath, true);
 
-        for(const QJsonValue &fileObject : fatFolderJson[JsonKeys::Folder::ChildFiles].toArray())
+        for(const FileRecord &fileRecord : fatFolderRecord.childFiles)
         {
-            QString filePath = fileObject[JsonKeys::File::UserFilePath].toString();
-            QString fileName = fileObject[JsonKeys::File::FileName].toString();
-            QFileInfo fileInfo(filePath);
-            bool isFileFrozen = fileObject[JsonKeys::File::IsFrozen].toBool();
+            QFileInfo fileInfo(fileRecord.userFilePath);
 
-            if(!fileInfo.exists() && !isFileFrozen)
-                fileMap.insert(folderPath, fileName);
+            if(!fileInfo.exists() && !fileRecord.isFrozen)
+                fileMap.insert(folderPath, fileRecord.fileName);
         }
     }
 
@@ -71,9 +67,9 @@ QJsonObject FileSystemMonitorService::updatedFilesObject() const
 
     QMultiHash<QString, QString> fileMap;
 
-    for(const QJsonValue &value : fsm->getActiveFolderList())
+    for(const FolderRecord &folderRecord : fsm->getActiveFolders())
     {
-        QDirIterator dirIterator(value[JsonKeys::Folder::UserFolderPath].toString(),
+        QDirIterator dirIterator(folderRecord.userFolderPath,
                                  QDir::Filter::Files | QDir::Filter::NoDotAndDotDot);
 
         while (dirIterator.hasNext())
@@ -85,33 +81,20 @@ QJsonObject FileSystemMonitorService::updatedFilesObject() const
             if(QOperatingSystemVersion::currentType() == QOperatingSystemVersion::OSType::MacOS)
                 path = path.normalized(QString::NormalizationForm::NormalizationForm_D);
 
-            QJsonObject fileJson = fsm->getFileJsonByUserPath(path);
+            FileRecord fileRecord = fsm->getFileByUserPath(path);
 
-            bool isFilePersists = fileJson[JsonKeys::IsExist].toBool();
-            bool isFileFrozen = fileJson[JsonKeys::File::IsFrozen].toBool();
-
-            if(isFilePersists && !isFileFrozen)
+            if(fileRecord.isExist && !fileRecord.isFrozen)
             {
-                QString symbolPath = fileJson[JsonKeys::File::SymbolFilePath].toString();
-
-                qlonglong versionNumber = fileJson[JsonKeys::File::MaxVersionNumber].toInteger();
-                QJsonObject versionJson = fsm->getFileVersionJson(symbolPath, versionNumber);
-
-                QDateTime savedTimestamp = QDateTime::fromString(versionJson[JsonKeys::FileVersion::LastModifiedTimestamp].toString(),
-                                                                 Qt::DateFormat::ISODateWithMs);
-
                 QFileInfo info(path);
                 QString parentPath = QDir::toNativeSeparators(info.absolutePath());
 
                 if(QOperatingSystemVersion::currentType() == QOperatingSystemVersion::OSType::MacOS)
                     parentPath = parentPath.normalized(QString::NormalizationForm::NormalizationForm_D);
 
-                QDateTime lastTimestamp = info.lastModified();
-
                 if(!parentPath.endsWith(QDir::separator()))
                     parentPath.append(QDir::separator());
 
-                if(lastTimestamp != savedTimestamp)
+                if(!fsm->isFileUnchanged(fileRecord.symbolFilePath, FileStat::read(path)))
                     fileMap.insert(parentPath, info.fileName());
             }
         }
@@ -133,10 +116,9 @@ QStringList FileSystemMonitorService::generateRootFoldersList() const
 
     auto fsm = FileStorageManager::instance();
 
-    for(const QJsonValue &value : fsm->getActiveFolderList())
+    for(const FolderRecord &folderRecord : fsm->getActiveFolders())
     {
-        QString path = value.toObject()[JsonKeys::Folder::UserFolderPath].toString();
-        QStringList childFolders = findNewFolders(path);
+        QStringList childFolders = findNewFolders(folderRecord.userFolderPath);
 
         if(!childFolders.isEmpty())
             result.append(childFolders);
@@ -200,9 +182,9 @@ QJsonObject FileSystemMonitorService::generateFilesObject(QStringList rootFolder
     auto fsm = FileStorageManager::instance();
 
     // Find new files in existing folders.
-    for(const QJsonValue &value : fsm->getActiveFolderList())
+    for(const FolderRecord &folderRecord : fsm->getActiveFolders())
     {
-        QString folderPath = value.toObject()[JsonKeys::Folder::UserFolderPath].toString();
+        QString folderPath = folderRecord.userFolderPath;
         QStringList childFiles = findNewFiles(folderPath);
 
         if(!childFiles.isEmpty())
@@ -308,7 +290,7 @@ QStringList FileSystemMonitorService::findNewFolders(QString rootPath, bool isRe
         if(!path.endsWith(QDir::separator()))
             path.append(QDir::separator());
 
-        bool isExists = fsm->getFolderJsonByUserPath(path)[JsonKeys::IsExist].toBool();
+        bool isExists = fsm->getFolderByUserPath(path).isExist;
 
         if(!isExists)
             result.append(path);
@@ -341,7 +323,7 @@ QStringList FileSystemMonitorService::findNewFiles(QString rootPath, bool isRecu
         if(QOperatingSystemVersion::currentType() == QOperatingSystemVersion::OSType::MacOS)
             path = path.normalized(QString::NormalizationForm::NormalizationForm_D);
 
-        bool isExists = fsm->getFileJsonByUserPath(path)[JsonKeys::IsExist].toBool();
+        bool isExists = fsm->getFileByUserPath(path).isExist;
 
         if(!isExists)
             result.append(path);
@@ -1,6 +1,8 @@
 #include "ZipExportService.h"
 
 #include "JsonDtoFormat.h"
+#include "Utility/IoScheduler.h"
+#include "Utility/ChunkBufferPool.h"
 #include "FileStorageSubSystem/FileStorageManager.h"
 
 #include <QJsonDocument>
@@ -189,22 +191,29 @@ bool ZipExportService::addFileToZip(QString symbolFilePath, qulonglong versionNu
     auto fsm = FileStorageManager::instance();
 
     QString internalFileName = version[JsonKeys::FileVersion::InternalFileName].toString();
-    QString internalFilePath = fsm->getStorageFolderPath() + internalFileName;
+    FileVersionRecord versionRecord = fsm->getFileVersion(version[JsonKeys::FileVersion::SymbolFilePath].toString(),
+                                                          version[JsonKeys::FileVersion::VersionNumber].toInteger());
 
-    QFile rawFile(internalFilePath);
-    bool isReadable = rawFile.open(QFile::OpenModeFlag::ReadOnly);
+    QSharedPointer<QIODevice> rawFile = fsm->openVersionFile(versionRecord);
 
-    if(!isReadable)
+    if(rawFile.isNull())
         return false;
 
-    QuaZipNewInfo info(internalFileName, internalFilePath);
+    // Packed versions have no file, entry gets current time for them.
+    QuaZipNewInfo info(internalFileName, fsm->getInternalFilePath(internalFileName));
     QuaZipFile fileInZip(&archive);
     fileInZip.open(QFile::OpenModeFlag::WriteOnly, info);
 
-    while(!rawFile.atEnd())
+    ChunkBufferPool::Lease buffer;
+
+    while(!rawFile->atEnd())
     {
-        // Write up to 100mb in every iteration.
-        qlonglong bytesWritten = fileInZip.write(rawFile.read(104857600));
+        qlonglong readCount = rawFile->read(buffer.data(), buffer.size());
+        if(readCount == -1)
+            return false;
+
+        IoScheduler::instance()->acquire(IoScheduler::Budget::Background, readCount);
+        qlonglong bytesWritten = fileInZip.write(buffer.data(), readCount);
         if(bytesWritten == -1)
             return false;
     }
@@ -1,6 +1,7 @@
 #include "ZipImportService.h"
 
 #include "JsonDtoFormat.h"
+#include "Utility/ChunkBufferPool.h"
 #include "FileStorageSubSystem/FileStorageManager.h"
 
 #include <QJsonDocument>
@@ -194,13 +195,19 @@ bool ZipImportService::importFile(QString symbolFilePath, qulonglong versionNumb
     if(!isSourceOpened || !isTempOpened)
         return false;
 
-    while(!fileInZip.atEnd())
+    // Lease is released before adding the file, which copies through the pool too.
     {
-        qlonglong bytesWritten = tempFile.write(fileInZip.read(104857600)); // Read up to 100mb.
-        tempFile.flush();
+        ChunkBufferPool::Lease buffer;
+
+        while(!fileInZip.atEnd())
+        {
+            qlonglong readCount = fileInZip.read(buffer.data(), buffer.size());
 
-        if(bytesWritten <= -1)
-            return false;
+            if(readCount <= -1 || tempFile.write(buffer.data(), readCount) <= -1)
+                return false;
+        }
+
+        tempFile.flush();
     }
 
     bool result = false;
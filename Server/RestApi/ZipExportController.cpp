@@ -1,5 +1,6 @@
 #include "ZipExportController.h"
 
+#include "Utility/Logger.h"
 
 #include <QJsonObject>
 #include <QJsonDocument>
@@ -22,8 +23,7 @@ QHttpServerResponse ZipExportController::setFilePath(const QHttpServerRequest &r
     if(QOperatingSystemVersion::currentType() == QOperatingSystemVersion::OSType::MacOS)
         filePath = filePath.normalized(QString::NormalizationForm::NormalizationForm_D);
 
-    qDebug() << "filePath = " << filePath;
-    qDebug() << "";
+    LOG_DEBUG("RestApi", "filePath = " + filePath);
 
     service.setZipFilePath(filePath);
 
@@ -51,8 +51,7 @@ QHttpServerResponse ZipExportController::setRootFolder(const QHttpServerRequest
     //if(QOperatingSystemVersion::currentType() == QOperatingSystemVersion::OSType::MacOS)
     //    rootSymbolFolderPath = rootSymbolFolderPath.normalized(QString::NormalizationForm::NormalizationForm_D);
 
-    qDebug() << "rootSymbolFolderPath = " << rootSymbolFolderPath;
-    qDebug() << "";
+    LOG_DEBUG("RestApi", "rootSymbolFolderPath = " + rootSymbolFolderPath);
 
     service.setRootSymbolFolderPath(rootSymbolFolderPath);
 
@@ -100,9 +99,8 @@ QHttpServerResponse ZipExportController::addFile(const QHttpServerRequest &reque
     QString symbolFilePath = jsonObject["symbolFilePath"].toString();
     qlonglong versionNumber = jsonObject["versionNumber"].toInteger();
 
-    qDebug() << "symbolFilePath = " << symbolFilePath;
-    qDebug() << "versionNumber = " << versionNumber;
-    qDebug() << "";
+    LOG_DEBUG("RestApi", "symbolFilePath = " + symbolFilePath);
+    LOG_DEBUG("RestApi", "versionNumber = " + QString::number(versionNumber));
 
     QJsonObject responseBody {{"isAdded", service.addFileToZip(symbolFilePath, versionNumber)}};
     return QHttpServerResponse(responseBody, QHttpServerResponse::StatusCode::Ok);
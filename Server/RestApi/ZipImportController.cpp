@@ -1,5 +1,7 @@
 #include "ZipImportController.h"
 
+#include "Utility/Logger.h"
+
 #include <QJsonDocument>
 #include <QHttpServerRequest>
 #include <QOperatingSystemVersion>
@@ -21,8 +23,7 @@ QHttpServerResponse ZipImportController::setFilePath(const QHttpServerRequest &r
     if(QOperatingSystemVersion::currentType() == QOperatingSystemVersion::OSType::MacOS)
         filePath = filePath.normalized(QString::NormalizationForm::NormalizationForm_D);
 
-    qDebug() << "filePath = " << filePath;
-    qDebug() << "";
+    LOG_DEBUG("RestApi", "filePath = " + filePath);
 
     service.setZipFilePath(filePath);
 
@@ -69,9 +70,8 @@ QHttpServerResponse ZipImportController::importFileFromZip(const QHttpServerRequ
     QString symbolFilePath = jsonObject["symbolFilePath"].toString();
     qulonglong versionNumber = jsonObject["versionNumber"].toInteger();
 
-    qDebug() << "symbolFilePath = " << symbolFilePath;
-    qDebug() << "versionNumber = " << versionNumber;
-    qDebug() << "";
+    LOG_DEBUG("RestApi", "symbolFilePath = " + symbolFilePath);
+    LOG_DEBUG("RestApi", "versionNumber = " + QString::number(versionNumber));
 
     QJsonObject responseBody {{"isImported", service.importFile(symbolFilePath, versionNumber)}};
 
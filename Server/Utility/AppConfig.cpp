@@ -1,31 +1,44 @@
 #include "AppConfig.h"
+#include "AppConfigNotifier.h"
+#include "ChunkBufferPool.h"
 
 #include <QDir>
-#include <QReadLocker>
-#include <QWriteLocker>
+#include <QMutexLocker>
 #include <QCoreApplication>
 
-QReadWriteLock AppConfig::lock;
+QMutex AppConfig::writeMutex;
 
 AppConfig::AppConfig()
 {
-    QString settingsFilePath = QDir::toNativeSeparators(QCoreApplication::applicationDirPath());
-    settingsFilePath += QDir::separator();
-    settingsFilePath += "settings.ini";
+    values = std::atomic_load(&snapshot());
+}
+
+QString AppConfig::settingsFilePath()
+{
+    QString result = QDir::toNativeSeparators(QCoreApplication::applicationDirPath());
+    result += QDir::separator();
+    result += "settings.ini";
 
-    settings = new QSettings(settingsFilePath, QSettings::Format::IniFormat);
+    return result;
 }
 
-AppConfig::~AppConfig()
+void AppConfig::reload()
 {
-    delete settings;
+    QStringList changedKeyList;
+
+    {
+        QMutexLocker locker(&writeMutex);
+        QSettings settings(settingsFilePath(), QSettings::Format::IniFormat);
+        changedKeyList = replaceSnapshot(settings);
+    }
+
+    for(const QString &key : changedKeyList)
+        emit AppConfigNotifier::instance()->signalValueChanged(key);
 }
 
 bool AppConfig::isDisclaimerAccepted() const
 {
-    QReadLocker readLocker(&lock);
-
-    if(settings->value(KeyDisclaimerAccepted).toString() == "true")
+    if(value(KeyDisclaimerAccepted).toString() == "true")
         return true;
 
     return false;
@@ -33,16 +46,12 @@ bool AppConfig::isDisclaimerAccepted() const
 
 void AppConfig::setDisclaimerAccepted(bool newDisclaimerAccepted)
 {
-    QWriteLocker writeLocker(&lock);
-
-   settings->setValue(KeyDisclaimerAccepted, newDisclaimerAccepted);
+    setValue(KeyDisclaimerAccepted, newDisclaimerAccepted);
 }
 
 bool AppConfig::isTrayIconInformed() const
 {
-    QReadLocker readLocker(&lock);
-
-    if(settings->value(KeyTrayIconInformed).toString() == "true")
+    if(value(KeyTrayIconInformed).toString() == "true")
         return true;
 
     return false;
@@ -50,16 +59,12 @@ bool AppConfig::isTrayIconInformed() const
 
 void AppConfig::setTrayIconInformed(bool newTrayIconInformed)
 {
-    QWriteLocker writeLocker(&lock);
-
-    settings->setValue(KeyTrayIconInformed, newTrayIconInformed);
+    setValue(KeyTrayIconInformed, newTrayIconInformed);
 }
 
 bool AppConfig::isStorageFolderPathValid() const
 {
-    QReadLocker readLocker(&lock);
-
-    QString readValue = settings->value(KeyStorageFolderPath).toString();
+    QString readValue = value(KeyStorageFolderPath).toString();
 
     if(readValue.isNull() || readValue.isEmpty())
         return false;
@@ -72,9 +77,7 @@ bool AppConfig::isStorageFolderPathValid() const
 
 QString AppConfig::getStorageFolderPath() const
 {
-    QReadLocker readLocker(&lock);
-
-    QString readValue = settings->value(KeyStorageFolderPath).toString();
+    QString readValue = value(KeyStorageFolderPath).toString();
     readValue = QDir::toNativeSeparators(readValue);
 
     if(!readValue.endsWith(QDir::separator()))
@@ -85,12 +88,161 @@ QString AppConfig::getStorageFolderPath() const
 
 void AppConfig::setStorageFolderPath(const QString &newStorageFolderPath)
 {
-    QWriteLocker writeLocker(&lock);
-
     QString value = QDir::toNativeSeparators(newStorageFolderPath);
 
     if(!value.endsWith(QDir::separator()))
         value.append(QDir::separator());
 
-    settings->setValue(KeyStorageFolderPath, value);
+    setValue(KeyStorageFolderPath, value);
+}
+
+QString AppConfig::getHashAlgorithm() const
+{
+    // Empty value means FileStorageManager falls back to its default algorithm.
+    return value(KeyHashAlgorithm).toString();
+}
+
+void AppConfig::setHashAlgorithm(const QString &newHashAlgorithm)
+{
+    setValue(KeyHashAlgorithm, newHashAlgorithm);
+}
+
+qint64 AppConfig::getIoForegroundBandwidthLimit() const
+{
+    return value(KeyIoForegroundBandwidthLimit, 0).toLongLong();
+}
+
+void AppConfig::setIoForegroundBandwidthLimit(qint64 newBytesPerSecond)
+{
+    setValue(KeyIoForegroundBandwidthLimit, newBytesPerSecond);
+}
+
+qint64 AppConfig::getIoBackgroundBandwidthLimit() const
+{
+    return value(KeyIoBackgroundBandwidthLimit, 0).toLongLong();
+}
+
+void AppConfig::setIoBackgroundBandwidthLimit(qint64 newBytesPerSecond)
+{
+    setValue(KeyIoBackgroundBandwidthLimit, newBytesPerSecond);
+}
+
+bool AppConfig::isIoBackgroundIdlePriority() const
+{
+    // Enabled unless turned off explicitly.
+    if(value(KeyIoBackgroundIdlePriority).toString() == "false")
+        return false;
+
+    return true;
+}
+
+void AppConfig::setIoBackgroundIdlePriority(bool newIoBackgroundIdlePriority)
+{
+    setValue(KeyIoBackgroundIdlePriority, newIoBackgroundIdlePriority);
+}
+
+qint64 AppConfig::getIoChunkBufferSize() const
+{
+    return value(KeyIoChunkBufferSize, ChunkBufferPool::DefaultBufferSize).toLongLong();
+}
+
+void AppConfig::setIoChunkBufferSize(qint64 newBufferSize)
+{
+    setValue(KeyIoChunkBufferSize, newBufferSize);
+}
+
+int AppConfig::getIoChunkBufferCount() const
+{
+    return value(KeyIoChunkBufferCount, ChunkBufferPool::DefaultBufferCount).toInt();
+}
+
+void AppConfig::setIoChunkBufferCount(int newBufferCount)
+{
+    setValue(KeyIoChunkBufferCount, newBufferCount);
+}
+
+qint64 AppConfig::getInlineFileSizeLimit() const
+{
+    return value(KeyInlineFileSizeLimit, 4096).toLongLong();
+}
+
+void AppConfig::setInlineFileSizeLimit(qint64 newInlineFileSizeLimit)
+{
+    setValue(KeyInlineFileSizeLimit, newInlineFileSizeLimit);
+}
+
+int AppConfig::getScrubIntervalDays() const
+{
+    return qMax(value(KeyScrubIntervalDays, 30).toInt(), 0);
+}
+
+void AppConfig::setScrubIntervalDays(int newScrubIntervalDays)
+{
+    setValue(KeyScrubIntervalDays, newScrubIntervalDays);
+}
+
+std::shared_ptr<const QVariantHash> &AppConfig::snapshot()
+{
+    static std::shared_ptr<const QVariantHash> current = valuesOf(QSettings(settingsFilePath(), QSettings::Format::IniFormat));
+    return current;
+}
+
+std::shared_ptr<const QVariantHash> AppConfig::valuesOf(const QSettings &settings)
+{
+    auto result = std::make_shared<QVariantHash>();
+
+    for(const QString &key : settings.allKeys())
+        result->insert(key, settings.value(key));
+
+    return result;
+}
+
+QStringList AppConfig::replaceSnapshot(const QSettings &settings)
+{
+    QStringList result;
+    std::shared_ptr<const QVariantHash> oldValues = std::atomic_load(&snapshot());
+    std::shared_ptr<const QVariantHash> newValues = valuesOf(settings);
+
+    // Values read back from the file are strings, so they are compared as strings.
+    for(auto iterator = newValues->cbegin(); iterator != newValues->cend(); ++iterator)
+    {
+        if(!oldValues->contains(iterator.key()) || oldValues->value(iterator.key()).toString() != iterator.value().toString())
+            result.append(iterator.key());
+    }
+
+    for(auto iterator = oldValues->cbegin(); iterator != oldValues->cend(); ++iterator)
+    {
+        if(!newValues->contains(iterator.key()))
+            result.append(iterator.key());
+    }
+
+    std::atomic_store(&snapshot(), newValues);
+
+    return result;
+}
+
+QVariant AppConfig::value(const QString &key, const QVariant &defaultValue) const
+{
+    return values->value(key, defaultValue);
+}
+
+void AppConfig::setValue(const QString &key, const QVariant &newValue)
+{
+    QStringList changedKeyList;
+
+    {
+        QMutexLocker locker(&writeMutex);
+
+        // File is read again, so edits made outside the app since the last reload aren't overwritten.
+        QSettings settings(settingsFilePath(), QSettings::Format::IniFormat);
+        settings.setValue(key, newValue);
+        settings.sync();
+
+        changedKeyList = replaceSnapshot(settings);
+    }
+
+    values = std::atomic_load(&snapshot());
+
+    for(const QString &changedKey : changedKeyList)
+        emit AppConfigNotifier::instance()->signalValueChanged(changedKey);
 }
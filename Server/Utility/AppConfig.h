@@ -1,14 +1,24 @@
 #ifndef APPCONFIG_H
 #define APPCONFIG_H
 
+#include <memory>
+
+#include <QMutex>
 #include <QSettings>
-#include <QReadWriteLock>
+#include <QStringList>
+#include <QVariantHash>
 
+// Settings are read from settings.ini once and kept in memory as an immutable snapshot shared by all instances.
+// Each instance keeps the snapshot it was created with, setters and reloads publish a new one atomically.
 class AppConfig
 {
 public:
     AppConfig();
-    ~AppConfig();
+
+    static QString settingsFilePath();
+
+    // Reads settings.ini again, called by AppConfigNotifier when the file is edited outside the app.
+    static void reload();
 
     bool isDisclaimerAccepted() const;
     void setDisclaimerAccepted(bool newDisclaimerAccepted);
@@ -20,15 +30,56 @@ public:
     QString getStorageFolderPath() const;
     void setStorageFolderPath(const QString &newStorageFolderPath);
 
+    QString getHashAlgorithm() const;
+    void setHashAlgorithm(const QString &newHashAlgorithm);
+
+    // Bytes per second, 0 means unlimited.
+    qint64 getIoForegroundBandwidthLimit() const;
+    void setIoForegroundBandwidthLimit(qint64 newBytesPerSecond);
+    qint64 getIoBackgroundBandwidthLimit() const;
+    void setIoBackgroundBandwidthLimit(qint64 newBytesPerSecond);
+
+    bool isIoBackgroundIdlePriority() const;
+    void setIoBackgroundIdlePriority(bool newIoBackgroundIdlePriority);
+
+    // Buffers shared by streaming copies, applied on next start.
+    qint64 getIoChunkBufferSize() const;
+    void setIoChunkBufferSize(qint64 newBufferSize);
+    int getIoChunkBufferCount() const;
+    void setIoChunkBufferCount(int newBufferCount);
+
+    // Versions smaller than this many bytes are stored in the database, 0 disables.
+    qint64 getInlineFileSizeLimit() const;
+    void setInlineFileSizeLimit(qint64 newInlineFileSizeLimit);
+
+    // Integrity scrub skips versions verified within this many days, 0 verifies all of them on each pass.
+    int getScrubIntervalDays() const;
+    void setScrubIntervalDays(int newScrubIntervalDays);
+
 private:
     static const inline QString KeyDisclaimerAccepted = "disclaimer_accepted";
     static const inline QString KeyTrayIconInformed = "tray_icon_informed";
     static const inline QString KeyStorageFolderPath = "storage_folder_path";
+    static const inline QString KeyHashAlgorithm = "hash_algorithm";
+    static const inline QString KeyIoForegroundBandwidthLimit = "io_foreground_bandwidth_limit";
+    static const inline QString KeyIoBackgroundBandwidthLimit = "io_background_bandwidth_limit";
+    static const inline QString KeyIoBackgroundIdlePriority = "io_background_idle_priority";
+    static const inline QString KeyIoChunkBufferSize = "io_chunk_buffer_size";
+    static const inline QString KeyIoChunkBufferCount = "io_chunk_buffer_count";
+    static const inline QString KeyInlineFileSizeLimit = "inline_file_size_limit";
+    static const inline QString KeyScrubIntervalDays = "scrub_interval_days";
+
+    static QMutex writeMutex; // Serializes writers, readers don't lock
+
+    static std::shared_ptr<const QVariantHash> &snapshot();
+    static std::shared_ptr<const QVariantHash> valuesOf(const QSettings &settings);
+    static QStringList replaceSnapshot(const QSettings &settings);
 
-    static QReadWriteLock lock;
+    QVariant value(const QString &key, const QVariant &defaultValue = QVariant()) const;
+    void setValue(const QString &key, const QVariant &newValue);
 
 private:
-    QSettings *settings;
+    std::shared_ptr<const QVariantHash> values;
 };
 
 #endif // APPCONFIG_H
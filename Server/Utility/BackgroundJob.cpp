@@ -0,0 +1,187 @@
+#include "BackgroundJob.h"
+
+#include "IoScheduler.h"
+#include "JobScheduler.h"
+#include "DatabaseRegistry.h"
+
+#include <QSqlQuery>
+#include <QDateTime>
+
+BackgroundJob::BackgroundJob(Priority priority, PoolType poolType)
+    : jobId(0),
+      priority(priority),
+      poolType(poolType),
+      state(State::Queued),
+      isCancelled(false),
+      lastProgressMsecs(0),
+      doneCountAtStart(0),
+      isDoneCountAtStartSet(false),
+      isCheckpointPending(false),
+      lastCheckpointMsecs(0)
+{
+}
+
+BackgroundJob::~BackgroundJob()
+{
+}
+
+qint64 BackgroundJob::getJobId() const
+{
+    return jobId;
+}
+
+BackgroundJob::Priority BackgroundJob::getPriority() const
+{
+    return priority;
+}
+
+BackgroundJob::PoolType BackgroundJob::getPoolType() const
+{
+    return poolType;
+}
+
+BackgroundJob::State BackgroundJob::getState() const
+{
+    return (State) state.load();
+}
+
+bool BackgroundJob::isCancelRequested() const
+{
+    return isCancelled.load(std::memory_order_relaxed);
+}
+
+QString BackgroundJob::checkpointKey() const
+{
+    return "";
+}
+
+void BackgroundJob::setProgress(qint64 doneCount, qint64 totalCount)
+{
+    if(!isDoneCountAtStartSet)
+    {
+        doneCountAtStart = doneCount;
+        isDoneCountAtStartSet = true;
+    }
+
+    qint64 elapsedMsecs = runTimer.elapsed();
+    bool isLast = (doneCount >= totalCount);
+
+    if(!isLast && elapsedMsecs - lastProgressMsecs < ProgressIntervalMsecs)
+        return;
+
+    lastProgressMsecs = elapsedMsecs;
+
+    qint64 remainingMsecs = -1;
+    qint64 doneInThisRun = doneCount - doneCountAtStart;
+
+    if(doneInThisRun > 0)
+        remainingMsecs = elapsedMsecs * (totalCount - doneCount) / doneInThisRun;
+
+    JobScheduler::instance()->onJobProgress(*this, doneCount, totalCount, remainingMsecs);
+}
+
+QByteArray BackgroundJob::loadCheckpoint()
+{
+    QByteArray result;
+
+    if(checkpointKey().isEmpty())
+        return result;
+
+    QSqlQuery query(checkpointDatabase());
+    query.prepare("SELECT checkpoint FROM JobCheckpoint WHERE job_key = :1;");
+    query.bindValue(":1", checkpointKey());
+    query.exec();
+
+    if(query.next())
+        result = query.value(0).toByteArray();
+
+    return result;
+}
+
+void BackgroundJob::saveCheckpoint(const QByteArray &data)
+{
+    if(checkpointKey().isEmpty())
+        return;
+
+    pendingCheckpoint = data;
+    isCheckpointPending = true;
+
+    if(runTimer.elapsed() - lastCheckpointMsecs >= CheckpointIntervalMsecs)
+        flushCheckpoint();
+}
+
+void BackgroundJob::execute()
+{
+    if(isCancelRequested())
+    {
+        state = State::Cancelled;
+        JobScheduler::instance()->onJobFinished(*this);
+        return;
+    }
+
+    state = State::Running;
+    JobScheduler::instance()->onJobStarted(jobId);
+    runTimer.start();
+
+    bool isCompleted = false;
+
+    {
+        IoScheduler::BackgroundScope backgroundScope;
+        isCompleted = run();
+    }
+
+    // Completed jobs start from scratch next time, others resume from their last checkpoint.
+    if(isCompleted)
+        clearCheckpoint();
+    else
+        flushCheckpoint();
+
+    if(isCompleted)
+        state = State::Succeeded;
+    else if(isCancelRequested())
+        state = State::Cancelled;
+    else
+        state = State::Failed;
+
+    database = QSqlDatabase(); // Connection belongs to the pool thread
+    JobScheduler::instance()->onJobFinished(*this);
+}
+
+void BackgroundJob::flushCheckpoint()
+{
+    if(!isCheckpointPending)
+        return;
+
+    QSqlQuery query(checkpointDatabase());
+    query.prepare(" INSERT INTO JobCheckpoint (job_key, checkpoint, updated_timestamp) VALUES (:1, :2, :3)"
+                  " ON CONFLICT (job_key) DO UPDATE SET checkpoint = excluded.checkpoint,"
+                  "                                     updated_timestamp = excluded.updated_timestamp;");
+    query.bindValue(":1", checkpointKey());
+    query.bindValue(":2", pendingCheckpoint);
+    query.bindValue(":3", QDateTime::currentMSecsSinceEpoch());
+    query.exec();
+
+    isCheckpointPending = false;
+    lastCheckpointMsecs = runTimer.elapsed();
+}
+
+void BackgroundJob::clearCheckpoint()
+{
+    isCheckpointPending = false;
+
+    if(checkpointKey().isEmpty())
+        return;
+
+    QSqlQuery query(checkpointDatabase());
+    query.prepare("DELETE FROM JobCheckpoint WHERE job_key = :1;");
+    query.bindValue(":1", checkpointKey());
+    query.exec();
+}
+
+QSqlDatabase BackgroundJob::checkpointDatabase()
+{
+    if(!database.isValid())
+        database = DatabaseRegistry::jobStateDatabase();
+
+    return database;
+}
@@ -0,0 +1,90 @@
+#ifndef BACKGROUNDJOB_H
+#define BACKGROUNDJOB_H
+
+#include <atomic>
+
+#include <QString>
+#include <QByteArray>
+#include <QSqlDatabase>
+#include <QElapsedTimer>
+
+// Long running unit of work executed by JobScheduler on a pool thread.
+// Subclasses poll isCancelRequested() between small steps and report progress and checkpoints as they go.
+class BackgroundJob
+{
+public:
+    friend class JobScheduler;
+
+    enum Priority
+    {
+        Low = 0,
+        Normal = 5,
+        High = 10
+    };
+
+    enum PoolType
+    {
+        Io,
+        Cpu
+    };
+
+    enum State
+    {
+        Queued,
+        Running,
+        Succeeded,
+        Failed,
+        Cancelled
+    };
+
+    static const inline qint64 ProgressIntervalMsecs = 100;
+    static const inline qint64 CheckpointIntervalMsecs = 1000;
+
+    BackgroundJob(Priority priority = Priority::Normal, PoolType poolType = PoolType::Io);
+    virtual ~BackgroundJob();
+
+    qint64 getJobId() const;
+    Priority getPriority() const;
+    PoolType getPoolType() const;
+    State getState() const;
+    bool isCancelRequested() const;
+
+    // Jobs with same key share a checkpoint. Empty key disables checkpoints.
+    virtual QString checkpointKey() const;
+
+protected:
+    // Called on a pool thread. Returns false when work couldn't be completed.
+    virtual bool run() = 0;
+
+    void setProgress(qint64 doneCount, qint64 totalCount);
+
+    // Empty when there is no checkpoint left by an interrupted run.
+    QByteArray loadCheckpoint();
+
+    // Written to database at most once per CheckpointIntervalMsecs, last one is always written.
+    void saveCheckpoint(const QByteArray &data);
+
+private:
+    void execute();
+    void flushCheckpoint();
+    void clearCheckpoint();
+    QSqlDatabase checkpointDatabase();
+
+    qint64 jobId;
+    Priority priority;
+    PoolType poolType;
+    std::atomic<int> state;
+    std::atomic<bool> isCancelled;
+
+    QElapsedTimer runTimer;
+    qint64 lastProgressMsecs;
+    qint64 doneCountAtStart; // Work skipped thanks to checkpoint doesn't count for eta
+    bool isDoneCountAtStartSet;
+
+    QByteArray pendingCheckpoint;
+    bool isCheckpointPending;
+    qint64 lastCheckpointMsecs;
+    QSqlDatabase database; // Opened on the pool thread
+};
+
+#endif // BACKGROUNDJOB_H
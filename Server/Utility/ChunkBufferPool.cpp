@@ -0,0 +1,107 @@
+#include "ChunkBufferPool.h"
+
+#include "AppConfig.h"
+#include "Logger.h"
+
+#include <QMutexLocker>
+
+ChunkBufferPool *ChunkBufferPool::instance()
+{
+    static ChunkBufferPool pool;
+    return &pool;
+}
+
+ChunkBufferPool::ChunkBufferPool()
+{
+    AppConfig config;
+    bufferSize = qBound(MinBufferSize, config.getIoChunkBufferSize(), MaxBufferSize);
+    bufferCount = qBound(1, config.getIoChunkBufferCount(), MaxBufferCount);
+    leasedCount = 0;
+    peakLeasedCount = 0;
+
+    bufferList.reserve(bufferCount);
+
+    LOG_INFO("ChunkBufferPool", QString("%1 buffers of %2 bytes, peak memory bound is %3 bytes")
+                                    .arg(bufferCount)
+                                    .arg(bufferSize)
+                                    .arg(getPeakMemoryBound()));
+}
+
+qint64 ChunkBufferPool::getBufferSize() const
+{
+    return bufferSize;
+}
+
+int ChunkBufferPool::getBufferCount() const
+{
+    return bufferCount;
+}
+
+qint64 ChunkBufferPool::getPeakMemoryBound() const
+{
+    return bufferSize * bufferCount;
+}
+
+qint64 ChunkBufferPool::getPeakMemoryUsage() const
+{
+    QMutexLocker locker(&mutex);
+    return bufferSize * peakLeasedCount;
+}
+
+int ChunkBufferPool::take()
+{
+    QMutexLocker locker(&mutex);
+
+    while(freeIndexList.isEmpty() && bufferList.size() == bufferCount)
+        bufferReleased.wait(&mutex);
+
+    int index = 0;
+
+    if(!freeIndexList.isEmpty())
+        index = freeIndexList.takeLast();
+    else
+    {
+        index = bufferList.size();
+        bufferList.append(QByteArray(bufferSize, Qt::Initialization::Uninitialized));
+    }
+
+    ++leasedCount;
+    peakLeasedCount = qMax(peakLeasedCount, leasedCount);
+
+    return index;
+}
+
+void ChunkBufferPool::give(int index)
+{
+    QMutexLocker locker(&mutex);
+
+    freeIndexList.append(index);
+    --leasedCount;
+
+    bufferReleased.wakeOne();
+}
+
+ChunkBufferPool::Lease::Lease()
+{
+    ChunkBufferPool *pool = ChunkBufferPool::instance();
+    index = pool->take();
+
+    // Elements are never removed, so the data pointer stays valid without the lock.
+    QMutexLocker locker(&pool->mutex);
+    buffer = pool->bufferList[index].data();
+}
+
+ChunkBufferPool::Lease::~Lease()
+{
+    ChunkBufferPool::instance()->give(index);
+}
+
+char *ChunkBufferPool::Lease::data()
+{
+    return buffer;
+}
+
+qint64 ChunkBufferPool::Lease::size() const
+{
+    return ChunkBufferPool::instance()->getBufferSize();
+}
@@ -6,16 +6,60 @@
 class DatabaseRegistry
 {
 public:
+    // Repositories use RETURNING (3.35) and UPDATE ... FROM (3.33).
+    static const inline QString MinSqliteVersion = "3.35.0";
+
     DatabaseRegistry();
 
+    // Version of SQLite linked by the QSQLITE driver, checked once at startup.
+    static bool isSqliteVersionSupported(QString &foundVersion);
+
+    // Read only connection, writes go through StorageWriteActor.
     static QSqlDatabase fileStorageDatabase();
+    // Connection of StorageWriteActor, nothing else writes to storage database.
+    static QSqlDatabase fileStorageWriteDatabase();
     static QSqlDatabase fileSystemEventDatabase();
+    static QSqlDatabase monitorStateDatabase();
+    static QSqlDatabase jobStateDatabase();
 
 private:
+    static const inline int FileStorageSchemaVersion = 5;
+    static const inline int MonitorStateSchemaVersion = 1;
+    static const inline int BusyTimeoutMsecs = 5000; // Checkpoints and other processes may hold the lock briefly
+
+    // Latest version state of a file can be compared without reading table rows.
+    static const inline QString FileVersionStateIndexQuery = " CREATE INDEX IF NOT EXISTS FileVersionStateIndex"
+                                                             " ON FileVersionEntity (symbol_file_path, version_number,"
+                                                             "                       size, last_modified_ns, inode);";
+
+    // Repacker finds versions of a pack without scanning the table.
+    static const inline QString FileVersionPackIndexQuery = " CREATE INDEX IF NOT EXISTS FileVersionPackIndex"
+                                                            " ON FileVersionEntity (pack_file_name)"
+                                                            " WHERE pack_file_name IS NOT NULL;";
+
+    // Scrub visits never verified versions first (nulls sort first), then the ones verified longest ago.
+    static const inline QString FileVersionVerifyIndexQuery = " CREATE INDEX IF NOT EXISTS FileVersionVerifyIndex"
+                                                              " ON FileVersionEntity (last_verified_at);";
+
+    // Content of inline versions is kept aside, so listing versions doesn't read it.
+    static const inline QString FileVersionContentTableQuery = " CREATE TABLE IF NOT EXISTS FileVersionContent ("
+                                                               " internal_file_name TEXT NOT NULL PRIMARY KEY,"
+                                                               " content BLOB NOT NULL,"
+                                                               " FOREIGN KEY (internal_file_name) REFERENCES FileVersionEntity (internal_file_name)"
+                                                               " ON DELETE CASCADE ON UPDATE CASCADE"
+                                                               ");";
+
+    static QSqlDatabase openFileStorageConnection();
     static void createDbFileStorage();
+    static void upgradeDbFileStorage();
+    static bool upgradeFileVersionTimestamps();
     static void createDbFileMonitor();
+    static void createDbMonitorState();
+    static void createDbJobState();
     static QSqlDatabase dbFileStorage;
     static QSqlDatabase dbFileMonitor;
+    static QSqlDatabase dbMonitorState;
+    static QSqlDatabase dbJobState;
 };
 
 #endif // DATABASEREGISTRY_H
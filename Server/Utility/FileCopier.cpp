@@ -0,0 +1,172 @@
+#include "FileCopier.h"
+
+#include "Logger.h"
+#include "ChunkBufferPool.h"
+
+#include <QFile>
+
+#ifdef Q_OS_LINUX
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/sendfile.h>
+#include <linux/fs.h>
+#endif
+
+#ifdef Q_OS_LINUX
+// Explicit offsets are used, so QFile's idea of file positions stays valid for the fallback.
+static bool copyWithCopyFileRange(int sourceFd, int destinationFd, IoScheduler::Budget budget)
+{
+    loff_t sourceOffset = 0;
+    loff_t destinationOffset = 0;
+
+    while(true)
+    {
+        ssize_t copiedCount = ::copy_file_range(sourceFd, &sourceOffset,
+                                                destinationFd, &destinationOffset,
+                                                FileCopier::KernelCopyChunkSize, 0);
+
+        if(copiedCount < 0)
+            return false;
+
+        if(copiedCount == 0)
+            return true;
+
+        IoScheduler::instance()->acquire(budget, copiedCount);
+    }
+}
+
+static bool copyWithSendFile(int sourceFd, int destinationFd, IoScheduler::Budget budget)
+{
+    off_t sourceOffset = 0;
+    bool result = true;
+
+    while(result)
+    {
+        ssize_t copiedCount = ::sendfile(destinationFd, sourceFd, &sourceOffset, FileCopier::KernelCopyChunkSize);
+
+        if(copiedCount < 0)
+            result = false;
+
+        if(copiedCount <= 0)
+            break;
+
+        IoScheduler::instance()->acquire(budget, copiedCount);
+    }
+
+    // sendfile() moves offset of destination, it is put back for the next strategy.
+    if(!result)
+        ::lseek(destinationFd, 0, SEEK_SET);
+
+    return result;
+}
+#endif
+
+static bool copyInUserspace(QFile &source, QFile &destination, IoScheduler::Budget budget)
+{
+    ChunkBufferPool::Lease buffer;
+    bool result = true;
+
+    while(result)
+    {
+        qint64 readCount = source.read(buffer.data(), buffer.size());
+
+        if(readCount < 0)
+            result = false;
+
+        if(readCount <= 0)
+            break;
+
+        IoScheduler::instance()->acquire(budget, readCount);
+        result = (destination.write(buffer.data(), readCount) == readCount);
+    }
+
+    return result;
+}
+
+bool FileCopier::copyFile(const QString &sourceFilePath,
+                          const QString &destinationFilePath,
+                          IoScheduler::Budget budget,
+                          Strategy *usedStrategy)
+{
+    bool result = false;
+    Strategy strategy = Strategy::None;
+
+    QFile source(sourceFilePath);
+    QFile destination(destinationFilePath);
+
+    if(usedStrategy != nullptr)
+        *usedStrategy = strategy;
+
+    if(!source.open(QFile::OpenModeFlag::ReadOnly | QFile::OpenModeFlag::Unbuffered))
+        return false;
+
+    if(!destination.open(QFile::OpenModeFlag::WriteOnly | QFile::OpenModeFlag::NewOnly | QFile::OpenModeFlag::Unbuffered))
+        return false;
+
+#ifdef Q_OS_LINUX
+    int sourceFd = source.handle();
+    int destinationFd = destination.handle();
+
+#ifdef FICLONE
+    if(::ioctl(destinationFd, FICLONE, sourceFd) == 0)
+    {
+        result = true;
+        strategy = Strategy::Reflink;
+    }
+#endif
+
+    if(!result && copyWithCopyFileRange(sourceFd, destinationFd, budget))
+    {
+        result = true;
+        strategy = Strategy::CopyFileRange;
+    }
+
+    // Each failed strategy may leave partial data behind.
+    if(!result && destination.resize(0) && copyWithSendFile(sourceFd, destinationFd, budget))
+    {
+        result = true;
+        strategy = Strategy::SendFile;
+    }
+#endif
+
+    if(!result && destination.resize(0) && destination.seek(0) && source.seek(0))
+    {
+        result = copyInUserspace(source, destination, budget);
+        strategy = Strategy::Userspace;
+    }
+
+    if(result)
+        result = destination.setPermissions(source.permissions());
+
+    destination.close();
+
+    if(!result)
+    {
+        destination.remove();
+        strategy = Strategy::None;
+    }
+
+    LOG_TRACE("FileCopier", QString("%1 -> %2 copied with %3").arg(sourceFilePath, destinationFilePath, strategyName(strategy)));
+
+    if(usedStrategy != nullptr)
+        *usedStrategy = strategy;
+
+    return result;
+}
+
+QString FileCopier::strategyName(Strategy strategy)
+{
+    switch(strategy)
+    {
+        case Strategy::Reflink:
+            return "reflink";
+        case Strategy::CopyFileRange:
+            return "copy_file_range";
+        case Strategy::SendFile:
+            return "sendfile";
+        case Strategy::Userspace:
+            return "userspace";
+        default:
+            return "none";
+    }
+}
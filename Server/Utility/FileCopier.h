@@ -0,0 +1,33 @@
+#ifndef FILECOPIER_H
+#define FILECOPIER_H
+
+#include "IoScheduler.h"
+
+#include <QString>
+
+// Copies files with the cheapest mechanism the platform and file system offer.
+// Tries reflink first, then in kernel copies, and falls back to a chunked userspace copy.
+class FileCopier
+{
+public:
+    enum Strategy
+    {
+        None,
+        Reflink,       // Shares extents on copy on write file systems, no data is moved
+        CopyFileRange, // Data is copied by the kernel
+        SendFile,      // Data is copied by the kernel, for kernels without copy_file_range
+        Userspace      // Chunked through a ChunkBufferPool buffer
+    };
+
+    static const inline qint64 KernelCopyChunkSize = 8388608; // 8 MiB
+
+    // Fails when destination exists, like QFile::copy(). Moved bytes are charged to budget.
+    static bool copyFile(const QString &sourceFilePath,
+                         const QString &destinationFilePath,
+                         IoScheduler::Budget budget,
+                         Strategy *usedStrategy = nullptr);
+
+    static QString strategyName(Strategy strategy);
+};
+
+#endif // FILECOPIER_H
@@ -0,0 +1,63 @@
+#ifndef IOSCHEDULER_H
+#define IOSCHEDULER_H
+
+#include <QMutex>
+#include <QElapsedTimer>
+
+// Rate limits reads and writes of the storage folder.
+// Foreground (restores the user waits for) and background (backups, exports) have separate token buckets.
+class IoScheduler
+{
+public:
+    enum Budget
+    {
+        Foreground = 0,
+        Background = 1
+    };
+
+    static IoScheduler *instance();
+
+    // Limits are in bytes per second, 0 means unlimited. Values follow AppConfig.
+    qint64 getBandwidthLimit(Budget budget) const;
+    void setBandwidthLimit(Budget budget, qint64 bytesPerSecond);
+
+    // Blocks calling thread until byteCount bytes fit into the budget.
+    void acquire(Budget budget, qint64 byteCount);
+
+    // Bytes per second moved in the last complete second.
+    qint64 getThroughput(Budget budget) const;
+
+    // Lowers I/O priority of the calling thread to idle for its lifetime on Linux, when enabled in AppConfig.
+    class BackgroundScope
+    {
+    public:
+        BackgroundScope();
+        ~BackgroundScope();
+
+    private:
+        int previousPriority; // -1 when priority wasn't changed
+    };
+
+private:
+    struct Bucket
+    {
+        qint64 bytesPerSecond = 0;
+        double tokens = 0;
+        qint64 lastRefillNsecs = 0;
+
+        qint64 windowStartNsecs = 0;
+        qint64 windowBytes = 0;
+        qint64 lastThroughput = 0;
+    };
+
+    IoScheduler();
+
+    void refill(Bucket &bucket, qint64 nowNsecs);
+    void record(Bucket &bucket, qint64 byteCount, qint64 nowNsecs);
+
+    mutable QMutex mutex;
+    QElapsedTimer clock;
+    Bucket bucketList[2];
+};
+
+#endif // IOSCHEDULER_H
@@ -0,0 +1,154 @@
+#include "JobScheduler.h"
+
+#include "Logger.h"
+
+#include <QMutexLocker>
+
+JobScheduler *JobScheduler::instance()
+{
+    static JobScheduler scheduler;
+    return &scheduler;
+}
+
+JobScheduler::JobScheduler()
+    : QObject{nullptr},
+      nextJobId(1)
+{
+    qRegisterMetaType<BackgroundJob::State>("BackgroundJob::State");
+
+    ioPool.setMaxThreadCount(IoThreadCount);
+    cpuPool.setMaxThreadCount(QThread::idealThreadCount());
+}
+
+qint64 JobScheduler::submit(QSharedPointer<BackgroundJob> job)
+{
+    QMutexLocker locker(&mutex);
+
+    qint64 jobId = nextJobId++;
+    job->jobId = jobId;
+    job->state = BackgroundJob::State::Queued;
+
+    // Runnable keeps the job alive until it returns, even after it is removed from the table.
+    QRunnable *runnable = QRunnable::create([job]{
+        job->execute();
+    });
+
+    jobTable.insert(jobId, job);
+    queuedRunnableTable.insert(jobId, runnable);
+    progressTable.insert(jobId, Progress());
+
+    poolOf(*job)->start(runnable, job->getPriority());
+
+    LOG_DEBUG("JobScheduler", QString("Job %1 queued with priority %2").arg(jobId).arg(job->getPriority()));
+
+    return jobId;
+}
+
+bool JobScheduler::cancel(qint64 jobId)
+{
+    QMutexLocker locker(&mutex);
+
+    QSharedPointer<BackgroundJob> job = jobTable.value(jobId);
+
+    if(job.isNull())
+        return false;
+
+    job->isCancelled = true;
+
+    QRunnable *runnable = queuedRunnableTable.take(jobId);
+
+    // If runnable is already picked by a thread, job sees the flag instead.
+    if(runnable != nullptr && poolOf(*job)->tryTake(runnable))
+    {
+        delete runnable;
+
+        job->state = BackgroundJob::State::Cancelled;
+        jobTable.remove(jobId);
+        progressTable.remove(jobId);
+
+        locker.unlock();
+        emit signalJobFinished(jobId, BackgroundJob::State::Cancelled);
+    }
+
+    return true;
+}
+
+void JobScheduler::cancelAll()
+{
+    QList<qint64> jobIdList;
+
+    {
+        QMutexLocker locker(&mutex);
+        jobIdList = jobTable.keys();
+    }
+
+    for(qint64 jobId : jobIdList)
+        cancel(jobId);
+}
+
+JobScheduler::Progress JobScheduler::getProgress(qint64 jobId) const
+{
+    QMutexLocker locker(&mutex);
+    return progressTable.value(jobId);
+}
+
+void JobScheduler::waitForDone()
+{
+    ioPool.waitForDone();
+    cpuPool.waitForDone();
+}
+
+QThreadPool *JobScheduler::poolOf(const BackgroundJob &job)
+{
+    if(job.getPoolType() == BackgroundJob::PoolType::Cpu)
+        return &cpuPool;
+    else
+        return &ioPool;
+}
+
+void JobScheduler::onJobStarted(qint64 jobId)
+{
+    QMutexLocker locker(&mutex);
+
+    queuedRunnableTable.remove(jobId);
+
+    auto iterator = progressTable.find(jobId);
+    if(iterator != progressTable.end())
+        iterator->state = BackgroundJob::State::Running;
+}
+
+void JobScheduler::onJobProgress(BackgroundJob &job, qint64 doneCount, qint64 totalCount, qint64 remainingMsecs)
+{
+    {
+        QMutexLocker locker(&mutex);
+
+        auto iterator = progressTable.find(job.getJobId());
+        if(iterator != progressTable.end())
+        {
+            iterator->doneCount = doneCount;
+            iterator->totalCount = totalCount;
+            iterator->elapsedMsecs = job.runTimer.elapsed();
+            iterator->remainingMsecs = remainingMsecs;
+        }
+    }
+
+    emit signalJobProgress(job.getJobId(), doneCount, totalCount, remainingMsecs);
+}
+
+void JobScheduler::onJobFinished(BackgroundJob &job)
+{
+    qint64 jobId = job.getJobId();
+    BackgroundJob::State state = job.getState();
+
+    {
+        QMutexLocker locker(&mutex);
+
+        queuedRunnableTable.remove(jobId);
+        progressTable.remove(jobId);
+        jobTable.remove(jobId); // Runnable still holds a reference
+    }
+
+    LOG_DEBUG("JobScheduler", QString("Job %1 finished with state %2").arg(jobId).arg(state));
+
+    emit signalJobFinished(jobId, state);
+}
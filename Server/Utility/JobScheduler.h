@@ -0,0 +1,68 @@
+#ifndef JOBSCHEDULER_H
+#define JOBSCHEDULER_H
+
+#include "BackgroundJob.h"
+
+#include <QHash>
+#include <QMutex>
+#include <QObject>
+#include <QRunnable>
+#include <QThreadPool>
+#include <QSharedPointer>
+
+// Runs background jobs by priority on a small I/O pool and a cpu sized pool, shared by gui and server.
+class JobScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Progress
+    {
+        BackgroundJob::State state = BackgroundJob::State::Queued;
+        qint64 doneCount = 0;
+        qint64 totalCount = 0;
+        qint64 elapsedMsecs = 0;
+        qint64 remainingMsecs = -1; // -1 while not estimated yet
+    };
+
+    // Disk bound jobs slow each other down when too many run at once.
+    static const inline int IoThreadCount = 2;
+
+    static JobScheduler *instance();
+
+    // Returns id of the queued job.
+    qint64 submit(QSharedPointer<BackgroundJob> job);
+
+    // Queued jobs are dropped, running jobs stop at their next cancellation check.
+    bool cancel(qint64 jobId);
+    void cancelAll();
+
+    Progress getProgress(qint64 jobId) const;
+
+    // Blocks until all started jobs return.
+    void waitForDone();
+
+signals:
+    void signalJobProgress(qint64 jobId, qint64 doneCount, qint64 totalCount, qint64 remainingMsecs);
+    void signalJobFinished(qint64 jobId, BackgroundJob::State state);
+
+private:
+    friend class BackgroundJob;
+
+    JobScheduler();
+
+    QThreadPool *poolOf(const BackgroundJob &job);
+    void onJobStarted(qint64 jobId);
+    void onJobProgress(BackgroundJob &job, qint64 doneCount, qint64 totalCount, qint64 remainingMsecs);
+    void onJobFinished(BackgroundJob &job);
+
+    QThreadPool ioPool;
+    QThreadPool cpuPool;
+    mutable QMutex mutex;
+    qint64 nextJobId;
+    QHash<qint64, QSharedPointer<BackgroundJob>> jobTable;
+    QHash<qint64, QRunnable *> queuedRunnableTable;
+    QHash<qint64, Progress> progressTable;
+};
+
+#endif // JOBSCHEDULER_H
@@ -0,0 +1,109 @@
+#ifndef LOGGER_H
+#define LOGGER_H
+
+#include <array>
+#include <atomic>
+#include <thread>
+
+#include <QString>
+
+// Log calls below this level are removed at compile time.
+// 0 = trace, 1 = debug, 2 = info, 3 = warning, 4 = error
+#ifndef LOGGER_COMPILED_MIN_LEVEL
+#define LOGGER_COMPILED_MIN_LEVEL 1
+#endif
+
+// Message expression is only evaluated when level is enabled at runtime.
+#define LOGGER_WRITE(level, category, message) \
+    do { if(Logger::isEnabled(level)) Logger::write(level, category, message); } while(false)
+
+#if LOGGER_COMPILED_MIN_LEVEL <= 0
+#define LOG_TRACE(category, message) LOGGER_WRITE(Logger::Level::Trace, category, message)
+#else
+#define LOG_TRACE(category, message) do {} while(false)
+#endif
+
+#if LOGGER_COMPILED_MIN_LEVEL <= 1
+#define LOG_DEBUG(category, message) LOGGER_WRITE(Logger::Level::Debug, category, message)
+#else
+#define LOG_DEBUG(category, message) do {} while(false)
+#endif
+
+#if LOGGER_COMPILED_MIN_LEVEL <= 2
+#define LOG_INFO(category, message) LOGGER_WRITE(Logger::Level::Info, category, message)
+#else
+#define LOG_INFO(category, message) do {} while(false)
+#endif
+
+#if LOGGER_COMPILED_MIN_LEVEL <= 3
+#define LOG_WARNING(category, message) LOGGER_WRITE(Logger::Level::Warning, category, message)
+#else
+#define LOG_WARNING(category, message) do {} while(false)
+#endif
+
+#define LOG_ERROR(category, message) LOGGER_WRITE(Logger::Level::Error, category, message)
+
+// Records are queued into a bounded lock-free ring and written to stderr by a background thread.
+// Callers never block on I/O; when the ring is full the record is dropped and counted.
+class Logger
+{
+public:
+    enum Level
+    {
+        Trace = 0,
+        Debug = 1,
+        Info = 2,
+        Warning = 3,
+        Error = 4
+    };
+
+    static const inline quint64 RingCapacity = 8192; // Must be power of 2
+
+    static bool isEnabled(Level level);
+    static void write(Level level, const char *category, const QString &message);
+
+    static Level getMinimumLevel();
+    static void setMinimumLevel(Level level);
+
+    static qlonglong droppedRecordCount();
+
+    // Blocks until every record queued before the call is written.
+    static void flush();
+
+private:
+    struct Record
+    {
+        Level level = Level::Debug;
+        const char *category = "";
+        QString message;
+        qint64 timestamp = 0;
+    };
+
+    struct Slot
+    {
+        std::atomic<quint64> sequence;
+        Record record;
+    };
+
+    Logger();
+    ~Logger();
+
+    static Logger *instance();
+
+    bool tryPush(Record &&record);
+    bool tryPop(Record &record);
+    void writerLoop();
+    int writeQueuedRecords();
+
+    std::array<Slot, RingCapacity> ring;
+    alignas(64) std::atomic<quint64> enqueuePosition;
+    alignas(64) std::atomic<quint64> dequeuePosition;
+    std::atomic<quint64> writtenPosition;
+
+    std::atomic_int minimumLevel;
+    std::atomic<qlonglong> droppedRecords;
+    std::atomic_bool isRunning;
+    std::thread writerThread;
+};
+
+#endif // LOGGER_H
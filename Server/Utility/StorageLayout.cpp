@@ -0,0 +1,79 @@
+#include "StorageLayout.h"
+
+#include "FileCopier.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+
+QString StorageLayout::shardedRelativePath(const QString &internalFileName)
+{
+    // Too short names can't be sharded, they stay in root.
+    if(internalFileName.size() <= ShardPrefixLength * ShardLevelCount)
+        return internalFileName;
+
+    QString result;
+
+    for(int level = 0; level < ShardLevelCount; level++)
+        result += internalFileName.mid(level * ShardPrefixLength, ShardPrefixLength).toLower() + "/";
+
+    result += internalFileName;
+    return result;
+}
+
+QString StorageLayout::resolveFilePath(const QString &storageFolderPath, const QString &internalFileName)
+{
+    // Flat file is only removed once its sharded copy is complete, a sharded file next to it may be partial.
+    QString flatPath = storageFolderPath + internalFileName;
+
+    if(QFile::exists(flatPath))
+        return flatPath;
+
+    return storageFolderPath + shardedRelativePath(internalFileName);
+}
+
+QString StorageLayout::prepareFilePath(const QString &storageFolderPath, const QString &internalFileName)
+{
+    QString result = storageFolderPath + shardedRelativePath(internalFileName);
+    QDir().mkpath(QFileInfo(result).path());
+
+    return result;
+}
+
+QStringList StorageLayout::listFlatFileNames(const QString &storageFolderPath)
+{
+    QDir storageFolder(storageFolderPath);
+    return storageFolder.entryList({"*.file"}, QDir::Filter::Files | QDir::Filter::Hidden);
+}
+
+bool StorageLayout::moveToShard(const QString &storageFolderPath, const QString &internalFileName)
+{
+    QString flatPath = storageFolderPath + internalFileName;
+    QString shardedPath = prepareFilePath(storageFolderPath, internalFileName);
+
+    if(flatPath == shardedPath)
+        return true;
+
+    // Left by a move interrupted before the flat file was removed, it is never read while the flat file exists.
+    if(QFile::exists(shardedPath) && !QFile::remove(shardedPath))
+        return false;
+
+    // Unlike QFile::rename() it never falls back to a copy, the file appears in its shard complete or not at all.
+    if(QDir().rename(flatPath, shardedPath))
+        return true;
+
+    // Shard is on another file system, the copy gets its final name only once it is complete.
+    QString partialPath = shardedPath + PartialFileSuffix;
+    QFile::remove(partialPath);
+
+    bool result = FileCopier::copyFile(flatPath, partialPath, IoScheduler::Budget::Background) &&
+                  QDir().rename(partialPath, shardedPath);
+
+    if(!result)
+    {
+        QFile::remove(partialPath);
+        return false;
+    }
+
+    return QFile::remove(flatPath);
+}
@@ -0,0 +1,34 @@
+#ifndef STORAGELAYOUT_H
+#define STORAGELAYOUT_H
+
+#include <QString>
+#include <QStringList>
+
+// Places version files of the storage folder into two levels of sub folders by name prefix.
+// e.g. 0123abcd....file is stored as 01/23/0123abcd....file
+// Stores created by older versions keep files flat in the root until StorageShardMigrationJob moves them.
+class StorageLayout
+{
+public:
+    static const inline int ShardPrefixLength = 2;
+    static const inline int ShardLevelCount = 2;
+    static const inline QString PartialFileSuffix = ".part"; // Copy into a shard which isn't complete yet
+
+    // Path of file relative to storage folder in the sharded layout.
+    static QString shardedRelativePath(const QString &internalFileName);
+
+    // Returns where the file currently is, flat while it exists, sharded otherwise. Safe to call while the file is being migrated.
+    static QString resolveFilePath(const QString &storageFolderPath, const QString &internalFileName);
+
+    // Creates the shard folder and returns the path new file should be written to.
+    static QString prepareFilePath(const QString &storageFolderPath, const QString &internalFileName);
+
+    // Version files still sitting in the root of storage folder.
+    static QStringList listFlatFileNames(const QString &storageFolderPath);
+
+    // Moves a flat file into its shard with an atomic rename, so readers never see a partial file.
+    // Across file systems it is copied under a temporary name, renamed, and only then the flat file is removed.
+    static bool moveToShard(const QString &storageFolderPath, const QString &internalFileName);
+};
+
+#endif // STORAGELAYOUT_H
@@ -0,0 +1,23 @@
+#ifndef STORAGESHARDMIGRATIONJOB_H
+#define STORAGESHARDMIGRATIONJOB_H
+
+#include "BackgroundJob.h"
+
+// Moves version files of a store created with the flat layout into their shards.
+// Files stay readable during the move because StorageLayout::resolveFilePath() looks at both places.
+class StorageShardMigrationJob : public BackgroundJob
+{
+public:
+    static const inline int MoveThreadCount = 4;
+    static const inline int BatchSize = 256;
+
+    StorageShardMigrationJob(const QString &storageFolderPath);
+
+protected:
+    bool run() override;
+
+private:
+    QString storageFolderPath;
+};
+
+#endif // STORAGESHARDMIGRATIONJOB_H
@@ -0,0 +1,56 @@
+#ifndef STORAGEWRITEACTOR_H
+#define STORAGEWRITEACTOR_H
+
+#include <atomic>
+#include <functional>
+
+#include <QThread>
+#include <QSemaphore>
+#include <QSqlDatabase>
+
+// Owns the only connection which writes to the storage database, on a thread of its own.
+// Commands are pushed to a lock free stack and committed together in one transaction,
+// readers keep reading WAL snapshots meanwhile.
+class StorageWriteActor
+{
+public:
+    using Command = std::function<bool(QSqlDatabase &database)>;
+
+    static const inline int MaxBatchSize = 256;
+
+    static StorageWriteActor *instance();
+
+    // Blocks until the batch of command is committed. Changes of a command returning false are rolled back alone.
+    bool execute(const Command &command);
+
+    // Commits queued commands and stops the thread, commands executed afterwards fail. Later calls only wait.
+    void stop();
+
+private:
+    // Lives on the stack of the executing thread until done is released.
+    struct PendingCommand
+    {
+        Command command;
+        bool result = false;
+        QSemaphore done;
+        PendingCommand *next = nullptr;
+    };
+
+    StorageWriteActor();
+    ~StorageWriteActor();
+
+    void runLoop();
+    QList<PendingCommand *> takeQueued();
+    void commitBatch(const QList<PendingCommand *> &batch);
+    bool runInSavepoint(const Command &command);
+
+    QThread *thread;
+    QSqlDatabase database; // Used by thread only
+    std::atomic<PendingCommand *> queueHead; // Newest command first
+    QSemaphore commandQueued; // Released once per pushed command
+    std::atomic_int activeProducerCount; // Threads between the stop check and their push
+    std::atomic_bool isStopRequested;
+    std::atomic_bool isClosed; // Set when nothing can be pushed anymore
+};
+
+#endif // STORAGEWRITEACTOR_H
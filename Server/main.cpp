@@ -1,6 +1,6 @@
 #include <QCoreApplication>
 #include <QDir>
-#include <QDebug>
+#include <QTimer>
 #include <QTcpServer>
 #include <QJsonObject>
 #include <QJsonDocument>
@@ -9,6 +9,14 @@
 #include <QtHttpServer/QHttpServerResponse>
 
 #include "Utility/AppConfig.h"
+#include "Utility/AppConfigNotifier.h"
+#include "Utility/Logger.h"
+#include "Utility/DatabaseRegistry.h"
+#include "Utility/JobScheduler.h"
+#include "Utility/StorageWriteActor.h"
+#include "Utility/StorageShardMigrationJob.h"
+#include "FileStorageSubSystem/PackRepackJob.h"
+#include "FileStorageSubSystem/StorageGarbageCollectJob.h"
 #include "RestApi/FileStorageController.h"
 #include "RestApi/ZipExportController.h"
 #include "RestApi/ZipImportController.h"
@@ -18,6 +26,17 @@ int main(int argc, char *argv[])
 {
     QCoreApplication a(argc, argv);
 
+    QString sqliteVersion;
+
+    if(!DatabaseRegistry::isSqliteVersionSupported(sqliteVersion))
+    {
+        LOG_ERROR("Server", QString("SQLite %1 or newer is required, the Qt SQLite driver uses %2")
+                                .arg(DatabaseRegistry::MinSqliteVersion, sqliteVersion.isEmpty() ? "none" : sqliteVersion));
+        return -1;
+    }
+
+    AppConfigNotifier::instance()->startWatching();
+
     QString storagePath = QStandardPaths::writableLocation(QStandardPaths::StandardLocation::HomeLocation);
     storagePath = QDir::toNativeSeparators(storagePath) + QDir::separator();
     storagePath += "nesync_server_";
@@ -27,6 +46,28 @@ int main(int argc, char *argv[])
     QDir().mkpath(storagePath);
     AppConfig().setStorageFolderPath(storagePath);
 
+    auto migrationJobId = QSharedPointer<qint64>::create(-1);
+
+    // Collector skips stores which still have flat files, so it is submitted once migration finishes.
+    // Files left behind by interrupted writes and deletes are removed. Connected first, migration may finish quickly.
+    QObject::connect(JobScheduler::instance(), &JobScheduler::signalJobFinished,
+                     JobScheduler::instance(), [migrationJobId, storagePath](qint64 jobId, BackgroundJob::State state) {
+        if(jobId != *migrationJobId || state == BackgroundJob::State::Cancelled) // Cancelled at exit
+            return;
+
+        *migrationJobId = -1;
+        JobScheduler::instance()->submit(QSharedPointer<StorageGarbageCollectJob>::create(storagePath));
+    });
+
+    // Stores created with the flat layout are sharded in the background, files stay usable meanwhile.
+    *migrationJobId = JobScheduler::instance()->submit(QSharedPointer<StorageShardMigrationJob>::create(storagePath));
+
+    // Space of deleted versions is reclaimed periodically, also deletes packs whose grace period passed.
+    QTimer repackTimer;
+    QObject::connect(&repackTimer, &QTimer::timeout, &repackTimer, [] { PackRepackJob::submitIfIdle(); });
+    repackTimer.start(PackRepackJob::RepackIntervalMsecs);
+    PackRepackJob::submitIfIdle();
+
     QTcpServer tcpServer;
     QHttpServer httpServer;
     FileStorageController storageController;
@@ -67,6 +108,10 @@ int main(int argc, char *argv[])
         return storageController.getFileByUserPath(request);
     });
 
+    httpServer.route("/file/version/inlineContent", QHttpServerRequest::Method::Post, [&storageController](const QHttpServerRequest &request) {
+        return storageController.getInlineVersionContent(request);
+    });
+
     httpServer.route("/file/append", QHttpServerRequest::Method::Post, [&storageController](const QHttpServerRequest &request) {
         return storageController.appendVersion(request);
     });
@@ -75,6 +120,14 @@ int main(int argc, char *argv[])
         return storageController.deleteFile(request);
     });
 
+    httpServer.route("/storage/scrub/start", QHttpServerRequest::Method::Post, [&storageController](const QHttpServerRequest &request) {
+        return storageController.startIntegrityScrub(request);
+    });
+
+    httpServer.route("/storage/scrub/status", QHttpServerRequest::Method::Get, [&storageController](const QHttpServerRequest &request) {
+        return storageController.getIntegrityScrubStatus(request);
+    });
+
     httpServer.route("/monitor/new", QHttpServerRequest::Method::Get, [&fsMonitorController](const QHttpServerRequest &request) {
         return fsMonitorController.newAddedItems(request);
     });
@@ -147,13 +200,19 @@ int main(int argc, char *argv[])
     tcpServer.listen(QHostAddress::SpecialAddress::LocalHost, targetPort);
 
     if (tcpServer.isListening() && httpServer.bind(&tcpServer))
-        qDebug() << "running on = " << "localhost:" + QString::number(targetPort);
+        LOG_INFO("Server", "running on = localhost:" + QString::number(targetPort));
     else
     {
-        qWarning() << QCoreApplication::translate("QHttpServerExample",
-                                                  "Server failed to listen on a port.");
+        LOG_ERROR("Server", QCoreApplication::translate("QHttpServerExample",
+                                                        "Server failed to listen on a port."));
         return -1;
     }
 
-    return a.exec();
+    int result = a.exec();
+
+    JobScheduler::instance()->cancelAll();
+    JobScheduler::instance()->waitForDone();
+    StorageWriteActor::instance()->stop();
+
+    return result;
 }
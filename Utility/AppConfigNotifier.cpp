@@ -0,0 +1,53 @@
+#include "AppConfigNotifier.h"
+
+#include "AppConfig.h"
+
+#include <QFile>
+#include <QFileInfo>
+
+AppConfigNotifier *AppConfigNotifier::instance()
+{
+    static AppConfigNotifier notifier;
+    return &notifier;
+}
+
+AppConfigNotifier::AppConfigNotifier()
+    : QObject{nullptr},
+      watcher(nullptr),
+      reloadTimer(nullptr)
+{
+}
+
+void AppConfigNotifier::startWatching()
+{
+    if(watcher != nullptr)
+        return;
+
+    QString settingsFilePath = AppConfig::settingsFilePath();
+
+    // Parentless, the notifier may live in another thread than the caller.
+    watcher = new QFileSystemWatcher();
+    reloadTimer = new QTimer();
+    reloadTimer->setSingleShot(true);
+    reloadTimer->setInterval(ReloadDelayMsecs);
+
+    // Folder is watched too, saving by rename replaces the watched file and creating it isn't reported otherwise.
+    watcher->addPath(QFileInfo(settingsFilePath).absolutePath());
+
+    if(QFile::exists(settingsFilePath))
+        watcher->addPath(settingsFilePath);
+
+    QObject::connect(watcher, &QFileSystemWatcher::fileChanged, reloadTimer, qOverload<>(&QTimer::start));
+    QObject::connect(watcher, &QFileSystemWatcher::directoryChanged, reloadTimer, qOverload<>(&QTimer::start));
+    QObject::connect(reloadTimer, &QTimer::timeout, reloadTimer, [this] { onReloadTimeout(); });
+}
+
+void AppConfigNotifier::onReloadTimeout()
+{
+    QString settingsFilePath = AppConfig::settingsFilePath();
+
+    if(!watcher->files().contains(settingsFilePath) && QFile::exists(settingsFilePath))
+        watcher->addPath(settingsFilePath);
+
+    AppConfig::reload();
+}
@@ -0,0 +1,34 @@
+#ifndef APPCONFIGNOTIFIER_H
+#define APPCONFIGNOTIFIER_H
+
+#include <QTimer>
+#include <QObject>
+#include <QFileSystemWatcher>
+
+// Tells which settings changed, whether by an AppConfig setter or by editing settings.ini outside the app.
+// Signal is emitted in the thread making the change, slots must be thread safe or connected with a context object.
+class AppConfigNotifier : public QObject
+{
+    Q_OBJECT
+
+public:
+    static const inline int ReloadDelayMsecs = 200; // Editors save in several steps
+
+    static AppConfigNotifier *instance();
+
+    // Watching runs in the event loop of the calling thread, main() calls it once the application exists.
+    void startWatching();
+
+signals:
+    void signalValueChanged(const QString &key);
+
+private:
+    AppConfigNotifier();
+
+    void onReloadTimeout();
+
+    QFileSystemWatcher *watcher;
+    QTimer *reloadTimer;
+};
+
+#endif // APPCONFIGNOTIFIER_H
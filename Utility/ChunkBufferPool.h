@@ -0,0 +1,65 @@
+#ifndef CHUNKBUFFERPOOL_H
+#define CHUNKBUFFERPOOL_H
+
+#include <QList>
+#include <QMutex>
+#include <QByteArray>
+#include <QWaitCondition>
+
+// Fixed set of reusable buffers shared by every streaming copy.
+// Callers block while all buffers are leased, so copy buffers never take more than getPeakMemoryBound() bytes.
+class ChunkBufferPool
+{
+public:
+    static const inline qint64 DefaultBufferSize = 4194304; // 4 MiB
+    static const inline int DefaultBufferCount = 4;
+
+    static const inline qint64 MinBufferSize = 65536; // 64 KiB
+    static const inline qint64 MaxBufferSize = 67108864; // 64 MiB
+    static const inline int MaxBufferCount = 64;
+
+    // Holds one buffer of the pool for its lifetime.
+    class Lease
+    {
+    public:
+        Lease();
+        ~Lease();
+
+        char *data();
+        qint64 size() const;
+
+    private:
+        Q_DISABLE_COPY(Lease)
+
+        int index;
+        char *buffer;
+    };
+
+    static ChunkBufferPool *instance();
+
+    qint64 getBufferSize() const;
+    int getBufferCount() const;
+
+    // Upper limit of memory held by the pool.
+    qint64 getPeakMemoryBound() const;
+
+    // Highest memory held at once since startup.
+    qint64 getPeakMemoryUsage() const;
+
+private:
+    ChunkBufferPool();
+
+    int take();
+    void give(int index);
+
+    mutable QMutex mutex;
+    QWaitCondition bufferReleased;
+    QList<QByteArray> bufferList; // Allocated on first demand, never freed
+    QList<int> freeIndexList;
+    qint64 bufferSize;
+    int bufferCount;
+    int leasedCount;
+    int peakLeasedCount;
+};
+
+#endif // CHUNKBUFFERPOOL_H
@@ -4,18 +4,67 @@
 
 #include <QDir>
 #include <QUuid>
+#include <QDateTime>
 #include <QSqlQuery>
 #include <QSqlError>
+#include <QVersionNumber>
 
 QSqlDatabase DatabaseRegistry::dbFileStorage;
 QSqlDatabase DatabaseRegistry::dbFileMonitor;
+QSqlDatabase DatabaseRegistry::dbMonitorState;
+QSqlDatabase DatabaseRegistry::dbJobState;
 
 DatabaseRegistry::DatabaseRegistry()
 {
 
 }
 
+bool DatabaseRegistry::isSqliteVersionSupported(QString &foundVersion)
+{
+    QString connectionName = "sqlite_version_check";
+
+    {
+        QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", connectionName);
+        db.setDatabaseName(":memory:");
+
+        if(db.open())
+        {
+            QSqlQuery query(db);
+
+            if(query.exec("SELECT sqlite_version();") && query.next())
+                foundVersion = query.value(0).toString();
+        }
+
+        db.close();
+    }
+
+    QSqlDatabase::removeDatabase(connectionName);
+
+    if(foundVersion.isEmpty())
+        return false;
+
+    return QVersionNumber::fromString(foundVersion) >= QVersionNumber::fromString(MinSqliteVersion);
+}
+
 QSqlDatabase DatabaseRegistry::fileStorageDatabase()
+{
+    QSqlDatabase result = openFileStorageConnection();
+    result.exec("PRAGMA query_only = ON;");
+
+    return result;
+}
+
+QSqlDatabase DatabaseRegistry::fileStorageWriteDatabase()
+{
+    QSqlDatabase result = openFileStorageConnection();
+
+    // Commits aren't synced one by one in WAL mode, a power loss may only drop the last batches.
+    result.exec("PRAGMA synchronous = NORMAL;");
+
+    return result;
+}
+
+QSqlDatabase DatabaseRegistry::openFileStorageConnection()
 {
     bool isCreated = dbFileStorage.isValid();
 
@@ -27,6 +76,7 @@ QSqlDatabase DatabaseRegistry::fileStorageDatabase()
     QSqlDatabase result =  QSqlDatabase::cloneDatabase(dbFileStorage, newConnectionName);
     result.open();
     result.exec("PRAGMA foreign_keys = ON;");
+    result.exec(QString("PRAGMA busy_timeout = %1;").arg(BusyTimeoutMsecs));
 
     return result;
 }
@@ -47,6 +97,36 @@ QSqlDatabase DatabaseRegistry::fileSystemEventDatabase()
     return result;
 }
 
+QSqlDatabase DatabaseRegistry::monitorStateDatabase()
+{
+    bool isCreated = dbMonitorState.isValid();
+
+    if(!isCreated)
+        createDbMonitorState();
+
+    QString newConnectionName = QUuid::createUuid().toString(QUuid::StringFormat::Id128);
+
+    QSqlDatabase result =  QSqlDatabase::cloneDatabase(dbMonitorState, newConnectionName);
+    result.open();
+
+    return result;
+}
+
+QSqlDatabase DatabaseRegistry::jobStateDatabase()
+{
+    bool isCreated = dbJobState.isValid();
+
+    if(!isCreated)
+        createDbJobState();
+
+    QString newConnectionName = QUuid::createUuid().toString(QUuid::StringFormat::Id128);
+
+    QSqlDatabase result =  QSqlDatabase::cloneDatabase(dbJobState, newConnectionName);
+    result.open();
+
+    return result;
+}
+
 void DatabaseRegistry::createDbFileStorage()
 {
     AppConfig config;
@@ -62,6 +142,7 @@ void DatabaseRegistry::createDbFileStorage()
     dbFileStorage = QSqlDatabase::addDatabase("QSQLITE", "file_storage_db");
     dbFileStorage.setDatabaseName(dbPath);
     dbFileStorage.open();
+    dbFileStorage.exec("PRAGMA journal_mode = WAL;"); // Persistent, readers aren't blocked by the writer
 
     if(!isExist)
     {
@@ -100,9 +181,16 @@ void DatabaseRegistry::createDbFileStorage()
         queryCreateTableFileVersionEntity += " version_number INTEGER NOT NULL CHECK (version_number >= 1),";
         queryCreateTableFileVersionEntity += " internal_file_name TEXT NOT NULL UNIQUE CHECK (internal_file_name != \"\"),";
         queryCreateTableFileVersionEntity += " size INTEGER NOT NULL DEFAULT 0 CHECK(size >= 0),";
-        queryCreateTableFileVersionEntity += " last_modified_timestamp TEXT NOT NULL,";
+        queryCreateTableFileVersionEntity += " last_modified_ns INTEGER NOT NULL DEFAULT 0,";
+        queryCreateTableFileVersionEntity += " inode INTEGER NOT NULL DEFAULT 0,";
         queryCreateTableFileVersionEntity += " description TEXT DEFAULT NULL CHECK (description != \"\"),";
         queryCreateTableFileVersionEntity += " hash TEXT DEFAULT NULL CHECK (hash != \"\"),";
+        queryCreateTableFileVersionEntity += " hash_algorithm TEXT NOT NULL DEFAULT 'sha3_256',";
+        queryCreateTableFileVersionEntity += " pack_file_name TEXT DEFAULT NULL CHECK (pack_file_name != \"\"),";
+        queryCreateTableFileVersionEntity += " pack_offset INTEGER DEFAULT NULL CHECK (pack_offset >= 0),";
+        queryCreateTableFileVersionEntity += " is_inline INTEGER NOT NULL DEFAULT 0 CHECK (is_inline BETWEEN 0 AND 1),";
+        queryCreateTableFileVersionEntity += " last_verified_at INTEGER DEFAULT NULL,";
+        queryCreateTableFileVersionEntity += " is_corrupt INTEGER NOT NULL DEFAULT 0 CHECK (is_corrupt BETWEEN 0 AND 1),";
         queryCreateTableFileVersionEntity += " FOREIGN KEY (symbol_file_path) REFERENCES FileEntity (symbol_file_path)";
         queryCreateTableFileVersionEntity += " ON DELETE CASCADE ON UPDATE CASCADE,";
         queryCreateTableFileVersionEntity += " PRIMARY KEY (symbol_file_path, version_number)";
@@ -111,8 +199,139 @@ void DatabaseRegistry::createDbFileStorage()
         dbFileStorage.exec(queryCreateTableFolderEntity);
         dbFileStorage.exec(queryCreateTableFileEntity);
         dbFileStorage.exec(queryCreateTableFileVersionEntity);
+        dbFileStorage.exec(FileVersionStateIndexQuery);
+        dbFileStorage.exec(FileVersionPackIndexQuery);
+        dbFileStorage.exec(FileVersionContentTableQuery);
+        dbFileStorage.exec(FileVersionVerifyIndexQuery);
         dbFileStorage.exec("INSERT INTO FolderEntity (suffix_path) VALUES('/');");
+        dbFileStorage.exec(QString("PRAGMA user_version = %1;").arg(FileStorageSchemaVersion));
+    }
+    else
+        upgradeDbFileStorage();
+}
+
+void DatabaseRegistry::upgradeDbFileStorage()
+{
+    QSqlQuery query(dbFileStorage);
+    query.exec("PRAGMA user_version;");
+
+    int currentVersion = 0;
+
+    if(query.next())
+        currentVersion = query.value(0).toInt();
+
+    if(currentVersion >= FileStorageSchemaVersion)
+        return;
+
+    // Version 1: Hash algorithm recorded per version. Rows created before are sha3_256.
+    if(currentVersion < 1)
+        dbFileStorage.exec("ALTER TABLE FileVersionEntity ADD COLUMN hash_algorithm TEXT NOT NULL DEFAULT 'sha3_256';");
+
+    // Version 2: Timestamps stored as integer nanoseconds with inode of the file.
+    if(currentVersion < 2)
+    {
+        bool isUpgraded = upgradeFileVersionTimestamps();
+
+        if(!isUpgraded) // Retried on next launch
+            return;
+    }
+
+    // Version 3: Small versions may live inside pack files.
+    if(currentVersion < 3)
+    {
+        dbFileStorage.exec("ALTER TABLE FileVersionEntity ADD COLUMN pack_file_name TEXT DEFAULT NULL CHECK (pack_file_name != \"\");");
+        dbFileStorage.exec("ALTER TABLE FileVersionEntity ADD COLUMN pack_offset INTEGER DEFAULT NULL CHECK (pack_offset >= 0);");
+        dbFileStorage.exec(FileVersionPackIndexQuery);
+    }
+
+    // Version 4: Tiny versions may be stored in the database.
+    if(currentVersion < 4)
+    {
+        dbFileStorage.exec("ALTER TABLE FileVersionEntity ADD COLUMN is_inline INTEGER NOT NULL DEFAULT 0 CHECK (is_inline BETWEEN 0 AND 1);");
+        dbFileStorage.exec(FileVersionContentTableQuery);
+    }
+
+    // Version 5: Result of the last integrity scrub of each version.
+    if(currentVersion < 5)
+    {
+        dbFileStorage.exec("ALTER TABLE FileVersionEntity ADD COLUMN last_verified_at INTEGER DEFAULT NULL;");
+        dbFileStorage.exec("ALTER TABLE FileVersionEntity ADD COLUMN is_corrupt INTEGER NOT NULL DEFAULT 0 CHECK (is_corrupt BETWEEN 0 AND 1);");
+        dbFileStorage.exec(FileVersionVerifyIndexQuery);
     }
+
+    dbFileStorage.exec(QString("PRAGMA user_version = %1;").arg(FileStorageSchemaVersion));
+}
+
+// Text column can't hold integers in sqlite, so table is rebuilt and old ISO timestamps are converted.
+bool DatabaseRegistry::upgradeFileVersionTimestamps()
+{
+    dbFileStorage.transaction();
+
+    QString queryCreateTable;
+    queryCreateTable += "CREATE TABLE FileVersionEntityNew (";
+    queryCreateTable += " symbol_file_path NOT NULL CHECK (symbol_file_path != \"\"),";
+    queryCreateTable += " version_number INTEGER NOT NULL CHECK (version_number >= 1),";
+    queryCreateTable += " internal_file_name TEXT NOT NULL UNIQUE CHECK (internal_file_name != \"\"),";
+    queryCreateTable += " size INTEGER NOT NULL DEFAULT 0 CHECK(size >= 0),";
+    queryCreateTable += " last_modified_ns INTEGER NOT NULL DEFAULT 0,";
+    queryCreateTable += " inode INTEGER NOT NULL DEFAULT 0,";
+    queryCreateTable += " description TEXT DEFAULT NULL CHECK (description != \"\"),";
+    queryCreateTable += " hash TEXT DEFAULT NULL CHECK (hash != \"\"),";
+    queryCreateTable += " hash_algorithm TEXT NOT NULL DEFAULT 'sha3_256',";
+    queryCreateTable += " FOREIGN KEY (symbol_file_path) REFERENCES FileEntity (symbol_file_path)";
+    queryCreateTable += " ON DELETE CASCADE ON UPDATE CASCADE,";
+    queryCreateTable += " PRIMARY KEY (symbol_file_path, version_number)";
+    queryCreateTable += ");" ;
+
+    dbFileStorage.exec(queryCreateTable);
+
+    QSqlQuery selectQuery(dbFileStorage);
+    selectQuery.setForwardOnly(true);
+    selectQuery.exec(" SELECT symbol_file_path, version_number, internal_file_name, size,"
+                     "        last_modified_timestamp, description, hash, hash_algorithm"
+                     " FROM FileVersionEntity;");
+
+    QSqlQuery insertQuery(dbFileStorage);
+    insertQuery.prepare(" INSERT INTO FileVersionEntityNew (symbol_file_path, version_number, internal_file_name, size,"
+                        "                                   last_modified_ns, description, hash, hash_algorithm)"
+                        " VALUES(:1, :2, :3, :4, :5, :6, :7, :8);");
+
+    bool result = true;
+
+    while(result && selectQuery.next())
+    {
+        QDateTime timestamp = QDateTime::fromString(selectQuery.value(4).toString(), Qt::DateFormat::ISODateWithMs);
+        qint64 lastModifiedNsecs = timestamp.isValid() ? timestamp.toMSecsSinceEpoch() * 1000000 : 0;
+
+        insertQuery.bindValue(":1", selectQuery.value(0));
+        insertQuery.bindValue(":2", selectQuery.value(1));
+        insertQuery.bindValue(":3", selectQuery.value(2));
+        insertQuery.bindValue(":4", selectQuery.value(3));
+        insertQuery.bindValue(":5", lastModifiedNsecs);
+        insertQuery.bindValue(":6", selectQuery.value(5));
+        insertQuery.bindValue(":7", selectQuery.value(6));
+        insertQuery.bindValue(":8", selectQuery.value(7));
+
+        result = insertQuery.exec();
+    }
+
+    selectQuery.finish();
+
+    if(result)
+        result = QSqlQuery(dbFileStorage).exec("DROP TABLE FileVersionEntity;");
+
+    if(result)
+        result = QSqlQuery(dbFileStorage).exec("ALTER TABLE FileVersionEntityNew RENAME TO FileVersionEntity;");
+
+    if(result)
+        result = QSqlQuery(dbFileStorage).exec(FileVersionStateIndexQuery);
+
+    if(result)
+        dbFileStorage.commit();
+    else
+        dbFileStorage.rollback();
+
+    return result;
 }
 
 void DatabaseRegistry::createDbFileMonitor()
@@ -131,7 +350,7 @@ void DatabaseRegistry::createDbFileMonitor()
 
     QString queryCreateTableFolder;
     queryCreateTableFolder += " CREATE TABLE Folder (";
-    queryCreateTableFolder += " efsw_id INTEGER DEFAULT NULL CHECK (efsw_id >= 1) UNIQUE,";
+    queryCreateTableFolder += " efsw_id INTEGER DEFAULT NULL CHECK (efsw_id >= 1),";
     queryCreateTableFolder += " folder_path TEXT NOT NULL UNIQUE,";
     queryCreateTableFolder += " parent_folder_path TEXT,";
     queryCreateTableFolder += " old_folder_name TEXT DEFAULT NULL CHECK (old_folder_name != \"\"),";
@@ -165,3 +384,64 @@ void DatabaseRegistry::createDbFileMonitor()
     dbFileMonitor.exec(queryCreateTableFile);
     dbFileMonitor.exec(queryCreateTableMonitoringError);
 }
+
+// Last seen state of monitored files, kept between launches so startup only reconciles differences.
+void DatabaseRegistry::createDbMonitorState()
+{
+    AppConfig config;
+
+    QString dbPath = config.getStorageFolderPath();
+
+    QDir().mkdir(dbPath);
+
+    dbPath += "ns_monitor_state.db3";
+
+    dbMonitorState = QSqlDatabase::addDatabase("QSQLITE", "monitor_state_db");
+    dbMonitorState.setDatabaseName(dbPath);
+    dbMonitorState.open();
+
+    QSqlQuery query(dbMonitorState);
+    query.exec("PRAGMA user_version;");
+
+    // States are only a cache, ones saved by older schemas are dropped and their files compared with storage again.
+    if(query.next() && query.value(0).toInt() < MonitorStateSchemaVersion)
+        dbMonitorState.exec("DROP TABLE IF EXISTS MonitorState;");
+
+    QString queryCreateTableMonitorState;
+    queryCreateTableMonitorState += " CREATE TABLE IF NOT EXISTS MonitorState (";
+    queryCreateTableMonitorState += " path TEXT NOT NULL PRIMARY KEY,";
+    queryCreateTableMonitorState += " size INTEGER NOT NULL DEFAULT -1,";
+    queryCreateTableMonitorState += " modified_timestamp INTEGER NOT NULL DEFAULT 0,";
+    queryCreateTableMonitorState += " inode INTEGER NOT NULL DEFAULT 0,";
+    queryCreateTableMonitorState += " version_number INTEGER NOT NULL DEFAULT 0,";
+    queryCreateTableMonitorState += " version_hash TEXT NOT NULL DEFAULT ''";
+    queryCreateTableMonitorState += " ) WITHOUT ROWID;" ;
+
+    dbMonitorState.exec(queryCreateTableMonitorState);
+    dbMonitorState.exec(QString("PRAGMA user_version = %1;").arg(MonitorStateSchemaVersion));
+}
+
+// Checkpoints of background jobs, so interrupted jobs resume where they stopped.
+void DatabaseRegistry::createDbJobState()
+{
+    AppConfig config;
+
+    QString dbPath = config.getStorageFolderPath();
+
+    QDir().mkdir(dbPath);
+
+    dbPath += "ns_job_state.db3";
+
+    dbJobState = QSqlDatabase::addDatabase("QSQLITE", "job_state_db");
+    dbJobState.setDatabaseName(dbPath);
+    dbJobState.open();
+
+    QString queryCreateTableJobCheckpoint;
+    queryCreateTableJobCheckpoint += " CREATE TABLE IF NOT EXISTS JobCheckpoint (";
+    queryCreateTableJobCheckpoint += " job_key TEXT NOT NULL PRIMARY KEY,";
+    queryCreateTableJobCheckpoint += " checkpoint BLOB NOT NULL,";
+    queryCreateTableJobCheckpoint += " updated_timestamp INTEGER NOT NULL DEFAULT 0";
+    queryCreateTableJobCheckpoint += " ) WITHOUT ROWID;" ;
+
+    dbJobState.exec(queryCreateTableJobCheckpoint);
+}
@@ -0,0 +1,69 @@
+#include "FileStat.h"
+
+#include <QFile>
+#include <QFileInfo>
+#include <QDateTime>
+
+#ifdef Q_OS_UNIX
+#include <fcntl.h>
+#include <sys/stat.h>
+#endif
+
+static const qint64 NsecsPerMsec = 1000000;
+static const qint64 NsecsPerSec = 1000000000;
+
+FileStat FileStat::read(const QString &pathToFile)
+{
+    FileStat result;
+
+#ifdef Q_OS_UNIX
+    struct stat buffer;
+
+    if(::stat(QFile::encodeName(pathToFile).constData(), &buffer) != 0 || !S_ISREG(buffer.st_mode))
+        return result;
+
+    result.size = buffer.st_size;
+    result.inode = buffer.st_ino;
+
+#ifdef Q_OS_DARWIN
+    result.modifiedNsecs = (qint64) buffer.st_mtimespec.tv_sec * NsecsPerSec + buffer.st_mtimespec.tv_nsec;
+#else
+    result.modifiedNsecs = (qint64) buffer.st_mtim.tv_sec * NsecsPerSec + buffer.st_mtim.tv_nsec;
+#endif
+#else
+    QFileInfo info(pathToFile);
+
+    if(!info.isFile())
+        return result;
+
+    result.size = info.size();
+    result.modifiedNsecs = info.lastModified().toMSecsSinceEpoch() * NsecsPerMsec;
+#endif
+
+    return result;
+}
+
+bool FileStat::setModifiedTime(const QString &pathToFile, qint64 modifiedNsecs)
+{
+    bool result = false;
+
+#ifdef Q_OS_UNIX
+    struct timespec times[2];
+    times[0].tv_sec = 0;
+    times[0].tv_nsec = UTIME_OMIT; // Keep access time
+    times[1].tv_sec = modifiedNsecs / NsecsPerSec;
+    times[1].tv_nsec = modifiedNsecs % NsecsPerSec;
+
+    result = (::utimensat(AT_FDCWD, QFile::encodeName(pathToFile).constData(), times, 0) == 0);
+#else
+    QFile file(pathToFile);
+
+    if(file.open(QFile::OpenModeFlag::Append))
+    {
+        QDateTime timestamp = QDateTime::fromMSecsSinceEpoch(modifiedNsecs / NsecsPerMsec);
+        result = file.setFileTime(timestamp, QFileDevice::FileTime::FileModificationTime);
+    }
+#endif
+
+    return result;
+}
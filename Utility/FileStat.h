@@ -0,0 +1,19 @@
+#ifndef FILESTAT_H
+#define FILESTAT_H
+
+#include <QString>
+
+// Size, modification time and inode of a file, read with a single stat call where possible.
+struct FileStat
+{
+    qint64 size = -1;         // -1 when path isn't a file
+    qint64 modifiedNsecs = 0; // Since epoch
+    quint64 inode = 0;        // 0 when platform doesn't provide it
+
+    static FileStat read(const QString &pathToFile);
+
+    // Sets modification time without losing sub millisecond precision where platform allows.
+    static bool setModifiedTime(const QString &pathToFile, qint64 modifiedNsecs);
+};
+
+#endif // FILESTAT_H
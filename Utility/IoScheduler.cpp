@@ -0,0 +1,149 @@
+#include "IoScheduler.h"
+
+#include "AppConfig.h"
+#include "AppConfigNotifier.h"
+
+#include <QThread>
+#include <QMutexLocker>
+
+#ifdef Q_OS_LINUX
+#include <unistd.h>
+#include <sys/syscall.h>
+
+// From linux/ioprio.h, which isn't shipped by every libc.
+static const int IoprioWhoProcess = 1; // Pid 0 means calling thread
+static const int IoprioClassShift = 13;
+static const int IoprioClassIdle = 3;
+#endif
+
+static const qint64 NsecsPerSec = 1000000000;
+
+IoScheduler *IoScheduler::instance()
+{
+    static IoScheduler scheduler;
+    return &scheduler;
+}
+
+IoScheduler::IoScheduler()
+{
+    clock.start();
+
+    AppConfig config;
+    setBandwidthLimit(Budget::Foreground, config.getIoForegroundBandwidthLimit());
+    setBandwidthLimit(Budget::Background, config.getIoBackgroundBandwidthLimit());
+
+    // Edited limits apply without restart. Setting a limit refills its bucket, so unchanged ones are left alone.
+    QObject::connect(AppConfigNotifier::instance(), &AppConfigNotifier::signalValueChanged, [this] {
+        AppConfig config;
+
+        if(getBandwidthLimit(Budget::Foreground) != config.getIoForegroundBandwidthLimit())
+            setBandwidthLimit(Budget::Foreground, config.getIoForegroundBandwidthLimit());
+
+        if(getBandwidthLimit(Budget::Background) != config.getIoBackgroundBandwidthLimit())
+            setBandwidthLimit(Budget::Background, config.getIoBackgroundBandwidthLimit());
+    });
+}
+
+qint64 IoScheduler::getBandwidthLimit(Budget budget) const
+{
+    QMutexLocker locker(&mutex);
+    return bucketList[budget].bytesPerSecond;
+}
+
+void IoScheduler::setBandwidthLimit(Budget budget, qint64 bytesPerSecond)
+{
+    QMutexLocker locker(&mutex);
+
+    Bucket &bucket = bucketList[budget];
+    bucket.bytesPerSecond = qMax(bytesPerSecond, (qint64) 0);
+    bucket.tokens = bucket.bytesPerSecond;
+    bucket.lastRefillNsecs = clock.nsecsElapsed();
+}
+
+void IoScheduler::acquire(Budget budget, qint64 byteCount)
+{
+    qint64 waitNsecs = 0;
+
+    {
+        QMutexLocker locker(&mutex);
+
+        Bucket &bucket = bucketList[budget];
+        qint64 nowNsecs = clock.nsecsElapsed();
+
+        record(bucket, byteCount, nowNsecs);
+
+        if(bucket.bytesPerSecond <= 0)
+            return;
+
+        refill(bucket, nowNsecs);
+
+        // Bucket goes into debt, so concurrent callers line up behind each other instead of bursting together.
+        bucket.tokens -= byteCount;
+
+        if(bucket.tokens < 0)
+            waitNsecs = (qint64) (-bucket.tokens * NsecsPerSec / bucket.bytesPerSecond);
+    }
+
+    if(waitNsecs > 0)
+        QThread::usleep(waitNsecs / 1000);
+}
+
+qint64 IoScheduler::getThroughput(Budget budget) const
+{
+    QMutexLocker locker(&mutex);
+
+    const Bucket &bucket = bucketList[budget];
+
+    if(clock.nsecsElapsed() - bucket.windowStartNsecs >= 2 * NsecsPerSec) // Nothing moved recently
+        return 0;
+
+    return bucket.lastThroughput;
+}
+
+void IoScheduler::refill(Bucket &bucket, qint64 nowNsecs)
+{
+    double earned = (double) (nowNsecs - bucket.lastRefillNsecs) * bucket.bytesPerSecond / NsecsPerSec;
+
+    // At most one second of burst is kept.
+    bucket.tokens = qMin(bucket.tokens + earned, (double) bucket.bytesPerSecond);
+    bucket.lastRefillNsecs = nowNsecs;
+}
+
+void IoScheduler::record(Bucket &bucket, qint64 byteCount, qint64 nowNsecs)
+{
+    qint64 windowNsecs = nowNsecs - bucket.windowStartNsecs;
+
+    if(windowNsecs >= NsecsPerSec)
+    {
+        bucket.lastThroughput = bucket.windowBytes * NsecsPerSec / windowNsecs;
+        bucket.windowStartNsecs = nowNsecs;
+        bucket.windowBytes = 0;
+    }
+
+    bucket.windowBytes += byteCount;
+}
+
+IoScheduler::BackgroundScope::BackgroundScope()
+    : previousPriority(-1)
+{
+#ifdef Q_OS_LINUX
+    if(!AppConfig().isIoBackgroundIdlePriority())
+        return;
+
+    int currentPriority = syscall(SYS_ioprio_get, IoprioWhoProcess, 0);
+
+    if(currentPriority < 0)
+        return;
+
+    if(syscall(SYS_ioprio_set, IoprioWhoProcess, 0, IoprioClassIdle << IoprioClassShift) == 0)
+        previousPriority = currentPriority;
+#endif
+}
+
+IoScheduler::BackgroundScope::~BackgroundScope()
+{
+#ifdef Q_OS_LINUX
+    if(previousPriority >= 0)
+        syscall(SYS_ioprio_set, IoprioWhoProcess, 0, previousPriority);
+#endif
+}
@@ -39,7 +39,13 @@ namespace JsonKeys
         const inline QString LastModifiedTimestamp = QStringLiteral("lastModifiedTimestamp");
         const inline QString Description = QStringLiteral("description");
         const inline QString Hash = QStringLiteral("hash");
+        const inline QString HashAlgorithm = QStringLiteral("hashAlgorithm");
         const inline QString InternalFileName = QStringLiteral("internalFileName");
+        const inline QString PackFileName = QStringLiteral("packFileName"); // Relative to storage folder, null when not packed
+        const inline QString PackOffset = QStringLiteral("packOffset");
+        const inline QString IsInline = QStringLiteral("isInline");
+        const inline QString LastVerifiedTimestamp = QStringLiteral("lastVerifiedTimestamp"); // Null when never verified
+        const inline QString IsCorrupt = QStringLiteral("isCorrupt");
     }
 }
 
@@ -0,0 +1,177 @@
+#include "Logger.h"
+
+#include <chrono>
+#include <cstdio>
+
+#include <QDateTime>
+
+bool Logger::isEnabled(Level level)
+{
+    return level >= instance()->minimumLevel.load(std::memory_order_relaxed);
+}
+
+void Logger::write(Level level, const char *category, const QString &message)
+{
+    Record record;
+    record.level = level;
+    record.category = category;
+    record.message = message;
+    record.timestamp = QDateTime::currentMSecsSinceEpoch();
+
+    Logger *logger = instance();
+    bool isPushed = logger->tryPush(std::move(record));
+
+    if(!isPushed)
+        logger->droppedRecords.fetch_add(1, std::memory_order_relaxed);
+}
+
+Logger::Level Logger::getMinimumLevel()
+{
+    return (Level) instance()->minimumLevel.load();
+}
+
+void Logger::setMinimumLevel(Level level)
+{
+    instance()->minimumLevel = level;
+}
+
+qlonglong Logger::droppedRecordCount()
+{
+    return instance()->droppedRecords;
+}
+
+void Logger::flush()
+{
+    Logger *logger = instance();
+    quint64 targetPosition = logger->enqueuePosition.load();
+
+    while(logger->isRunning && logger->writtenPosition.load() < targetPosition)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+}
+
+Logger::Logger()
+    : enqueuePosition(0),
+      dequeuePosition(0),
+      writtenPosition(0),
+      minimumLevel(Level::Debug),
+      droppedRecords(0),
+      isRunning(true)
+{
+    for(quint64 index = 0; index < RingCapacity; ++index)
+        ring[index].sequence.store(index, std::memory_order_relaxed);
+
+    writerThread = std::thread(&Logger::writerLoop, this);
+}
+
+Logger::~Logger()
+{
+    isRunning = false;
+
+    if(writerThread.joinable())
+        writerThread.join();
+}
+
+Logger *Logger::instance()
+{
+    static Logger logger;
+    return &logger;
+}
+
+// Bounded multi producer queue, every slot carries the position it is ready for.
+bool Logger::tryPush(Record &&record)
+{
+    quint64 position = enqueuePosition.load(std::memory_order_relaxed);
+    Slot *slot = nullptr;
+
+    while(true)
+    {
+        slot = &ring[position & (RingCapacity - 1)];
+        quint64 sequence = slot->sequence.load(std::memory_order_acquire);
+        qint64 difference = (qint64) sequence - (qint64) position;
+
+        if(difference == 0)
+        {
+            if(enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                break;
+        }
+        else if(difference < 0) // Ring is full
+            return false;
+        else
+            position = enqueuePosition.load(std::memory_order_relaxed);
+    }
+
+    slot->record = std::move(record);
+    slot->sequence.store(position + 1, std::memory_order_release);
+
+    return true;
+}
+
+// Only called from the writer thread.
+bool Logger::tryPop(Record &record)
+{
+    quint64 position = dequeuePosition.load(std::memory_order_relaxed);
+    Slot *slot = &ring[position & (RingCapacity - 1)];
+    quint64 sequence = slot->sequence.load(std::memory_order_acquire);
+
+    if(sequence != position + 1)
+        return false;
+
+    record = std::move(slot->record);
+    slot->record = Record();
+    slot->sequence.store(position + RingCapacity, std::memory_order_release);
+    dequeuePosition.store(position + 1, std::memory_order_relaxed);
+
+    return true;
+}
+
+void Logger::writerLoop()
+{
+    qlonglong reportedDropCount = 0;
+
+    while(true)
+    {
+        int writtenCount = writeQueuedRecords();
+
+        qlonglong dropCount = droppedRecords.load(std::memory_order_relaxed);
+        if(dropCount != reportedDropCount)
+        {
+            fprintf(stderr, "Logger: %lld records dropped because ring was full\n", dropCount - reportedDropCount);
+            fflush(stderr);
+            reportedDropCount = dropCount;
+        }
+
+        if(writtenCount == 0)
+        {
+            if(!isRunning)
+                break;
+
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        }
+    }
+}
+
+int Logger::writeQueuedRecords()
+{
+    static const char *levelNames[] = {"TRACE", "DEBUG", "INFO", "WARNING", "ERROR"};
+
+    int result = 0;
+    Record record;
+
+    while(tryPop(record))
+    {
+        QString timestamp = QDateTime::fromMSecsSinceEpoch(record.timestamp).toString(Qt::DateFormat::ISODateWithMs);
+        QString line = "%1 %2 [%3] %4\n";
+        line = line.arg(timestamp, QString(levelNames[record.level]), QString(record.category), record.message);
+
+        fputs(line.toLocal8Bit().constData(), stderr);
+        ++result;
+    }
+
+    if(result > 0)
+    {
+        fflush(stderr);
+        writtenPosition.store(dequeuePosition.load());
+    }
+
+    return result;
+}
@@ -0,0 +1,56 @@
+#include "StorageShardMigrationJob.h"
+
+#include "Logger.h"
+#include "StorageLayout.h"
+
+#include <atomic>
+
+#include <QThreadPool>
+#include <QtConcurrent>
+
+StorageShardMigrationJob::StorageShardMigrationJob(const QString &storageFolderPath)
+    : BackgroundJob(BackgroundJob::Priority::Low, BackgroundJob::PoolType::Io)
+{
+    this->storageFolderPath = storageFolderPath;
+}
+
+bool StorageShardMigrationJob::run()
+{
+    // No checkpoint needed, files which are already moved aren't listed again.
+    QStringList fileNameList = StorageLayout::listFlatFileNames(storageFolderPath);
+
+    if(fileNameList.isEmpty())
+        return true;
+
+    LOG_INFO("StorageShardMigrationJob", QString("moving %1 files into shards").arg(fileNameList.size()));
+
+    // Renames are metadata only, several of them in flight hide latency of network file systems.
+    QThreadPool movePool;
+    movePool.setMaxThreadCount(MoveThreadCount);
+
+    std::atomic<qint64> failedCount = 0;
+    qint64 totalCount = fileNameList.size();
+
+    for(qint64 offset = 0; offset < totalCount; offset += BatchSize)
+    {
+        if(isCancelRequested())
+            return false;
+
+        QStringList batch = fileNameList.mid(offset, BatchSize);
+
+        QtConcurrent::blockingMap(&movePool, batch, [this, &failedCount](const QString &fileName) {
+            if(!StorageLayout::moveToShard(storageFolderPath, fileName))
+                ++failedCount;
+        });
+
+        setProgress(offset + batch.size(), totalCount);
+    }
+
+    if(failedCount > 0)
+    {
+        LOG_WARNING("StorageShardMigrationJob", QString("%1 files couldn't be moved, will retry on next start").arg(failedCount.load()));
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,50 @@
+#include "StorageUnlinkJob.h"
+
+#include "Logger.h"
+#include "StorageLayout.h"
+
+#include <atomic>
+
+#include <QFile>
+#include <QThreadPool>
+#include <QtConcurrent>
+
+StorageUnlinkJob::StorageUnlinkJob(const QString &storageFolderPath, const QStringList &internalFileNameList)
+    : BackgroundJob(BackgroundJob::Priority::Normal, BackgroundJob::PoolType::Io)
+{
+    this->storageFolderPath = storageFolderPath;
+    this->internalFileNameList = internalFileNameList;
+}
+
+bool StorageUnlinkJob::run()
+{
+    // Unlinks are metadata only, several of them in flight hide latency of network file systems.
+    QThreadPool unlinkPool;
+    unlinkPool.setMaxThreadCount(UnlinkThreadCount);
+
+    std::atomic<qint64> failedCount = 0;
+    qint64 totalCount = internalFileNameList.size();
+
+    for(qint64 offset = 0; offset < totalCount; offset += BatchSize)
+    {
+        if(isCancelRequested())
+            return false;
+
+        QStringList batch = internalFileNameList.mid(offset, BatchSize);
+
+        QtConcurrent::blockingMap(&unlinkPool, batch, [this, &failedCount](const QString &internalFileName) {
+            if(!QFile::remove(StorageLayout::resolveFilePath(storageFolderPath, internalFileName)))
+                ++failedCount;
+        });
+
+        setProgress(offset + batch.size(), totalCount);
+    }
+
+    if(failedCount > 0)
+    {
+        LOG_WARNING("StorageUnlinkJob", QString("%1 files couldn't be deleted, left to garbage collector").arg(failedCount.load()));
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,26 @@
+#ifndef STORAGEUNLINKJOB_H
+#define STORAGEUNLINKJOB_H
+
+#include "BackgroundJob.h"
+
+#include <QStringList>
+
+// Deletes version files whose rows are already gone, e.g. after a folder is deleted.
+// Files left behind by an interrupted run are reclaimed by StorageGarbageCollectJob.
+class StorageUnlinkJob : public BackgroundJob
+{
+public:
+    static const inline int UnlinkThreadCount = 4;
+    static const inline int BatchSize = 256;
+
+    StorageUnlinkJob(const QString &storageFolderPath, const QStringList &internalFileNameList);
+
+protected:
+    bool run() override;
+
+private:
+    QString storageFolderPath;
+    QStringList internalFileNameList;
+};
+
+#endif // STORAGEUNLINKJOB_H
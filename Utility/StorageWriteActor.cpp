@@ -0,0 +1,160 @@
+#include "StorageWriteActor.h"
+
+#include "Logger.h"
+#include "DatabaseRegistry.h"
+
+#include <QSqlQuery>
+#include <QSqlError>
+
+StorageWriteActor *StorageWriteActor::instance()
+{
+    static StorageWriteActor actor;
+    return &actor;
+}
+
+StorageWriteActor::StorageWriteActor()
+{
+    queueHead = nullptr;
+    activeProducerCount = 0;
+    isStopRequested = false;
+    isClosed = false;
+
+    thread = QThread::create([this] { runLoop(); });
+    thread->setObjectName("StorageWriteActor");
+    thread->start();
+}
+
+StorageWriteActor::~StorageWriteActor()
+{
+    stop();
+    delete thread;
+}
+
+bool StorageWriteActor::execute(const Command &command)
+{
+    // Nested command joins the savepoint of the one running it.
+    if(QThread::currentThread() == thread)
+        return command(database);
+
+    // stop() waits for producers which didn't see the request, so no command is pushed after the last drain.
+    activeProducerCount++;
+
+    if(isStopRequested)
+    {
+        activeProducerCount--;
+        return false;
+    }
+
+    PendingCommand pending;
+    pending.command = command;
+    pending.next = queueHead.load(std::memory_order_relaxed);
+
+    // Failed exchange reloads the current head into pending.next, so the push is retried on top of it.
+    while(!queueHead.compare_exchange_weak(pending.next, &pending, std::memory_order_release, std::memory_order_relaxed))
+        continue;
+
+    commandQueued.release();
+    activeProducerCount--;
+
+    pending.done.acquire();
+    return pending.result;
+}
+
+void StorageWriteActor::stop()
+{
+    if(isStopRequested.exchange(true)) // Stopped or being stopped already
+    {
+        thread->wait();
+        return;
+    }
+
+    while(activeProducerCount > 0)
+        QThread::yieldCurrentThread();
+
+    isClosed = true;
+    commandQueued.release();
+
+    thread->wait();
+}
+
+void StorageWriteActor::runLoop()
+{
+    database = DatabaseRegistry::fileStorageWriteDatabase();
+
+    while(true)
+    {
+        commandQueued.acquire();
+
+        // Commands are pushed before their release, so every command of a consumed release is taken below.
+        commandQueued.tryAcquire(commandQueued.available());
+
+        // Commands queued while the previous batch was committing go in together.
+        QList<PendingCommand *> queued = takeQueued();
+
+        for(qsizetype index = 0; index < queued.size(); index += MaxBatchSize)
+        {
+            QList<PendingCommand *> batch = queued.mid(index, MaxBatchSize);
+            commitBatch(batch);
+
+            for(PendingCommand *pending : batch) // Pending command can't be touched once released
+                pending->done.release();
+        }
+
+        if(isClosed && queueHead.load(std::memory_order_acquire) == nullptr) // Everything is committed
+            break;
+    }
+
+    database.close();
+}
+
+QList<StorageWriteActor::PendingCommand *> StorageWriteActor::takeQueued()
+{
+    QList<PendingCommand *> result;
+
+    PendingCommand *current = queueHead.exchange(nullptr, std::memory_order_acquire);
+
+    for(; current != nullptr; current = current->next)
+        result.prepend(current); // Stack is newest first
+
+    return result;
+}
+
+void StorageWriteActor::commitBatch(const QList<PendingCommand *> &batch)
+{
+    bool isCommitted = database.transaction();
+
+    if(isCommitted)
+    {
+        for(PendingCommand *pending : batch)
+            pending->result = runInSavepoint(pending->command);
+
+        isCommitted = database.commit();
+
+        if(!isCommitted)
+            database.rollback();
+    }
+
+    if(!isCommitted)
+    {
+        LOG_WARNING("StorageWriteActor", QString("Batch of %1 commands couldn't be committed: %2").arg(batch.size())
+                                                                                                  .arg(database.lastError().text()));
+
+        for(PendingCommand *pending : batch)
+            pending->result = false;
+    }
+}
+
+bool StorageWriteActor::runInSavepoint(const Command &command)
+{
+    QSqlQuery query(database);
+    query.exec("SAVEPOINT command;");
+
+    bool result = command(database);
+
+    if(!result)
+        query.exec("ROLLBACK TO command;");
+
+    query.exec("RELEASE command;");
+
+    return result;
+}
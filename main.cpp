@@ -5,6 +5,14 @@
 
 #include "Gui/MainWindow.h"
 #include "Utility/AppConfig.h"
+#include "Utility/AppConfigNotifier.h"
+#include "Utility/DatabaseRegistry.h"
+#include "Utility/JobScheduler.h"
+#include "Utility/StorageWriteActor.h"
+#include "Utility/StorageShardMigrationJob.h"
+#include "Backend/FileStorageSubSystem/PackRepackJob.h"
+#include "Backend/FileStorageSubSystem/StorageGarbageCollectJob.h"
+#include "Backend/FileStorageSubSystem/IntegrityScrubJob.h"
 
 bool askAcceptenceForDisclaimer();
 void showStorageLocationMessage();
@@ -13,6 +21,20 @@ int main(int argc, char *argv[])
 {
     QApplication app(argc, argv);
 
+    QString sqliteVersion;
+
+    if(!DatabaseRegistry::isSqliteVersionSupported(sqliteVersion))
+    {
+        QString title = QObject::tr("Unsupported SQLite version !");
+        QString message = QObject::tr("NeSync requires SQLite <b>%1</b> or newer, but the Qt SQLite driver uses <b>%2</b>.")
+                              .arg(DatabaseRegistry::MinSqliteVersion, sqliteVersion.isEmpty() ? QObject::tr("none") : sqliteVersion);
+
+        QMessageBox::critical(nullptr, title, message);
+        return 1;
+    }
+
+    AppConfigNotifier::instance()->startWatching();
+
     AppConfig config;
 
     if(!config.isDisclaimerAccepted())
@@ -27,13 +49,45 @@ int main(int argc, char *argv[])
 
     if(!config.isStorageFolderPathValid())
         showStorageLocationMessage();
+    else
+    {
+        QString storageFolderPath = config.getStorageFolderPath();
+        auto migrationJobId = QSharedPointer<qint64>::create(-1);
+
+        // Collector skips stores which still have flat files, so it is submitted once migration finishes.
+        // Files left behind by interrupted writes and deletes are removed. Connected first, migration may finish quickly.
+        QObject::connect(JobScheduler::instance(), &JobScheduler::signalJobFinished,
+                         JobScheduler::instance(), [migrationJobId, storageFolderPath](qint64 jobId, BackgroundJob::State state) {
+            if(jobId != *migrationJobId || state == BackgroundJob::State::Cancelled) // Cancelled at exit
+                return;
+
+            *migrationJobId = -1;
+            JobScheduler::instance()->submit(QSharedPointer<StorageGarbageCollectJob>::create(storageFolderPath));
+        });
+
+        // Stores created with the flat layout are sharded in the background, files stay usable meanwhile.
+        auto migrationJob = QSharedPointer<StorageShardMigrationJob>::create(storageFolderPath);
+        *migrationJobId = JobScheduler::instance()->submit(migrationJob);
+
+        PackRepackJob::submitIfIdle();
+
+        // Resumes the pass interrupted by the last exit, or starts one when versions are due for verification.
+        IntegrityScrubJob::submitIfDue();
+    }
 
     QApplication::setQuitOnLastWindowClosed(false);
 
     MainWindow w;
     w.show();
 
-    return app.exec();
+    int result = app.exec();
+
+    // Interrupted jobs resume from their checkpoints on next launch.
+    JobScheduler::instance()->cancelAll();
+    JobScheduler::instance()->waitForDone();
+    StorageWriteActor::instance()->stop();
+
+    return result;
 }
 
 bool askAcceptenceForDisclaimer()